@@ -0,0 +1,102 @@
+/**
+ * Animated Solve Module Header File
+ *
+ * This header declares the "animate solve" mode. Instead of copying the stored
+ * solution, the puzzle is solved by the real search engine a few nodes per
+ * frame, so the player watches digits being placed and backtracked while the
+ * main loop keeps handling input and the timer.
+ *
+ * Key Responsibilities:
+ * - Start a resumable search from the puzzle's givens
+ * - Advance the search by a bounded number of nodes per frame
+ * - Mirror the search state into the visible grid
+ * - Track nodes per second for the live display
+ * - Cancel and restore the player's grid on request
+ */
+
+#ifndef ANIMATE_H
+#define ANIMATE_H
+
+#include "../include/sudoku.h"
+#include "../include/search.h"
+
+// ============================================================================
+//                            ANIMATION CONSTANTS
+// ============================================================================
+
+#define ANIMATION_FRAME_MS 30           // getch() timeout while animating
+#define ANIMATION_MIN_SPEED 1           // Nodes per frame, slowest setting
+#define ANIMATION_MAX_SPEED 65536       // Nodes per frame, fastest setting
+
+// ============================================================================
+//                             ANIMATION STATE
+// ============================================================================
+
+typedef struct
+{
+    int active;                             // Flag: 1 = animation running
+    search_t search;                        // Resumable search over the givens
+    int saved_grid[GRID_SIZE][GRID_SIZE];   // Player grid restored on cancel
+    uint64_t nodes_per_frame;               // Search budget per frame
+    double start_seconds;                   // Monotonic time the animation started
+    double rate;                            // Recent nodes per second
+    double rate_seconds;                    // Time of the last rate sample
+    uint64_t rate_nodes;                    // Node count at the last rate sample
+} animation_t;
+
+// ============================================================================
+//                            ANIMATION FUNCTIONS
+// ============================================================================
+
+/**
+ * Begin an animated solve of the current puzzle
+ * The search starts from the givens; the player's entries are saved so a
+ * cancelled animation can restore them
+ *
+ * @param anim Animation state to initialize
+ * @param game Game whose puzzle is solved
+ */
+void start_animation(animation_t *anim, game_state_t *game);
+
+/**
+ * Advance the animation by one frame's node budget
+ * Copies the search state into the game grid; when a solution is found the
+ * game is marked completed and the animation stops
+ *
+ * @param anim Running animation
+ * @param game Game being animated
+ * @return 1 while the animation is still running, 0 once finished
+ */
+int step_animation(animation_t *anim, game_state_t *game);
+
+/**
+ * Stop the animation and restore the player's grid
+ *
+ * @param anim Running animation
+ * @param game Game being animated
+ */
+void cancel_animation(animation_t *anim, game_state_t *game);
+
+/**
+ * Double or halve the number of nodes searched per frame
+ *
+ * @param anim Animation state
+ * @param faster 1 to double the speed, 0 to halve it
+ */
+void change_animation_speed(animation_t *anim, int faster);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Main Loop Integration:
+ * - While anim.active, use timeout(ANIMATION_FRAME_MS) and call
+ *   step_animation() whenever getch() returns ERR
+ * - Each frame does at most nodes_per_frame search nodes, so input and the
+ *   timer are never blocked for longer than one small slice
+ *
+ * Keys (handled in main loop):
+ * - a: start / cancel animation
+ * - + / -: double / halve nodes per frame
+ */
@@ -0,0 +1,131 @@
+/**
+ * Background Board Check Module Header File
+ *
+ * This header declares the worker thread shared by the checks that rerun
+ * after every change to the board: the move checker (feedback.h) and the
+ * editor's live solution count (editor.h). The UI posts a snapshot of the
+ * board and returns at once; the worker runs a callback on the newest
+ * snapshot only, and a newer post cancels the callback still running on an
+ * older one. The answer of the newest board is read back without waiting.
+ *
+ * Key Responsibilities:
+ * - Own a worker thread, its search state and its private board copy
+ * - Run the caller's check on the newest posted board only
+ * - Cancel a check in progress when a newer board is posted
+ * - Publish the answer of a finished check if its board is still current
+ */
+
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+#include "../include/search.h"
+#include <pthread.h>
+
+// ============================================================================
+//                            BACKGROUND STRUCTURES
+// ============================================================================
+
+typedef struct
+{
+    int grid[GRID_SIZE][GRID_SIZE];         // Board (givens and entries)
+    int solution[GRID_SIZE][GRID_SIZE];     // Stored solution, if any
+    int has_solution;                       // Flag: 1 = solution[][] is valid
+    topology_t topology;                    // Rules the board was posted under
+} background_board_t;
+
+/**
+ * Check run on the worker thread for each board it takes
+ * The active topology of the thread is already the board's own
+ *
+ * @param search Search state owned by the worker
+ * @param board Private copy of the posted board (may be modified)
+ * @param cancel Flag set when a newer board is posted
+ * @param answer Receives the answer (answer_size bytes, zeroed beforehand)
+ * @return 1 if answered, 0 if cancelled
+ */
+typedef int (*background_check_t)(search_t *search, background_board_t *board,
+                                  const volatile int *cancel, void *answer);
+
+typedef struct
+{
+    pthread_t thread;           // Worker thread
+    pthread_mutex_t lock;       // Guards every field below
+    pthread_cond_t wake;        // Signalled when a board is posted or on stop
+    int started;                // Flag: 1 = worker running
+    int stop;                   // Flag: 1 = worker should exit
+
+    background_check_t check;   // Caller's check
+    size_t answer_size;         // Bytes of one answer
+
+    // Newest posted board
+    unsigned long posted;                   // Sequence number of the newest board
+    background_board_t board;               // The board
+    volatile int cancel;                    // Set when a newer board replaces the one in work
+
+    // Newest answer
+    unsigned long answered;                 // Sequence number the answer belongs to
+    void *answer;                           // Answer for that board
+
+    // Owned by the worker thread
+    search_t *search;                       // Search state passed to the check
+    background_board_t *work_board;         // Private copy of the board in work
+    void *work_answer;                      // Answer being computed
+} background_t;
+
+// ============================================================================
+//                            BACKGROUND FUNCTIONS
+// ============================================================================
+
+/**
+ * Start the worker thread
+ *
+ * @param background Worker to initialize
+ * @param check Check to run on each posted board
+ * @param answer_size Bytes of the check's answer
+ * @return 1 on success, 0 if memory or the thread could not be obtained
+ */
+int background_start(background_t *background, background_check_t check, size_t answer_size);
+
+/**
+ * Cancel any check in progress and join the worker thread
+ *
+ * @param background Started worker (stopping a stopped worker is harmless)
+ */
+void background_stop(background_t *background);
+
+/**
+ * Post a board under the active rules for checking and return at once
+ * A check still running on an older board is cancelled
+ *
+ * @param background Started worker
+ * @param grid Board, copied
+ * @param solution Stored solution, copied (NULL = none)
+ */
+void background_post(background_t *background, int grid[9][9], int solution[9][9]);
+
+/**
+ * Read the answer for the newest posted board without waiting
+ *
+ * @param background Started worker
+ * @param answer Receives the answer if it is ready (answer_size bytes)
+ * @return 1 if the newest board has been checked, 0 otherwise
+ */
+int background_answer(background_t *background, void *answer);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Checks:
+ * - A check polls the cancel flag (search_run() takes it directly) and
+ *   returns 0 once it is set; its partial answer is then dropped
+ * - The worker selects board->topology with use_thread_topology() before
+ *   each check, so the UI may switch its jigsaw or killer tables meanwhile
+ *
+ * Memory:
+ * - background_t embeds one board with its rule tables (about 5 KB); the
+ *   worker's search state and board copy are allocated by background_start()
+ */
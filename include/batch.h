@@ -0,0 +1,205 @@
+/**
+ * Batch Tools Module Header File
+ *
+ * This header declares the command-line entry point used when the program is
+ * started with arguments. Batch tools run without ncurses and work on puzzle
+ * files (one 81-character puzzle per line, optionally followed by an
+ * 81-digit jigsaw region map or a killer cage list) or standard input.
+ *
+ * Key Responsibilities:
+ * - Parse command-line options and dispatch to the requested tool
+ * - Solve every puzzle in a file on all cores and print the solutions in order
+ * - Validate every puzzle in a file and summarize the results
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../include/sudoku.h"
+#include "../include/writer.h"
+#include "../include/generator.h"
+#include "../include/format.h"
+
+// ============================================================================
+//                              BATCH CONSTANTS
+// ============================================================================
+
+#define BATCH_CHUNK 4096                // Puzzles handed to a worker at a time
+#define BATCH_MAX_THREADS 32            // Keeps 2 buffers per thread within WRITER_WINDOW
+
+// ============================================================================
+//                              BATCH OPTIONS
+// ============================================================================
+
+typedef struct
+{
+    int threads;                // Worker threads (0 = one per online CPU)
+    writer_format_t format;     // Output record format
+    long limit;                 // Solutions per puzzle for --enumerate (0 = all)
+    difficulty_t difficulty;    // Difficulty for --generate
+    int clues;                  // Clue target for --generate (0 = from difficulty)
+    int minimal;                // Flag: --generate minimal puzzles
+    symmetry_t symmetry;        // Clue symmetry for --generate
+    int attempts;               // Removal passes per puzzle (0 = generator default)
+    double budget;              // Seconds per --clues puzzle (0 = restart default)
+    generator_method_t method;  // Clue selection for --generate
+    puzzle_format_t convert;    // Output format for --convert
+    const char *checkpoint;     // Checkpoint file for --generate and --solve (NULL = none)
+    int resume;                 // Flag: continue from the checkpoint
+} batch_options_t;
+
+// ============================================================================
+//                            COMMAND-LINE ENTRY
+// ============================================================================
+
+/**
+ * Run the batch tool selected by the command-line arguments
+ *
+ * @param argc Argument count from main()
+ * @param argv Argument vector from main()
+ * @return Process exit status (0 on success)
+ */
+int batch_main(int argc, char *argv[]);
+
+// ============================================================================
+//                               BATCH TOOLS
+// ============================================================================
+
+/**
+ * Solve every puzzle in a file and write one solution record per puzzle
+ * Puzzles are solved in parallel chunks; output keeps the input order
+ * Unsolvable puzzles produce an all-zero record so records stay aligned
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @param options Thread count and output format
+ * @return Process exit status (0 on success)
+ */
+int batch_solve(const char *path, const batch_options_t *options);
+
+/**
+ * Resolve the worker thread count for a batch run
+ *
+ * @param requested Requested thread count (0 = one per online CPU)
+ * @return Thread count between 1 and BATCH_MAX_THREADS
+ */
+int batch_thread_count(int requested);
+
+/**
+ * Validate every puzzle in a file
+ * Classifies puzzles as unique, multiple-solution, unsolvable or invalid
+ * (conflicting givens) and prints a summary
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @return Process exit status (0 if every puzzle is unique)
+ */
+int batch_validate(const char *path);
+
+/**
+ * Print every solution of every puzzle in a file
+ * Uses constant memory regardless of the number of solutions; a per-puzzle
+ * count goes to stderr and Ctrl-C stops the enumeration cleanly
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @param options Solution limit and output format
+ * @return Process exit status (0 on success, 130 if interrupted)
+ */
+int batch_enumerate(const char *path, const batch_options_t *options);
+
+/**
+ * Count the solutions of every puzzle in a file, splitting each search
+ * across the worker threads (count_solutions_parallel())
+ * One "line N: X solution(s)" line per puzzle goes to stdout and a summary
+ * of time and work stealing to stderr; Ctrl-C stops the count cleanly
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @param options Solution limit and thread count
+ * @return Process exit status (0 on success, 130 if interrupted)
+ */
+int batch_count(const char *path, const batch_options_t *options);
+
+/**
+ * Generate puzzles and print one per line
+ * Prints clue statistics to stderr; in minimal mode without symmetry every
+ * puzzle is also checked with is_minimal_puzzle()
+ * With a clue target, every puzzle is raced on all threads with
+ * generate_target_puzzle() and the success rate and time to target are
+ * reported as well
+ *
+ * @param count Number of puzzles to generate
+ * @param options Difficulty, clue target, minimal flag and symmetry
+ * @return Process exit status (0 on success)
+ */
+int batch_generate(long count, const batch_options_t *options);
+
+/**
+ * Benchmark the puzzle codec on every puzzle in a file
+ * Prints average encoded size and encode/decode rates, and verifies that
+ * every puzzle decodes back to itself
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @return Process exit status (0 if every round trip matched)
+ */
+int batch_bench_codec(const char *path);
+
+/**
+ * Print the daily puzzle of a date at the chosen difficulty
+ * Built from the date's seed without the cache: the reference output that
+ * every machine reproduces
+ *
+ * @param date_text "YYYY-MM-DD" or "today"
+ * @param options Difficulty
+ * @return Process exit status (0 on success, 2 for an invalid date)
+ */
+int batch_daily(const char *date_text, const batch_options_t *options);
+
+/**
+ * Convert every puzzle in a file to another format
+ * Input may mix 81-character lines, SDK grids, .ss grids and JSON objects;
+ * malformed puzzles are skipped and counted on stderr
+ *
+ * @param path Puzzle file, or "-" for standard input
+ * @param options Output format
+ * @return Process exit status (0 on success)
+ */
+int batch_convert(const char *path, const batch_options_t *options);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Command Line:
+ *   sudoku                    - start the interactive game
+ *   sudoku --solve FILE       - print the solution of every puzzle
+ *   sudoku --validate FILE    - summarize uniqueness of every puzzle
+ *   sudoku --enumerate FILE   - print every solution of each puzzle
+ *   sudoku --count FILE       - count the solutions of each puzzle on all threads
+ *   sudoku --bench-codec FILE - measure puzzle encode/decode rate
+ *   sudoku --convert FILE     - rewrite every puzzle in another format
+ *   sudoku --daily DATE       - print the daily puzzle of DATE
+ *   sudoku --analyze FILE     - audit clues, uniqueness, ratings and repeats
+ *   sudoku --daemon           - fill the shared puzzle pool until stopped
+ *   sudoku --play FILE        - play the first puzzle of FILE (handled by main)
+ *   sudoku --generate N       - print N new puzzles
+ *
+ * Options:
+ *   --threads N               - worker threads for --solve, --count and --analyze (default: all CPUs)
+ *   --binary                  - write 41-byte packed records instead of text
+ *   --limit N                 - stop --enumerate or --count after N solutions per puzzle
+ *   --difficulty LEVEL        - easy, medium, hard or expert for --generate
+ *   --clues N                 - clue target for --generate, raced on all threads
+ *   --budget SECONDS          - time allowed per --clues puzzle
+ *   --attempts N              - removal passes per puzzle for --generate
+ *   --hitting-set             - choose clues as a hitting set of unavoidable sets
+ *   --minimal                 - generate minimal puzzles (every clue necessary)
+ *   --symmetry TYPE           - none, rotational, diagonal, mirror or dihedral
+ *   --format NAME             - line, sdk, ss or json output for --convert
+ *   --checkpoint FILE         - save progress of --generate or --solve every few seconds
+ *   --resume                  - continue the job saved in the checkpoint
+ *
+ * FILE may be "-" to read from standard input.
+ *
+ * Threading:
+ * - Workers pull BATCH_CHUNK puzzles at a time from a shared reader and format
+ *   results into their own double buffers; the writer restores input order
+ */
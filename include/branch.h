@@ -0,0 +1,135 @@
+/**
+ * Branch Module Header File
+ *
+ * This header declares what-if branching on the game state. Opening a branch
+ * saves the few scalar fields of the game (cursor, moves, timer, flags) in a
+ * branch point and from then on journals the old number and pencil marks of
+ * every cell before it changes. Discarding a branch replays the journal
+ * backwards to the branch point; keeping a branch just drops the point. No
+ * grid is ever copied, so opening a branch costs the same whatever the size
+ * of the game state, and players or bots can branch thousands of times per
+ * second.
+ *
+ * Key Responsibilities:
+ * - Open nested branches in constant time
+ * - Journal cell changes made while a branch is open
+ * - Discard a branch, restoring cells, marks, moves, cursor and timer exactly
+ * - Keep (merge) a branch into its parent or into the main line
+ */
+
+#ifndef BRANCH_H
+#define BRANCH_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                             BRANCH CONSTANTS
+// ============================================================================
+
+#define BRANCH_JOURNAL_INITIAL 64       // Journal entries allocated on first use
+#define BRANCH_POINTS_INITIAL 8         // Branch points allocated on first use
+
+// ============================================================================
+//                            JOURNAL FUNCTIONS
+// ============================================================================
+
+/**
+ * Start with no branches and an empty journal (nothing allocated)
+ *
+ * @param game Game state whose journal is initialized
+ */
+void init_branches(game_state_t *game);
+
+/**
+ * Close every branch, keeping the current state
+ * Called when the puzzle is replaced; the allocations are kept for reuse
+ *
+ * @param game Game state
+ */
+void clear_branches(game_state_t *game);
+
+/**
+ * Release the journal storage
+ *
+ * @param game Game state
+ */
+void free_branches(game_state_t *game);
+
+/**
+ * Append the current number and marks of a cell to the journal
+ * Use record_cell(), which skips the call when no branch is open
+ *
+ * @param game Game state with at least one open branch
+ * @param row Cell row (0-8)
+ * @param col Cell column (0-8)
+ */
+void journal_cell(game_state_t *game, int row, int col);
+
+/**
+ * Save a cell before changing it, if a branch is open
+ * Call before every write to grid[][] or marks[][] outside new puzzles
+ *
+ * @param game Game state
+ * @param row Cell row (0-8)
+ * @param col Cell column (0-8)
+ */
+static inline void record_cell(game_state_t *game, int row, int col)
+{
+    if (game->journal.depth > 0)
+        journal_cell(game, row, col);
+}
+
+// ============================================================================
+//                             BRANCH FUNCTIONS
+// ============================================================================
+
+/**
+ * Open a branch on top of the current state (branches nest)
+ *
+ * @param game Game state
+ * @return New branch depth (1 = outermost), or 0 if out of memory
+ */
+int open_branch(game_state_t *game);
+
+/**
+ * Discard the innermost branch, restoring the state it was opened on
+ * Cells, pencil marks, moves, cursor, mark mode, completion and the timer
+ * reading all return to their values at the branch point; time spent in
+ * the branch is not counted
+ *
+ * @param game Game state
+ * @return 1 if a branch was discarded, 0 if none was open
+ */
+int discard_branch(game_state_t *game);
+
+/**
+ * Keep the innermost branch: its changes become part of the parent branch,
+ * or of the main line when it was the outermost one
+ *
+ * @param game Game state
+ * @return 1 if a branch was kept, 0 if none was open
+ */
+int merge_branch(game_state_t *game);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Recording Changes:
+ *   record_cell(game, row, col);     // Before the write
+ *   game->grid[row][col] = num;
+ *
+ * Cost:
+ * - open_branch() and merge_branch() are O(1) (amortized when the point
+ *   stack grows); discard_branch() is O(changes made in the branch)
+ * - With no branch open, record_cell() is a single test
+ *
+ * Example:
+ *   open_branch(game);               // Try a guess
+ *   enter_number(game, 5);
+ *   if (!is_valid_move(...))
+ *       discard_branch(game);        // Back to the exact prior state
+ *   else
+ *       merge_branch(game);          // Keep it
+ */
@@ -0,0 +1,167 @@
+/**
+ * Batch Checkpoint Module Header File
+ *
+ * This header declares checkpoints for long batch runs ("--generate" bank
+ * builds and "--solve" over large corpora). A checkpoint records how far a
+ * job got: the input offset, the output offset, the generator's random state
+ * and how many entries of the duplicate filter are durable. "--resume" reads
+ * it back, cuts the output to the checkpointed length and carries on, so an
+ * interrupted job neither redoes work nor writes a puzzle twice.
+ *
+ * A checkpoint is a few hundred bytes written to a private temporary file and
+ * renamed over the old one, so it is atomic. The duplicate filter is the only
+ * part that grows; its hashes go to an append-only journal next to the
+ * checkpoint, and each checkpoint appends just the hashes added since the last
+ * one, so taking a checkpoint every few seconds costs two small fdatasync()
+ * calls no matter how large the job has become.
+ *
+ * Key Responsibilities:
+ * - Save and load checkpoints atomically, rejecting damaged ones
+ * - Position the output file for a fresh or resumed run
+ * - Keep the duplicate filter in memory and journal it incrementally
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                           CHECKPOINT CONSTANTS
+// ============================================================================
+
+#define CHECKPOINT_INTERVAL 5.0         // Seconds between checkpoints
+#define CHECKPOINT_VERSION 1            // Bump when the file layout changes
+#define CHECKPOINT_JOB_MAX 256          // Longest job description
+#define CHECKPOINT_PATH_MAX 4096        // Longest checkpoint path
+#define DEDUP_INITIAL_SLOTS 4096        // First table size of the duplicate filter
+
+// ============================================================================
+//                          CHECKPOINT STRUCTURES
+// ============================================================================
+
+typedef struct
+{
+    char job[CHECKPOINT_JOB_MAX];   // Mode and settings; a resume must match them
+    long done;                      // Puzzles finished and written
+    uint64_t input_offset;          // Input consumed (reader_offset())
+    long input_line;                // Input lines consumed
+    long skipped;                   // Malformed input lines so far
+    uint64_t output_offset;         // Output bytes known to be on disk
+    uint64_t rng_state;             // Generator random state
+    long dedup_count;               // Hashes in the duplicate journal
+    long duplicates;                // Generated puzzles dropped as repeats
+    long total_clues;               // Clues summed over finished puzzles
+    long total_attempts;            // Removal passes summed over finished puzzles
+    long reached;                   // Puzzles that reached their clue target
+    long minimal;                   // Puzzles verified minimal
+    int fewest;                     // Fewest clues so far
+    int most;                       // Most clues so far
+} checkpoint_t;
+
+typedef struct
+{
+    uint64_t *slots;            // Open-addressing table of hashes (0 = free)
+    size_t capacity;            // Table size, a power of two
+    size_t count;               // Hashes in the table
+    uint64_t *pending;          // Hashes added since the last dedup_flush()
+    size_t pending_count;       // Entries used in pending
+    size_t pending_capacity;    // Entries allocated in pending
+    int journal;                // Journal file descriptor (-1 = none)
+} dedup_t;
+
+// ============================================================================
+//                           CHECKPOINT FUNCTIONS
+// ============================================================================
+
+/**
+ * Write a checkpoint atomically (temporary file, fdatasync, rename)
+ *
+ * @param path Checkpoint file
+ * @param checkpoint State to save
+ * @return 1 on success, 0 on I/O error
+ */
+int checkpoint_save(const char *path, const checkpoint_t *checkpoint);
+
+/**
+ * Read a checkpoint and verify its hash and job
+ *
+ * @param path Checkpoint file
+ * @param job Job description the checkpoint must have been saved for
+ * @param checkpoint Receives the state
+ * @return 1 if a matching checkpoint was read, 0 otherwise (reported on stderr)
+ */
+int checkpoint_load(const char *path, const char *job, checkpoint_t *checkpoint);
+
+/**
+ * Delete a checkpoint and its duplicate journal after a finished job
+ *
+ * @param path Checkpoint file
+ */
+void checkpoint_remove(const char *path);
+
+/**
+ * Prepare the output file of a checkpointed job
+ * A fresh run notes where its output starts; a resumed run cuts the file
+ * back to the checkpointed length, dropping records written after it
+ *
+ * @param fd Output descriptor (must be a regular file)
+ * @param resume Checkpoint being resumed (NULL = fresh run)
+ * @param base Receives the file offset of the job's next output byte
+ * @return 1 on success, 0 if the output cannot be checkpointed (reported on stderr)
+ */
+int checkpoint_output(int fd, const checkpoint_t *resume, uint64_t *base);
+
+/**
+ * Open the duplicate filter of a checkpoint
+ * Loads the first keep hashes of the journal and drops anything after them
+ *
+ * @param dedup Filter to initialize
+ * @param path Checkpoint file (the journal is "<path>.dedup")
+ * @param keep Hashes to keep (0 = start an empty journal)
+ * @return 1 on success, 0 on I/O error or a short journal (reported on stderr)
+ */
+int dedup_open(dedup_t *dedup, const char *path, long keep);
+
+/**
+ * Add a hash to the duplicate filter
+ *
+ * @param dedup Open filter
+ * @param hash 64-bit hash of a puzzle
+ * @return 1 if the hash is new, 0 if it was seen before
+ */
+int dedup_insert(dedup_t *dedup, uint64_t hash);
+
+/**
+ * Append the hashes added since the last flush to the journal and sync it
+ *
+ * @param dedup Open filter
+ * @return 1 on success, 0 on I/O error
+ */
+int dedup_flush(dedup_t *dedup);
+
+/**
+ * Free the filter and close its journal
+ *
+ * @param dedup Filter to close
+ */
+void dedup_close(dedup_t *dedup);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Order of a Checkpoint:
+ * - Write all output up to the checkpoint, fdatasync() the output, then
+ *   dedup_flush(), then checkpoint_save(); a crash at any point leaves the
+ *   previous checkpoint valid, and anything past it is cut on resume
+ *
+ * Output:
+ * - Checkpointed output must be a regular file; resume with ">>" (or
+ *   "1<>"), since ">" empties the file the checkpoint refers to
+ *
+ * File Format:
+ * - Text lines "key value"; the last line is "hash <hex>", the 64-bit
+ *   FNV-1a of everything before it and CHECKPOINT_VERSION
+ */
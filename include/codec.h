@@ -0,0 +1,104 @@
+/**
+ * Puzzle Codec Module Header File
+ *
+ * This header declares the compact puzzle encoding shared by every place that
+ * stores or transports puzzles. A puzzle is stored as an 81-bit given mask
+ * followed by the clue values packed in base 9, so a typical 25-30 clue
+ * puzzle takes 21-23 bytes instead of 81.
+ *
+ * Key Responsibilities:
+ * - Encode and decode puzzles in the mask + base-9 clue format
+ * - Encode and decode solution-relative puzzles (seed + mask only)
+ * - Report encoded sizes so callers can size buffers
+ */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                              CODEC CONSTANTS
+// ============================================================================
+
+#define CODEC_MASK_BYTES 11                         // 81-bit given mask
+#define CODEC_MAX_BYTES (CODEC_MASK_BYTES + 34)     // All 81 cells given
+#define CODEC_SEEDED_BYTES (8 + CODEC_MASK_BYTES)   // 64-bit seed + mask
+
+// ============================================================================
+//                          CLUE-VALUE ENCODING
+// ============================================================================
+
+/**
+ * Encode a puzzle as given mask + base-9 packed clue values
+ *
+ * @param grid 9x9 puzzle (0 = empty, 1-9 = clue)
+ * @param out Destination buffer of at least CODEC_MAX_BYTES bytes
+ * @return Number of bytes written
+ */
+size_t encode_puzzle(int grid[9][9], uint8_t *out);
+
+/**
+ * Decode a puzzle produced by encode_puzzle()
+ *
+ * @param in Encoded bytes
+ * @param length Number of bytes available in the input
+ * @param grid 9x9 array that receives the puzzle
+ * @return Number of bytes consumed, or 0 if the input is truncated or corrupt
+ */
+size_t decode_puzzle(const uint8_t *in, size_t length, int grid[9][9]);
+
+/**
+ * Number of bytes encode_puzzle() needs for a given clue count
+ *
+ * @param clues Number of given cells (0-81)
+ * @return Encoded size in bytes
+ */
+size_t encoded_puzzle_size(int clues);
+
+// ============================================================================
+//                        SOLUTION-RELATIVE ENCODING
+// ============================================================================
+
+/**
+ * Encode a puzzle whose solution came from generate_solution_from_seed()
+ * Only the seed and the given mask are stored; clue values are regenerated
+ *
+ * @param given 9x9 array marking clue cells (non-zero = given)
+ * @param seed Seed that reproduces the solution grid
+ * @param out Destination buffer of at least CODEC_SEEDED_BYTES bytes
+ * @return Number of bytes written (CODEC_SEEDED_BYTES)
+ */
+size_t encode_puzzle_seeded(int given[9][9], uint64_t seed, uint8_t *out);
+
+/**
+ * Decode a solution-relative puzzle by regenerating its solution
+ *
+ * @param in Encoded bytes
+ * @param length Number of bytes available in the input
+ * @param grid 9x9 array that receives the puzzle
+ * @param solution 9x9 array that receives the full solution
+ * @return Number of bytes consumed, or 0 if the input is truncated
+ */
+size_t decode_puzzle_seeded(const uint8_t *in, size_t length, int grid[9][9], int solution[9][9]);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Clue-Value Layout:
+ * - Bytes 0-10: given mask, bit (cell % 8) of byte (cell / 8), cell = row * 9 + col
+ * - Then clue values in cell order, stored as value - 1 (0-8)
+ * - Every 5 clues form one base-9 number (< 9^5 = 59049) in 2 little-endian bytes
+ * - A final group of 1-2 clues takes 1 byte, 3-4 clues take 2 bytes
+ * - Size = 11 + 2 * (clues / 5) + tail; 3.2 bits per clue versus log2(9) = 3.17
+ *
+ * Solution-Relative Layout:
+ * - Bytes 0-7: seed (little-endian), bytes 8-18: given mask
+ * - Decoding costs one generate_solution_from_seed() call
+ *
+ * Shared Format:
+ * - Banks, save files, network messages and statistics logs should all store
+ *   puzzles through these functions so one format is parsed everywhere
+ */
@@ -0,0 +1,145 @@
+/**
+ * Daily Puzzle Module Header File
+ *
+ * This header declares the daily puzzle: one classic puzzle per date and
+ * difficulty, derived only from a seed made of the date and the level and
+ * built by the seeded generator, so every player on every machine gets the
+ * same puzzle for the same day. A daily puzzle is re-drawn from the same
+ * random stream until rate_puzzle() agrees with its level, which makes the
+ * harder levels take many generator runs.
+ *
+ * Puzzles for the next DAILY_CACHE_DAYS days are kept in a small cache file,
+ * filled by a background thread once the game is idle, so opening the daily
+ * puzzle is a file read. Every cache entry carries a hash of its contents and
+ * is regenerated instead of used when the hash does not match.
+ *
+ * Key Responsibilities:
+ * - Turn a date and difficulty into a seed and a rated puzzle
+ * - Read and verify cache entries
+ * - Fill the cache for the coming days on a background thread
+ */
+
+#ifndef DAILY_H
+#define DAILY_H
+
+#include "../include/sudoku.h"
+#include <pthread.h>
+
+// ============================================================================
+//                              DAILY CONSTANTS
+// ============================================================================
+
+#define DAILY_CACHE_FILE "sudoku-daily.cache"  // Cache in the working directory
+#define DAILY_CACHE_DAYS 7              // Days ahead kept in the cache, today included
+#define DAILY_ATTEMPTS 500              // Generator runs before settling for an off-level rating
+#define DAILY_VERSION 1                 // Bump when generation changes; old entries fail the hash
+#define DAILY_IDLE_MS 200               // Pause between cache entries on the background thread
+
+// ============================================================================
+//                              DAILY STRUCTURES
+// ============================================================================
+
+typedef struct
+{
+    long date;                          // Calendar date as YYYYMMDD
+    difficulty_t difficulty;            // Requested level
+    int grid[GRID_SIZE][GRID_SIZE];     // Clues (0 = empty)
+    int solution[GRID_SIZE][GRID_SIZE]; // The unique solution
+} daily_puzzle_t;
+
+typedef struct
+{
+    pthread_t thread;           // Cache filler thread
+    int started;                // Flag: 1 = thread running
+    volatile int stop;          // Set to abandon the fill
+} daily_cache_t;
+
+// ============================================================================
+//                              DAILY FUNCTIONS
+// ============================================================================
+
+/**
+ * Get today's local date
+ *
+ * @return Date as YYYYMMDD
+ */
+long daily_today(void);
+
+/**
+ * Move a date by whole days
+ *
+ * @param date Date as YYYYMMDD
+ * @param days Days to add (may be negative)
+ * @return Resulting date as YYYYMMDD
+ */
+long daily_add_days(long date, int days);
+
+/**
+ * Parse a date written as YYYY-MM-DD
+ *
+ * @param text Date text
+ * @param date Receives the date as YYYYMMDD
+ * @return 1 if valid, 0 otherwise
+ */
+int parse_daily_date(const char *text, long *date);
+
+/**
+ * Build the daily puzzle of a date from its seed
+ * The result depends only on the date, the level and DAILY_VERSION;
+ * classic rules must be active (set_current_variant or use_thread_topology)
+ *
+ * @param date Date as YYYYMMDD
+ * @param difficulty Level
+ * @param puzzle Receives the puzzle
+ * @param cancel Optional flag; generation stops when it becomes non-zero
+ * @return 1 on success, 0 if cancelled
+ */
+int daily_generate(long date, difficulty_t difficulty, daily_puzzle_t *puzzle,
+                   const volatile int *cancel);
+
+/**
+ * Get the daily puzzle of a date: from the cache when a verified entry
+ * exists, otherwise generated on the spot (classic rules must be active)
+ *
+ * @param date Date as YYYYMMDD
+ * @param difficulty Level
+ * @param puzzle Receives the puzzle
+ * @return 1 if it came from the cache, 0 if it was generated
+ */
+int daily_get(long date, difficulty_t difficulty, daily_puzzle_t *puzzle);
+
+/**
+ * Start filling the cache for today and the coming days
+ * Entries that are missing or fail their hash are generated one at a time,
+ * and the file is replaced atomically after each one
+ *
+ * @param cache Filler state to initialize
+ * @return 1 if the thread started, 0 otherwise
+ */
+int daily_cache_start(daily_cache_t *cache);
+
+/**
+ * Stop the cache filler and join its thread
+ *
+ * @param cache Filler state (stopping a stopped filler is harmless)
+ */
+void daily_cache_stop(daily_cache_t *cache);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Seeds:
+ * - The seed mixes the date, the level and DAILY_VERSION; dates are local
+ *   calendar days, so "today" follows the player's clock
+ * - Daily puzzles use classic rules only
+ *
+ * Cache File:
+ * - One line per entry: "YYYYMMDD LEVEL CLUES SOLUTION HASH", CLUES and
+ *   SOLUTION being the encode_puzzle() bytes (codec.h) of the puzzle and of
+ *   its solution in hex, HASH the 64-bit FNV-1a of the rest of the line and
+ *   DAILY_VERSION, in hex
+ * - Entries for past days are dropped when the filler rewrites the file;
+ *   a missing, stale or damaged file only costs a regeneration
+ */
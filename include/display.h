@@ -2,6 +2,10 @@
 #define DISPLAY_H
 
 #include "../include/sudoku.h"
+#include "../include/animate.h"
+#include "../include/game.h"
+#include "../include/feedback.h"
+#include "../include/editor.h"
 
 // Color pair constants
 #define COLOR_NORMAL 1
@@ -26,5 +30,10 @@ void draw_cell(int row, int col, int value, int is_given, int is_cursor, game_st
 void clear_status_line(void);
 void draw_completion_message(game_state_t *game);
 void format_time(int seconds, char *buffer, size_t buffer_size);
+void draw_animation_status(const animation_t *anim);
+void draw_feedback_indicator(feedback_status_t status);
+void draw_editor_status(const editor_result_t *result);
+void draw_samurai(const samurai_game_t *game);
+void draw_samurai_message(const char *message);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,113 @@
+/**
+ * Puzzle Editor Module Header File
+ *
+ * This header declares the live solution counter behind the puzzle editor.
+ * Hand-made and imported puzzles do not come from generate_puzzle(), so
+ * nothing guarantees they have exactly one solution; the editor recounts
+ * after every edit and shows 0, 1 or "2+" solutions, with a rating once the
+ * puzzle is unique.
+ *
+ * Counting runs on the background worker of background.h under a node
+ * budget, so editing never waits: each edit posts the clues and returns, and
+ * a newer post cancels the count still running on older clues.
+ *
+ * Key Responsibilities:
+ * - Count solutions of the newest posted clues on the shared latest-board worker
+ * - Stop counting at two solutions or when the node budget runs out
+ * - Keep the solution of a unique puzzle and rate it
+ * - Report the newest answer without blocking
+ */
+
+#ifndef EDITOR_H
+#define EDITOR_H
+
+#include "../include/sudoku.h"
+#include "../include/background.h"
+
+// ============================================================================
+//                              EDITOR CONSTANTS
+// ============================================================================
+
+#define EDITOR_COUNT_NODES 5000000      // Search budget per count before "undecided"
+
+// ============================================================================
+//                              EDITOR STRUCTURES
+// ============================================================================
+
+typedef enum
+{
+    EDITOR_CHECKING = 0,        // Newest clues not counted yet
+    EDITOR_NO_SOLUTION,         // The clues clash or admit no solution
+    EDITOR_UNIQUE,              // Exactly one solution
+    EDITOR_MULTIPLE,            // Two or more solutions
+    EDITOR_UNDECIDED            // Node budget ran out before the count settled
+} editor_status_t;
+
+typedef struct
+{
+    editor_status_t status;     // Solution count class
+    difficulty_t rating;        // Rating (EDITOR_UNIQUE only)
+    uint64_t nodes;             // Digits placed by the count
+    int clues;                  // Clues in the counted grid
+    int solution[GRID_SIZE][GRID_SIZE]; // The solution (EDITOR_UNIQUE only)
+} editor_result_t;
+
+typedef struct
+{
+    background_t worker;        // Counts the newest posted clues
+} editor_t;
+
+// ============================================================================
+//                              EDITOR FUNCTIONS
+// ============================================================================
+
+/**
+ * Start the counting thread
+ *
+ * @param editor Counter to initialize
+ * @return 1 on success, 0 if memory or the thread could not be obtained
+ */
+int editor_start(editor_t *editor);
+
+/**
+ * Cancel any count in progress and join the counting thread
+ *
+ * @param editor Started counter (stopping a stopped counter is harmless)
+ */
+void editor_stop(editor_t *editor);
+
+/**
+ * Post the clues for counting under the active rules and return at once
+ * A count still running on older clues is cancelled
+ *
+ * @param editor Started counter
+ * @param grid Clues (0 = empty), copied
+ */
+void editor_post(editor_t *editor, int grid[9][9]);
+
+/**
+ * Read the answer for the newest posted clues without waiting
+ *
+ * @param editor Started counter
+ * @param result Receives the answer; status EDITOR_CHECKING until it is ready
+ */
+void editor_result(editor_t *editor, editor_result_t *result);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Editing Loop:
+ *   editor_start(&editor);
+ *   ...after every edit:
+ *   editor_post(&editor, game.grid);
+ *   ...on every timeout tick:
+ *   editor_result(&editor, &result);
+ *   draw_editor_status(&result);
+ *
+ * Budget:
+ * - The count stops at the second solution, so under-constrained clues
+ *   answer "2+" quickly; only near-unique grids use much of the budget
+ * - rate_puzzle() (solver.h) rates unique puzzles
+ */
@@ -0,0 +1,107 @@
+/**
+ * Move Feedback Module Header File
+ *
+ * This header declares the optional "still solvable" check that runs after
+ * every player move. A locally legal entry can still be wrong, and
+ * check_solution() only looks at the board on request; the checker answers
+ * after each move whether the entries so far can still lead to a solution.
+ *
+ * The check runs on a background worker (background.h) so it can never
+ * delay input: the game posts a snapshot of the board and returns at once,
+ * and a newer snapshot cancels the check of an older one. With a stored
+ * solution the answer is a comparison of the entries against it; without
+ * one the search engine looks for any solution that keeps the entries,
+ * under a node budget.
+ *
+ * Key Responsibilities:
+ * - Run the check on the shared latest-board worker
+ * - Compare entries against a stored solution (fast path)
+ * - Search for a completion of the board when no solution is stored
+ * - Report the newest answer without blocking
+ */
+
+#ifndef FEEDBACK_H
+#define FEEDBACK_H
+
+#include "../include/sudoku.h"
+#include "../include/background.h"
+
+// ============================================================================
+//                             FEEDBACK CONSTANTS
+// ============================================================================
+
+#define FEEDBACK_SEARCH_NODES 2000000   // Search budget before answering "unknown"
+
+// ============================================================================
+//                             FEEDBACK STRUCTURES
+// ============================================================================
+
+typedef enum
+{
+    FEEDBACK_OFF = 0,           // Checking disabled
+    FEEDBACK_PENDING,           // Newest board not checked yet
+    FEEDBACK_SOLVABLE,          // The entries so far can still lead to a solution
+    FEEDBACK_CONTRADICTED,      // Some entry rules out every solution
+    FEEDBACK_UNKNOWN            // Search budget ran out before an answer
+} feedback_status_t;
+
+typedef struct
+{
+    background_t worker;        // Runs the check on the newest posted board
+} feedback_t;
+
+// ============================================================================
+//                             FEEDBACK FUNCTIONS
+// ============================================================================
+
+/**
+ * Start the checker thread
+ *
+ * @param feedback Checker to initialize
+ * @return 1 on success, 0 if memory or the thread could not be obtained
+ */
+int feedback_start(feedback_t *feedback);
+
+/**
+ * Cancel any check in progress and join the checker thread
+ *
+ * @param feedback Started checker (stopping a stopped checker is harmless)
+ */
+void feedback_stop(feedback_t *feedback);
+
+/**
+ * Post the current board for checking and return at once
+ * Copies the board, its solution if stored and the rule tables; a check
+ * still running on an older board is cancelled
+ *
+ * @param feedback Started checker
+ * @param game Game whose board is checked
+ */
+void feedback_post(feedback_t *feedback, game_state_t *game);
+
+/**
+ * Read the answer for the newest posted board without waiting
+ *
+ * @param feedback Started checker
+ * @return FEEDBACK_PENDING until the newest board has been checked
+ */
+feedback_status_t feedback_status(feedback_t *feedback);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Game Loop:
+ *   feedback_start(&feedback);
+ *   ...after every key that may change the board:
+ *   feedback_post(&feedback, &game);
+ *   ...on every timeout tick:
+ *   draw_feedback_indicator(feedback_status(&feedback));
+ *
+ * Meaning:
+ * - SOLVABLE does not mean every entry is forced, only that no entry is
+ *   wrong yet; an empty board of a valid puzzle is always SOLVABLE
+ * - With a stored solution the answer assumes the puzzle is unique, which
+ *   holds for every generated puzzle
+ */
@@ -0,0 +1,193 @@
+/**
+ * Puzzle Format Module Header File
+ *
+ * This header declares import and export of the common puzzle text formats:
+ * 81-character lines, SDK grids (nine rows of nine cells), SadMan Simple
+ * Sudoku .ss grids (rows like "..4|.2.|..." with dashed separator lines) and
+ * JSON objects carrying givens, player values and pencil marks.
+ *
+ * Parsing is a single-pass, byte-at-a-time state machine. It keeps its whole
+ * state in a fixed-size parser structure, so it can be fed a file in chunks
+ * of any size (a puzzle may straddle two chunks) without copying or
+ * allocating per character; the same parser backs loading a saved game and
+ * converting multi-gigabyte corpora with the batch tools. The format is
+ * detected per puzzle, so one stream may mix formats.
+ *
+ * Key Responsibilities:
+ * - Recognize puzzles in any of the four formats, one after another
+ * - Skip comments, headers and malformed puzzles, counting the latter
+ * - Write a puzzle back out in any of the formats
+ * - Read the first puzzle of a file for the game
+ */
+
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                              FORMAT CONSTANTS
+// ============================================================================
+
+#define FORMAT_RECORD_MAX 1536          // Longest record format_puzzle() writes
+#define FORMAT_KEY_MAX 16               // Longest JSON key that is recognized
+#define FORMAT_READ_BUFFER 65536        // Bytes read per chunk from a file
+
+// ============================================================================
+//                             FORMAT STRUCTURES
+// ============================================================================
+
+typedef enum
+{
+    FORMAT_LINE = 0,            // 81 characters on one line ('.' or '0' = empty)
+    FORMAT_SDK,                 // Nine lines of nine cells
+    FORMAT_SS,                  // SadMan .ss: "..4|.2.|..." rows, dashed separators
+    FORMAT_JSON,                // {"givens": "...", "values": "...", "marks": [...]}
+    FORMAT_COUNT                // Number of formats
+} puzzle_format_t;
+
+typedef struct
+{
+    int givens[GRID_SIZE][GRID_SIZE];   // Clues (0 = empty)
+    int values[GRID_SIZE][GRID_SIZE];   // Player entries outside the clues (0 = none)
+    uint16_t marks[81];                 // Pencil marks per cell (bit n-1 = mark n)
+    puzzle_format_t format;             // Format the puzzle was read in
+} puzzle_record_t;
+
+typedef enum
+{
+    FS_LINE_START = 0,          // Start of a text line
+    FS_TEXT,                    // Reading cells of a text grid
+    FS_PENDING,                 // 81 cells read; the next byte decides
+    FS_SKIP_LINE,               // Comment, header or rest of a puzzle line
+    FS_JSON_OBJECT,             // Inside a JSON object, between members
+    FS_JSON_KEY,                // Reading a member name
+    FS_JSON_COLON,              // Expecting ':' after a member name
+    FS_JSON_VALUE,              // Expecting a member value
+    FS_JSON_CELLS,              // Reading the 81 cells of "givens" or "values"
+    FS_JSON_MARKS,              // Inside the "marks" array, between strings
+    FS_JSON_MARK,               // Reading the marks of one cell
+    FS_JSON_SKIP,               // Skipping the value of an unknown member
+    FS_JSON_SKIP_STRING,        // Skipping a string inside an unknown value
+    FS_JSON_BAD,                // Dropping a malformed object up to its end
+    FS_JSON_BAD_STRING          // Dropping a string inside a malformed object
+} format_state_t;
+
+typedef struct
+{
+    format_state_t state;       // Current state
+    int cells;                  // Cells read into the current puzzle
+    int line_cells;             // Cells read on the current text line
+    int lines;                  // Text lines that held cells
+    int bars;                   // Flag: a '|' was seen (.ss grid)
+    int field;                  // JSON member being read (0 = givens, 1 = values, 2 = marks)
+    int index;                  // Position within a JSON string or the marks array
+    int depth;                  // Nesting while skipping a JSON value
+    int escaped;                // Flag: the previous byte was a backslash
+    int seen;                   // JSON members read (bit field)
+    int key_length;             // Bytes in key
+    char key[FORMAT_KEY_MAX];   // Current JSON member name
+    puzzle_record_t record;     // Puzzle being assembled
+    long puzzles;               // Puzzles returned so far
+    long skipped;               // Malformed puzzles dropped so far
+} format_parser_t;
+
+// ============================================================================
+//                              FORMAT FUNCTIONS
+// ============================================================================
+
+/**
+ * Prepare a parser for a new stream
+ *
+ * @param parser Parser to reset
+ */
+void format_parser_init(format_parser_t *parser);
+
+/**
+ * Feed bytes to the parser until a puzzle completes or the bytes run out
+ * Call again with the remaining bytes (data + *used) after a puzzle
+ *
+ * @param parser Parser state
+ * @param data Next bytes of the stream
+ * @param length Number of bytes
+ * @param used Receives the bytes consumed
+ * @param record Receives the puzzle when one completes
+ * @return 1 if a puzzle completed, 0 if all bytes were consumed without one
+ */
+int format_feed(format_parser_t *parser, const char *data, size_t length, size_t *used,
+                puzzle_record_t *record);
+
+/**
+ * Finish the stream: return a puzzle still waiting for its final byte
+ * A partial puzzle at the end is counted as skipped
+ *
+ * @param parser Parser state
+ * @param record Receives the puzzle
+ * @return 1 if a puzzle completed, 0 otherwise
+ */
+int format_finish(format_parser_t *parser, puzzle_record_t *record);
+
+/**
+ * Write a puzzle in a format
+ * Text formats carry the givens only; JSON also carries values and marks
+ *
+ * @param record Puzzle to write
+ * @param format Output format
+ * @param out Buffer of at least FORMAT_RECORD_MAX bytes
+ * @return Bytes written (no terminating zero)
+ */
+size_t format_puzzle(const puzzle_record_t *record, puzzle_format_t format, char *out);
+
+/**
+ * Parse a format name
+ *
+ * @param name "line", "sdk", "ss" or "json"
+ * @param format Receives the parsed format
+ * @return 1 if recognized, 0 otherwise
+ */
+int parse_format(const char *name, puzzle_format_t *format);
+
+/**
+ * Read the first puzzle of a file
+ *
+ * @param path File path, or "-" for standard input
+ * @param record Receives the puzzle
+ * @return 1 if a puzzle was read, 0 on I/O error or when none was found
+ */
+int read_puzzle_file(const char *path, puzzle_record_t *record);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Streaming:
+ *   format_parser_init(&parser);
+ *   while ((n = read(fd, buffer, size)) > 0)
+ *   {
+ *       size_t pos = 0, used;
+ *       while (format_feed(&parser, buffer + pos, n - pos, &used, &record))
+ *       {
+ *           pos += used;
+ *           ...handle record...
+ *       }
+ *   }
+ *   if (format_finish(&parser, &record))
+ *       ...handle the last record...
+ *
+ * Text Grids:
+ * - '1'-'9' are clues, '.' and '0' empty cells; '|', '-', '+' and blanks
+ *   are layout and ignored
+ * - Lines starting with '#', '!', '[', '"' or a letter are comments or headers
+ * - A line holding cells must hold exactly nine, unless it completes the 81
+ *   cells of the puzzle on its own (the 81-character form); after the 81st
+ *   cell the rest of the line is ignored unless more cells follow directly
+ *
+ * JSON:
+ * - One object per puzzle; objects may span lines, sit one per line or be
+ *   elements of an array
+ * - "givens" (required) and "values" are 81-cell strings; "marks" is an
+ *   array of 81 strings of digits; other members are skipped
+ * - Only plain objects are recognized: nested values are allowed only in
+ *   skipped members
+ */
@@ -18,6 +18,10 @@
 #define GAME_H
 
 #include "../include/sudoku.h"
+#include "../include/samurai.h"
+#include "../include/format.h"
+
+#define SAVE_FILE_NAME "sudoku-save.json"   // Written by the save key, read by --play
 
 // ============================================================================
 //                          GAME LIFECYCLE FUNCTIONS
@@ -36,12 +40,75 @@ void init_game(game_state_t *game, difficulty_t difficulty);
 /**
  * Generate a completely new puzzle and reset game state
  * Creates fresh puzzle, solution, and given arrays while preserving difficulty setting
+ * Classic puzzles come from the shared pool when a daemon keeps one (pool.h)
  * Resets cursor position, move counter, and completion status
  * 
  * @param game Pointer to game state structure to update
  */
 void new_puzzle(game_state_t *game);
 
+/**
+ * Switch to the next rule variant and generate a puzzle for it
+ * Cycles through classic, X-Sudoku, Windoku, Jigsaw, Killer and Samurai,
+ * keeping the difficulty; Samurai is played through samurai_game_t, so no
+ * 9x9 puzzle is generated for it
+ * 
+ * @param game Pointer to game state structure to update
+ */
+void change_variant(game_state_t *game);
+
+/**
+ * Turn the current puzzle into editable clues
+ * Player entries, marks and branches are dropped; the clues stay on the
+ * grid but are no longer locked, so the editor can change any cell
+ * 
+ * @param game Pointer to game state structure to edit
+ */
+void start_editing(game_state_t *game);
+
+/**
+ * Start playing the clues left by the editor
+ * Every filled cell becomes a given; the timer and move counter restart
+ * 
+ * @param game Pointer to game state structure holding the clues
+ * @param solution The unique solution of the clues
+ */
+void play_edited_puzzle(game_state_t *game, int solution[9][9]);
+
+/**
+ * Load the first puzzle of a file (line, SDK, .ss or JSON) as a classic puzzle
+ * Clues become givens and JSON entries and marks are restored; the solution
+ * is computed at load time. A puzzle with several solutions is still loaded,
+ * with has_solution cleared so checks fall back to the solver
+ * 
+ * @param game Pointer to game state structure to fill
+ * @param path Puzzle file, or "-" for standard input
+ * @return Solutions found (1 unique, 2 several), 0 if unsolvable (game
+ *         unchanged), -1 if no puzzle could be read (game unchanged)
+ */
+int load_puzzle(game_state_t *game, const char *path);
+
+/**
+ * Save the current puzzle to a file
+ * JSON keeps the player's entries and marks; the text formats keep clues only
+ * 
+ * @param game Pointer to game state structure to save
+ * @param path File to write (replaced if it exists)
+ * @param format File format
+ * @return 1 on success, 0 for non-classic rules or on I/O error
+ */
+int save_puzzle(const game_state_t *game, const char *path, puzzle_format_t format);
+
+/**
+ * Start the daily puzzle of a date at the current difficulty
+ * Switches to classic rules; the puzzle is the same on every machine
+ * 
+ * @param game Pointer to game state structure to fill
+ * @param date Date as YYYYMMDD (see daily.h)
+ * @return 1 if the puzzle came from the daily cache, 0 if it was generated
+ */
+int new_daily_puzzle(game_state_t *game, long date);
+
 /**
  * Reset current game to original puzzle state
  * Restores initial clues and clears all player entries
@@ -175,6 +242,82 @@ void resume_timer(game_state_t *game);
  */
 int get_elapsed_time(game_state_t *game);
 
+// ============================================================================
+//                             SAMURAI GAME
+// ============================================================================
+// The five-grid Samurai layout does not fit the 9x9 game state, so it keeps
+// its own state over the 369 cells of samurai.h
+
+typedef struct
+{
+    int grid[SAMURAI_CELLS];        // Current puzzle state (player's progress)
+    int solution[SAMURAI_CELLS];    // Complete solution to the puzzle
+    int given[SAMURAI_CELLS];       // 1 = original clue, 0 = player-filled
+    int cursor;                     // Cell under the cursor
+    difficulty_t difficulty;        // Level selecting the clue count
+    int clues;                      // Clues left by the generator
+    int moves;                      // Count of player moves
+    time_t start_time;              // When the puzzle was started
+    time_t completion_time;         // When the puzzle was completed (0 if not finished)
+} samurai_game_t;
+
+/**
+ * Generate a new Samurai puzzle and reset the game state
+ * Starts the timer and puts the cursor on the first cell
+ *
+ * @param game Samurai state to reset
+ * @param difficulty Level selecting the clue count
+ */
+void new_samurai_puzzle(samurai_game_t *game, difficulty_t difficulty);
+
+/**
+ * Move the cursor one cell in a direction, jumping over the holes
+ * between the grids; stays put at the edge of the layout
+ *
+ * @param game Samurai state
+ * @param drow Row step (-1, 0 or 1)
+ * @param dcol Column step (-1, 0 or 1)
+ */
+void move_samurai_cursor(samurai_game_t *game, int drow, int dcol);
+
+/**
+ * Enter a number at the cursor unless the cell is a clue
+ *
+ * @param game Samurai state
+ * @param num Number to enter (1-9)
+ */
+void enter_samurai_number(samurai_game_t *game, int num);
+
+/**
+ * Clear the cursor cell unless it is a clue
+ *
+ * @param game Samurai state
+ */
+void delete_samurai_number(samurai_game_t *game);
+
+/**
+ * Reveal the complete solution
+ *
+ * @param game Samurai state
+ */
+void solve_samurai_puzzle(samurai_game_t *game);
+
+/**
+ * Check whether every cell matches the solution
+ *
+ * @param game Samurai state
+ * @return 1 if complete and correct, 0 otherwise
+ */
+int is_samurai_complete(const samurai_game_t *game);
+
+/**
+ * Elapsed time of a Samurai game, frozen once completed
+ *
+ * @param game Samurai state
+ * @return Elapsed time in seconds
+ */
+int get_samurai_elapsed_time(const samurai_game_t *game);
+
 // Add these to your game.h header file
 
 // Hint system functions
@@ -17,6 +17,55 @@
 #define GENERATOR_H
 
 #include "../include/sudoku.h"
+#include "../include/rng.h"
+#include "../include/topology.h"
+
+// ============================================================================
+//                          GENERATION OPTIONS
+// ============================================================================
+// Settings and results for generate_puzzle_ex()
+
+typedef enum
+{
+    SYMMETRY_NONE = 0,          // Clues may be anywhere
+    SYMMETRY_ROTATIONAL,        // Clue pattern unchanged by a 180-degree turn
+    SYMMETRY_DIAGONAL,          // Clue pattern mirrored across the main diagonal
+    SYMMETRY_MIRROR,            // Clue pattern mirrored left to right
+    SYMMETRY_DIHEDRAL           // All rotations and reflections of the square
+} symmetry_t;
+
+typedef enum
+{
+    GENERATOR_REMOVAL = 0,      // Start from the full grid and remove clues
+    GENERATOR_HITTING_SET       // Pick clues hitting every unavoidable set, then trim
+} generator_method_t;
+
+#define GENERATOR_ATTEMPTS 8        // Removal passes tried when the target is missed
+#define REGION_SHUFFLE_STEPS 3000   // Trade attempts when generating a jigsaw layout
+#define REGION_CHECK_NODES 10000   // Search budget for proving a jigsaw layout solvable
+#define VARIANT_FILL_SEEDS 11       // Random digits placed before a variant grid fill
+#define VARIANT_FILL_NODES 2000     // Search budget per variant fill try before restarting
+#define KILLER_SEARCH_NODES 20000   // Search budget per killer uniqueness check before splitting
+
+typedef struct
+{
+    difficulty_t difficulty;    // Used for the clue target when target_clues is 0
+    int target_clues;           // Desired clue count (0 = from difficulty)
+    symmetry_t symmetry;        // Clue pattern symmetry to preserve
+    rng_t *rng;                 // Seeded random source (NULL = rand())
+    int minimal;                // Flag: 1 = keep removing until no clue is redundant
+    int attempts;               // Removal passes before settling (0 = GENERATOR_ATTEMPTS)
+    const volatile int *cancel; // Optional flag: stop at the next uniqueness check (NULL = none)
+    generator_method_t method;  // How clues are chosen (hitting sets need SYMMETRY_NONE)
+} generator_options_t;
+
+typedef struct
+{
+    int clues;                  // Clues in the generated puzzle
+    int target_clues;           // Clue count that was requested
+    int tests;                  // Uniqueness checks performed
+    int attempts;               // Removal passes used
+} generator_report_t;
 
 // ============================================================================
 //                          MAIN GENERATION FUNCTIONS
@@ -36,6 +85,77 @@
  */
 int generate_puzzle(int grid[9][9], int solution[9][9], int given[9][9], difficulty_t difficulty);
 
+/**
+ * Generate a puzzle with explicit options and report the result
+ * Walks a shuffled permutation of the 81 cells and tests each cell (or
+ * symmetric group) exactly once per pass; a pass that misses the clue target
+ * is retried up to options->attempts times and the best puzzle is kept
+ * With options->minimal set, the pass continues past the target until no
+ * clue can be removed, so the result is a minimal puzzle
+ *
+ * @param grid 9x9 array to store the puzzle
+ * @param solution 9x9 array to store the complete solution
+ * @param given 9x9 array to mark original clues
+ * @param options Difficulty, clue target, symmetry, attempts, random source and
+ *                cancel flag
+ * @param report Receives the achieved clue count (may be NULL)
+ * @return 1 if the clue target was reached (or beaten in minimal mode),
+ *         0 if the unique puzzle has more clues
+ */
+int generate_puzzle_ex(int grid[9][9], int solution[9][9], int given[9][9],
+                       const generator_options_t *options, generator_report_t *report);
+
+/**
+ * Generate a random jigsaw region layout
+ * Regions are traded cell by cell away from the boxes while staying
+ * connected; a layout is kept only once a search finds a grid for it
+ * 
+ * @param regions Receives the region (0-8) of each cell
+ * @param rng Seeded random source (NULL = rand())
+ * @return Number of cell trades made
+ */
+int generate_regions(uint8_t regions[81], rng_t *rng);
+
+/**
+ * Generate a Killer Sudoku with no givens
+ * Cages are cut from a new grid and split until the solution is unique;
+ * larger cages at harder levels leave less to go on
+ * Uses the calling thread's topology override while it runs (see
+ * use_thread_topology()) and clears it afterwards
+ * 
+ * @param grid 9x9 array for the puzzle (all cells empty)
+ * @param solution 9x9 array to store the complete solution
+ * @param given 9x9 array to mark original clues (all 0)
+ * @param difficulty Level selecting the cage sizes
+ * @param rng Seeded random source (NULL = rand())
+ * @param layout Receives the cages, which also become the active killer layout
+ * @return Number of cage splits needed to make the solution unique
+ */
+int generate_killer_puzzle(int grid[9][9], int solution[9][9], int given[9][9],
+                           difficulty_t difficulty, rng_t *rng, cage_layout_t *layout);
+
+/**
+ * Generate a complete solution grid that depends only on a seed
+ * The same seed yields the same grid on every machine, which lets encodings
+ * store a seed instead of the full solution
+ * The grid always follows the classic rules, whatever variant is active
+ *
+ * @param solution 9x9 array that receives the complete grid
+ * @param seed 64-bit seed for the deterministic generator
+ * @return 1 if generation successful, 0 if failed
+ */
+int generate_solution_from_seed(int solution[9][9], uint64_t seed);
+
+/**
+ * Fill an empty grid with a complete solution using a seeded generator
+ * Randomized backtracking like generate_complete_grid(), but reproducible
+ *
+ * @param grid 9x9 array to fill (empty cells must be 0)
+ * @param rng Generator state (advanced by the call)
+ * @return 1 if successful generation, 0 if failed
+ */
+int generate_complete_grid_seeded(int grid[9][9], rng_t *rng);
+
 // ============================================================================
 //                          DIFFICULTY CONFIGURATION
 // ============================================================================
@@ -109,6 +229,16 @@ int find_empty_cell(int grid[9][9], int *row, int *col);
  */
 void shuffle_array(int *array, int num);
 
+/**
+ * Shuffle an array using Fisher-Yates with a seeded generator
+ * Produces the same permutation for the same generator state
+ *
+ * @param array Pointer to integer array to shuffle
+ * @param num Number of elements in the array
+ * @param rng Generator state (advanced by the call)
+ */
+void shuffle_array_seeded(int *array, int num, rng_t *rng);
+
 #endif
 
 /**
@@ -116,10 +246,41 @@ void shuffle_array(int *array, int num);
  * 
  * Generation Process:
  * 1. Create complete valid grid using solve_grid() with randomization
- * 2. Strategically remove cells based on difficulty level
- * 3. Validate that puzzle maintains unique solution
+ * 2. Visit cells in a shuffled order, each cell (or symmetric group) once
+ * 3. Keep a removal only if the puzzle maintains a unique solution
  * 4. Mark remaining cells as "given" clues
  * 
+ * Minimal Puzzles:
+ * - A clue that cannot be removed stays necessary when more clues are
+ *   removed later, so one full pass over the permutation (options.minimal)
+ *   already yields a minimal puzzle with no extra uniqueness checks
+ * - With symmetry, minimality holds per symmetric group of cells
+ * - is_minimal_puzzle() verifies minimality of puzzles from other sources
+ * 
+ * Clue Targets:
+ * - At most 81 uniqueness checks per pass, regardless of difficulty
+ * - A pass is abandoned as soon as too few cells remain to reach the target
+ * - Retries alternate between a new order on the same grid and a new grid;
+ *   the last pass always runs to the end so a puzzle is always produced
+ * - options.cancel cuts generation short; the best puzzle so far (always
+ *   unique, possibly with extra clues) is returned
+ * 
+ * Hitting-Set Method:
+ * - Clues are chosen greedily so that every unavoidable set of the grid
+ *   holds at least one; only such patterns are ever searched
+ * - A pattern that is still not unique yields a second solution, and the
+ *   cells where it differs form a new set that the next clue must hit
+ * - The unique pattern is then trimmed by an ordinary removal pass, or
+ *   padded with random clues if it is already below the target
+ * - Works without symmetry only; symmetric requests use removal
+ * 
+ * Symmetry:
+ * - Each cell belongs to a group (orbit) of 1, 2, 4 or 8 cells that are
+ *   removed together; a group is checked with is_unique_without_cells()
+ * - Larger groups fail more often, so symmetric targets lean on retries
+ * - generator_report_t.clues may exceed the target when no further cell
+ *   can be removed; generate_puzzle_ex() then returns 0
+ * 
  * Difficulty Levels:
  * - EASY: ~36 clues (45 cells removed)
  * - MEDIUM: ~32 clues (49 cells removed) 
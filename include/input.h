@@ -165,5 +165,13 @@ int can_enter_number(game_state_t *game, int row, int col);
  * - m: toggle mark mode
  * - q/ESC: quit game
  * - n: new puzzle
+ * - v: change variant (classic, X-Sudoku, Windoku, Jigsaw, Killer, Samurai) and start a new puzzle
+ * - b/u/k: open a what-if branch, undo it, keep it (see branch.h)
+ * - f: toggle the background "still solvable" check after each move (see feedback.h)
+ * - d: today's daily puzzle at the current difficulty, the same on every machine (see daily.h)
+ * - p: save the puzzle with entries and marks as JSON (SAVE_FILE_NAME, game.h); "sudoku --play FILE" loads it
+ * - e: edit the clues with a live solution count and rating (see editor.h)
+ * - Samurai runs its own loop (arrows, 1-9, x, n, s, v, q) over a scrolling view
  * - s: solve puzzle
+ * - a: animate solve (+/- change speed)
  */
\ No newline at end of file
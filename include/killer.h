@@ -0,0 +1,127 @@
+/**
+ * Killer Sudoku Module Header File
+ *
+ * This header declares the cage-combination tables and the cage layouts used
+ * by Killer Sudoku. A cage of n cells with sum s can only hold a digit set
+ * whose n digits add up to s; the tables list those sets for every
+ * (size, sum) pair as 9-bit masks, so the search engine narrows a cell to
+ * the digits of the still-possible sets with a few AND and OR operations
+ * instead of trying every digit against the cage sum.
+ *
+ * Key Responsibilities:
+ * - Precompute every digit set (9-bit mask) bucketed by size and sum
+ * - Combine the sets still possible for a partly filled cage into one mask
+ * - Cut a solution grid into random connected cages without repeated digits
+ * - Split a cage when the layout does not pin down a unique solution
+ */
+
+#ifndef KILLER_H
+#define KILLER_H
+
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+#include "../include/rng.h"
+
+// ============================================================================
+//                              KILLER CONSTANTS
+// ============================================================================
+
+#define KILLER_DIGIT_SETS 512           // Every subset of the digits 1-9
+#define KILLER_MAX_SUM 45               // Sum of the digits 1-9
+
+// ============================================================================
+//                           COMBINATION TABLES
+// ============================================================================
+
+typedef struct
+{
+    uint16_t masks[KILLER_DIGIT_SETS];                  // Digit sets ordered by size, then sum
+    uint16_t start[GRID_SIZE + 1][KILLER_MAX_SUM + 2];  // First set of each (size, sum) bucket
+} combination_table_t;
+
+/**
+ * Get the digit-set tables
+ * Built on the first call (thread-safe); fetch once, not per lookup
+ *
+ * @return Read-only tables, valid for the life of the program
+ */
+const combination_table_t *combination_table(void);
+
+/**
+ * Digits that can still go into the empty cells of a cage
+ * Unions every set of size digits summing to sum that avoids the excluded
+ * digits (those already placed in the cage)
+ *
+ * @param table Tables from combination_table()
+ * @param size Empty cells left in the cage (0-9)
+ * @param sum Sum the empty cells must still make up
+ * @param excluded Digits already used in the cage (bit n-1 = digit n)
+ * @return 9-bit mask of usable digits (0 = the cage cannot be completed)
+ */
+static inline uint16_t cage_combinations(const combination_table_t *table, int size, int sum,
+                                         uint16_t excluded)
+{
+    uint16_t allowed = 0;
+
+    if (size < 0 || size > GRID_SIZE || sum < 0 || sum > KILLER_MAX_SUM)
+        return 0;
+
+    for (int i = table->start[size][sum]; i < table->start[size][sum + 1]; i++)
+    {
+        if (!(table->masks[i] & excluded))
+            allowed |= table->masks[i];
+    }
+
+    return allowed;
+}
+
+// ============================================================================
+//                              CAGE LAYOUTS
+// ============================================================================
+
+/**
+ * Cut a solution grid into random cages
+ * Cages are orthogonally connected, never repeat a digit and take their
+ * sums from the grid, so the grid always solves the layout; cages of one
+ * cell are merged into a neighbour where possible. Harder levels grow
+ * larger cages, which leave more room for other solutions
+ *
+ * @param solution Complete 9x9 grid
+ * @param difficulty Level selecting the cage sizes
+ * @param rng Seeded random source (NULL = rand())
+ * @param layout Receives the cages (cells listed in row-major order)
+ * @return Number of cages
+ */
+int generate_cages(int solution[9][9], difficulty_t difficulty, rng_t *rng, cage_layout_t *layout);
+
+/**
+ * Split the cage holding a cell into smaller connected cages
+ * The part grown from the cell takes about half the cage; the rest is split
+ * into its connected pieces. Sums are recomputed from the solution
+ *
+ * @param layout Cage layout to modify
+ * @param cell Cell whose cage is split (cages of one cell are left alone)
+ * @param solution Complete 9x9 grid the layout was built from
+ * @return 1 if the cage was split, 0 if it had a single cell
+ */
+int split_cage(cage_layout_t *layout, int cell, int solution[9][9]);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Digit Sets:
+ * - Bit n-1 of a mask stands for digit n, as in the search engine
+ * - A (size, sum) bucket holds at most 12 sets (size 4 or 5, sum 20), so a
+ *   lookup is a short loop over precomputed masks
+ *
+ * Search:
+ *   const combination_table_t *table = combination_table();
+ *   allowed = cage_combinations(table, empty_cells, sum_left, used_digits);
+ *   candidates &= allowed;
+ *
+ * Generation:
+ * - generate_killer_puzzle() (generator.h) calls generate_cages() on a new
+ *   grid and splits cages with split_cage() until the solution is unique
+ */
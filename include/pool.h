@@ -0,0 +1,182 @@
+/**
+ * Shared Puzzle Pool Module Header File
+ *
+ * This header declares the puzzle pool shared by every sudoku process on a
+ * machine. A generator daemon ("sudoku --daemon") keeps one ring of ready
+ * classic puzzles per difficulty in POSIX shared memory; new_puzzle() in any
+ * game process takes a puzzle from the ring of its level and only generates
+ * one itself when the pool is missing or empty. Generation is then paid once
+ * for all users, ahead of time, and starting a puzzle never waits for it.
+ *
+ * Each ring is a bounded lock-free multi-producer, multi-consumer queue: a
+ * slot carries a sequence number that tells producers and consumers whose
+ * turn it is, and the head and tail are claimed by compare-and-swap, so any
+ * number of daemon threads and game processes can use a ring at once without
+ * a lock that a killed process could leave held.
+ *
+ * Key Responsibilities:
+ * - Create and initialize the shared segment (daemon) or map it (games)
+ * - Push and pop puzzles without locks
+ * - Verify puzzles taken from the pool before they are played
+ * - Run the daemon that keeps every ring full
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include "../include/sudoku.h"
+#include "../include/codec.h"
+
+// ============================================================================
+//                               POOL CONSTANTS
+// ============================================================================
+
+#define POOL_SHM_NAME "/sudoku-pool"    // Shared memory object (see shm_open)
+#define POOL_LOCK_NAME "/sudoku-pool.lock" // Locked by the running daemon; never unlinked
+#define POOL_CAPACITY 64                // Puzzles per ring; a power of two
+#define POOL_LEVELS 4                   // One ring per difficulty, EASY through EXPERT
+#define POOL_MAGIC 0x53554450u          // "SUDP": set once the segment is initialized
+#define POOL_VERSION 2                  // Bump when the segment layout changes
+#define POOL_IDLE_MS 100                // Daemon pause while every ring is full
+#define POOL_CHECK_NODES 10000000       // Search budget when verifying a pooled puzzle
+
+// ============================================================================
+//                              POOL STRUCTURES
+// ============================================================================
+// Layout of the shared segment; every process must agree on it (POOL_VERSION)
+
+typedef struct
+{
+    uint64_t sequence;          // Turn counter: pos = free for push, pos + 1 = ready to pop
+    uint8_t size;               // Bytes used in puzzle[]
+    uint8_t puzzle[CODEC_MAX_BYTES]; // Clues in the shared codec format (encode_puzzle())
+} pool_slot_t;
+
+typedef struct
+{
+    uint64_t head;              // Next position to push (claimed by CAS)
+    uint8_t head_pad[56];       // Keeps producers and consumers on separate cache lines
+    uint64_t tail;              // Next position to pop (claimed by CAS)
+    uint8_t tail_pad[56];
+    pool_slot_t slots[POOL_CAPACITY];
+} pool_ring_t;
+
+typedef struct
+{
+    uint32_t magic;             // POOL_MAGIC once initialized (published last)
+    uint32_t version;           // POOL_VERSION of the daemon that built it
+    int64_t owner;              // Process id of the daemon
+    pool_ring_t rings[POOL_LEVELS];
+} pool_shared_t;
+
+typedef struct
+{
+    pool_shared_t *shared;      // Mapped segment (NULL = not open)
+} pool_t;
+
+// ============================================================================
+//                               POOL FUNCTIONS
+// ============================================================================
+
+/**
+ * Map the pool built by a running or earlier daemon
+ *
+ * @param pool Handle to fill
+ * @return 1 if an initialized pool of this version was mapped, 0 otherwise
+ */
+int pool_open(pool_t *pool);
+
+/**
+ * Unmap the pool (closing a closed pool is harmless)
+ *
+ * @param pool Handle to close
+ */
+void pool_close(pool_t *pool);
+
+/**
+ * Add a puzzle to the ring of a difficulty
+ *
+ * @param pool Open pool
+ * @param difficulty Ring to add to
+ * @param grid Clues (0 = empty) of a puzzle with a unique solution
+ * @return 1 if added, 0 if the ring is full
+ */
+int pool_push(pool_t *pool, difficulty_t difficulty, int grid[9][9]);
+
+/**
+ * Take the oldest puzzle from the ring of a difficulty
+ * A slot whose bytes do not decode yields an empty grid
+ *
+ * @param pool Open pool
+ * @param difficulty Ring to take from
+ * @param grid Receives the clues
+ * @return 1 if a puzzle was taken, 0 if the ring is empty
+ */
+int pool_pop(pool_t *pool, difficulty_t difficulty, int grid[9][9]);
+
+/**
+ * Count the puzzles waiting in a ring (a snapshot; others may be pushing
+ * or popping meanwhile)
+ *
+ * @param pool Open pool
+ * @param difficulty Ring to count
+ * @return Puzzles ready, 0 to POOL_CAPACITY
+ */
+int pool_count(pool_t *pool, difficulty_t difficulty);
+
+/**
+ * Take a verified classic puzzle from the shared pool, if there is one
+ * Opens and closes the pool on each call, so a restarted daemon is picked
+ * up; classic rules must be active for the check
+ *
+ * @param difficulty Level wanted
+ * @param grid Receives the clues
+ * @param solution Receives the solution
+ * @return 1 if a puzzle was taken, 0 if the caller must generate one
+ */
+int pool_take(difficulty_t difficulty, int grid[9][9], int solution[9][9]);
+
+/**
+ * Run the generator daemon until SIGINT or SIGTERM
+ * Takes the daemon lock (refusing if another daemon holds it), builds a
+ * fresh segment and keeps every ring full, generating for the emptiest
+ * ring first
+ *
+ * @param threads Generator threads (0 = one per online CPU)
+ * @return Process exit status (0 after a signal, 1 on error)
+ */
+int pool_daemon(int threads);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Sharing:
+ * - The segment is created with mode 0666 so every user's game can take
+ *   puzzles; since anyone can write to it, pool_take() checks that the
+ *   clues have exactly one solution before use
+ *
+ * Slots:
+ * - A slot holds only the clues, packed by encode_puzzle() (codec.h) like
+ *   every other stored puzzle; pool_take() gets the solution from the same
+ *   search that verifies uniqueness, so nothing in the segment is trusted
+ * - Only classic puzzles are pooled; other variants always generate locally
+ *
+ * Daemon Start:
+ * - Only the holder of the lock on POOL_LOCK_NAME may replace the segment,
+ *   so two daemons started together cannot unlink each other's segment; a
+ *   killed daemon's lock is released by the kernel
+ *
+ * Failure Modes:
+ * - A slot whose turn counter was overwritten reads as full or empty rather
+ *   than being waited on, so a bad write cannot hang a game
+ * - A process killed between claiming a slot and publishing it stalls that
+ *   ring at the slot (it reads as full or empty); restarting the daemon
+ *   builds a new segment and games move to it on their next pool_take()
+ * - Puzzles left in the segment after the daemon exits are still served
+ *
+ * Example:
+ *   sudoku --daemon --threads 2 &     # fill the pool in the background
+ *   sudoku                            # 'n' now starts pooled puzzles
+ */
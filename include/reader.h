@@ -0,0 +1,180 @@
+/**
+ * Puzzle Reader Module Header File
+ *
+ * This header declares the input layer used by the batch tools. Puzzle files are
+ * read one puzzle per line (81 characters, '.' or '0' for empty cells) and parsed
+ * straight into 9x9 solver grids without intermediate copies.
+ *
+ * Key Responsibilities:
+ * - Memory-map regular files and split lines in place
+ * - Stream stdin and pipes through one large reusable buffer
+ * - Parse 81-character rows with a SIMD fast path and scalar fallback
+ * - Read the optional jigsaw region map or killer cage list that follows a
+ *   puzzle on its line
+ * - Track line numbers and skipped (malformed) lines for reporting
+ */
+
+#ifndef READER_H
+#define READER_H
+
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+
+// ============================================================================
+//                              READER CONSTANTS
+// ============================================================================
+
+#define PUZZLE_LINE_LENGTH 81           // Cells per puzzle line
+#define READER_STREAM_BUFFER (1 << 20)  // 1 MiB buffer for stdin / pipes
+
+// ============================================================================
+//                             READER STATE STRUCTURE
+// ============================================================================
+
+typedef struct
+{
+    int fd;                     // Source file descriptor
+    int mapped;                 // 1 = data is an mmap of the whole file, 0 = streaming
+    int eof;                    // Flag: 1 = no more bytes will be read from fd
+    int overlong;               // Flag: 1 = discarding a line longer than the buffer
+
+    const char *data;           // Mapped file or streaming buffer contents
+    size_t size;                // Number of valid bytes in data
+    size_t pos;                 // Parse position within data
+
+    char *buffer;               // Streaming buffer (NULL when mapped)
+    uint64_t buffer_offset;     // File offset of buffer[0] while streaming
+
+    uint64_t line_offset;       // File offset of the last line returned
+    long line;                  // Line number of the last line returned (1-based)
+    long skipped;               // Count of malformed lines skipped so far
+
+    int has_regions;            // Flag: 1 = the last puzzle carried a region map
+    uint8_t regions[81];        // Region (0-8) of each cell when has_regions is set
+    int has_cages;              // Flag: 1 = the last puzzle carried killer cages
+    cage_layout_t cages;        // Killer cages when has_cages is set
+} reader_t;
+
+// ============================================================================
+//                              READER FUNCTIONS
+// ============================================================================
+
+/**
+ * Open a puzzle source for reading
+ * Regular files are memory-mapped; "-" (stdin) and anything that cannot be
+ * mapped falls back to the large-buffer streaming reader
+ *
+ * @param reader Reader state to initialize
+ * @param path File path, or "-" for standard input
+ * @return 1 if the source was opened, 0 on error
+ */
+int reader_open(reader_t *reader, const char *path);
+
+/**
+ * Parse the next puzzle line into a grid
+ * Blank lines and lines starting with '#' are ignored, malformed lines are
+ * skipped and counted in reader->skipped
+ *
+ * @param reader Open reader
+ * @param grid 9x9 grid that receives the puzzle (0 = empty cell)
+ * @return 1 if a puzzle was read, 0 at end of input
+ */
+int reader_next(reader_t *reader, int grid[9][9]);
+
+/**
+ * Byte offset just past the last line returned
+ *
+ * @param reader Open reader
+ * @return Input offset where the next line starts
+ */
+uint64_t reader_offset(const reader_t *reader);
+
+/**
+ * Continue reading at an offset saved with reader_offset()
+ * Streamed input cannot seek, so the bytes before the offset are read and
+ * discarded; the caller must feed the same input again
+ *
+ * @param reader Freshly opened reader
+ * @param offset Input offset to resume at
+ * @param line Line number of the line before the offset (restores reader->line)
+ * @param skipped Malformed lines before the offset (restores reader->skipped)
+ * @return 1 on success, 0 if the input is shorter than the offset
+ */
+int reader_seek(reader_t *reader, uint64_t offset, long line, long skipped);
+
+/**
+ * Release the mapping or streaming buffer and close the source
+ *
+ * @param reader Reader to close
+ */
+void reader_close(reader_t *reader);
+
+/**
+ * Parse one puzzle line (without its newline) into a grid
+ * The first 81 characters must be digits or '.', optionally followed by
+ * whitespace, '#' or ';' and trailing text
+ *
+ * @param line Start of the line (not NUL-terminated)
+ * @param length Number of bytes in the line
+ * @param grid 9x9 grid that receives the puzzle
+ * @return 1 if the line holds a puzzle, 0 if it is malformed
+ */
+int parse_puzzle_line(const char *line, size_t length, int grid[9][9]);
+
+/**
+ * Parse the jigsaw region map that may follow the puzzle on a line
+ * The map is a second field of 81 digits 1-9 (region of each cell, row by
+ * row), separated from the puzzle by spaces or tabs
+ *
+ * @param line Start of the puzzle line (not NUL-terminated)
+ * @param length Number of bytes in the line
+ * @param regions Receives the region (0-8) of each cell
+ * @return 1 if the line carries a region map, 0 otherwise
+ */
+int parse_region_map(const char *line, size_t length, uint8_t regions[81]);
+
+/**
+ * Parse the killer cage list that may follow the puzzle on a line
+ * The list is a second field of comma-separated cages, each "<sum>@" and
+ * the 1-based row and column digit of every cell, e.g. "15@111221,3@1314"
+ *
+ * @param line Start of the puzzle line (not NUL-terminated)
+ * @param length Number of bytes in the line
+ * @param cages Receives the cages
+ * @return 1 if the line carries a cage list, 0 otherwise
+ */
+int parse_cage_list(const char *line, size_t length, cage_layout_t *cages);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Typical Loop:
+ *   reader_t reader;
+ *   int grid[9][9];
+ *   if (reader_open(&reader, path)) {
+ *       while (reader_next(&reader, grid)) { ... }
+ *       reader_close(&reader);
+ *   }
+ *
+ * Zero-Copy Parsing:
+ * - Lines are located with memchr() inside the mapping or streaming buffer
+ *   and parsed in place; nothing is copied or NUL-terminated
+ * - The SSE2 path converts 16 cells per step; other targets use the scalar loop
+ *
+ * Jigsaw Lines:
+ * - "<81 cells> <81 region digits>" marks a jigsaw puzzle; reader_next()
+ *   sets has_regions and fills regions for such lines (the reader checks
+ *   only the characters; regions_valid() checks the layout)
+ *
+ * Killer Lines:
+ * - "<81 cells> <sum>@<cells>,<sum>@<cells>,..." marks a killer puzzle;
+ *   reader_next() sets has_cages and fills cages (cages_valid() checks
+ *   coverage and sums)
+ *
+ * Offsets:
+ * - line_offset is the byte offset of the line just returned, so callers can
+ *   record exact resume positions
+ * - reader_offset() is where the next line starts; reader_seek() resumes there
+ */
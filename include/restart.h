@@ -0,0 +1,93 @@
+/**
+ * Parallel Restart Generator Module Header File
+ *
+ * This header declares a generator for low clue counts. Reaching 20-24 clues
+ * takes many independent removal passes, each of which either succeeds or
+ * fails on its own, so the passes are raced on all cores: the first thread to
+ * reach the target wins and the others are cancelled.
+ *
+ * Key Responsibilities:
+ * - Run independent generate_puzzle_ex() restarts on several threads
+ * - Give every thread its own seeded random source
+ * - Cancel the remaining threads once one reaches the target
+ * - Stop everything when the time budget runs out and keep the best puzzle
+ * - Report whether the target was reached and how long it took
+ */
+
+#ifndef RESTART_H
+#define RESTART_H
+
+#include "../include/sudoku.h"
+#include "../include/generator.h"
+
+// ============================================================================
+//                              RESTART CONSTANTS
+// ============================================================================
+
+#define RESTART_MAX_THREADS 32          // Upper bound on racing threads
+#define RESTART_DEFAULT_BUDGET 10.0     // Seconds allowed when none is given
+
+// ============================================================================
+//                              RESTART STRUCTURES
+// ============================================================================
+
+typedef struct
+{
+    int target_clues;           // Clue count to reach (17-81)
+    symmetry_t symmetry;        // Clue pattern symmetry to preserve
+    int minimal;                // Flag: keep removing past the target
+    int threads;                // Racing threads (0 = one per online CPU)
+    double budget;              // Seconds before giving up (0 = RESTART_DEFAULT_BUDGET)
+    uint64_t seed;              // Seed for the per-thread random sources
+    generator_method_t method;  // How each restart chooses its clues
+} restart_options_t;
+
+typedef struct
+{
+    int reached;                // Flag: 1 = the target was reached
+    int clues;                  // Clues in the returned puzzle
+    double seconds;             // Time to the winning puzzle, or the whole budget
+    long passes;                // Removal passes over all threads
+    long tests;                 // Uniqueness checks over all threads
+    int threads;                // Threads actually used
+} restart_report_t;
+
+// ============================================================================
+//                              RESTART FUNCTIONS
+// ============================================================================
+
+/**
+ * Generate a puzzle with a target clue count using parallel restarts
+ * Returns the first puzzle that reaches the target; if the budget runs out
+ * first, returns the puzzle with the fewest clues found by any thread
+ *
+ * @param grid 9x9 array to store the puzzle
+ * @param solution 9x9 array to store the complete solution
+ * @param given 9x9 array to mark original clues
+ * @param options Target, symmetry, thread count, time budget and seed
+ * @param report Receives success, clue count, time and work done (may be NULL)
+ * @return 1 if the target was reached, 0 otherwise (the puzzle is still unique)
+ */
+int generate_target_puzzle(int grid[9][9], int solution[9][9], int given[9][9],
+                           const restart_options_t *options, restart_report_t *report);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Practical Targets:
+ * - 28 clues and above: one thread, first pass almost always succeeds
+ * - 23-25 clues: tens to hundreds of passes, well under a second in parallel
+ * - 20-22 clues: thousands of passes or more; set a budget and check
+ *   report.reached before serving the puzzle
+ * - Below 20 clues: rarely reached by random removal at all
+ *
+ * Cancellation:
+ * - Losing threads stop at their next uniqueness check, so the call returns
+ *   within one check of the winner (or of the budget running out)
+ *
+ * Determinism:
+ * - Thread seeds derive from options.seed, but which thread wins depends on
+ *   timing, so equal seeds do not guarantee equal puzzles
+ */
@@ -0,0 +1,68 @@
+/**
+ * Random Number Generator Module Header File
+ *
+ * This header declares a small seedable pseudo-random generator. Unlike rand(),
+ * its sequence is identical on every platform and each caller owns its state,
+ * so seeded puzzles can be regenerated anywhere and threads never share state.
+ *
+ * Key Responsibilities:
+ * - Seed a generator from a 64-bit value
+ * - Produce 64-bit random values (SplitMix64)
+ * - Produce unbiased integers in a range
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                              GENERATOR STATE
+// ============================================================================
+
+typedef struct
+{
+    uint64_t state;             // SplitMix64 counter
+} rng_t;
+
+// ============================================================================
+//                            GENERATOR FUNCTIONS
+// ============================================================================
+
+/**
+ * Seed a generator
+ *
+ * @param rng Generator to seed
+ * @param seed Any 64-bit value; equal seeds give equal sequences
+ */
+void rng_seed(rng_t *rng, uint64_t seed);
+
+/**
+ * Produce the next 64-bit random value
+ *
+ * @param rng Generator state
+ * @return Uniformly distributed 64-bit value
+ */
+uint64_t rng_next(rng_t *rng);
+
+/**
+ * Produce a uniformly distributed integer in [0, bound)
+ *
+ * @param rng Generator state
+ * @param bound Exclusive upper bound (must be positive)
+ * @return Random integer from 0 to bound - 1
+ */
+int rng_below(rng_t *rng, int bound);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Determinism:
+ * - The output depends only on the seed, never on the C library
+ * - Store the seed (not the state) to regenerate a puzzle later
+ *
+ * Threads:
+ * - Give every thread its own rng_t; the functions keep no global state
+ */
@@ -0,0 +1,140 @@
+/**
+ * Samurai Sudoku Module Header File
+ *
+ * This header declares the five-grid Samurai layout: a center grid whose
+ * four corner boxes are also the inner corner boxes of four satellite grids.
+ * The 369 cells form one constraint model (131 units), so a shared cell is a
+ * single variable and every digit placed in a shared box immediately narrows
+ * the candidates of both grids it belongs to. The layout is searched by the
+ * engine of search.h through a 369-cell search topology.
+ *
+ * Key Responsibilities:
+ * - Map the 21x21 layout to 369 cells and list units, cell units and peers
+ * - Describe the layout to the shared search engine and count solutions
+ * - Fill a complete Samurai grid and carve a unique puzzle out of it
+ * - Check placements and completed grids for the game
+ */
+
+#ifndef SAMURAI_H
+#define SAMURAI_H
+
+#include "../include/sudoku.h"
+#include "../include/search.h"
+#include "../include/rng.h"
+
+// ============================================================================
+//                              SAMURAI CONSTANTS
+// ============================================================================
+
+#define SAMURAI_SIZE 21                 // Rows and columns of the layout
+#define SAMURAI_CELLS 369               // Five grids of 81 minus four shared boxes
+#define SAMURAI_GRIDS 5                 // Four satellites around a center grid
+#define SAMURAI_UNITS 131               // 45 rows, 45 columns, 41 distinct boxes
+#define SAMURAI_MAX_CELL_UNITS TOPOLOGY_MAX_CELL_UNITS // Shared cell: two rows, two columns, one box
+#define SAMURAI_MAX_PEERS 32            // Shared cell: 14 row, 14 column and 4 more box peers
+#define SAMURAI_FILL_SEEDS 24           // Random digits placed before a grid fill
+#define SAMURAI_FILL_NODES 20000        // Search budget per fill try before restarting
+#define SAMURAI_CHECK_NODES 20000       // Search budget per clue removal check
+
+// ============================================================================
+//                              SAMURAI TABLES
+// ============================================================================
+
+typedef struct
+{
+    int16_t index[SAMURAI_SIZE][SAMURAI_SIZE];                  // Cell of each square (-1 = hole)
+    uint8_t row[SAMURAI_CELLS];                                 // Layout row of each cell
+    uint8_t col[SAMURAI_CELLS];                                 // Layout column of each cell
+    uint16_t units[SAMURAI_UNITS][GRID_SIZE];                   // Cells of each unit
+    uint8_t cell_unit_count[SAMURAI_CELLS];                     // Units per cell (3 or 5)
+    uint8_t cell_units[SAMURAI_CELLS][SAMURAI_MAX_CELL_UNITS];  // Units of each cell
+    uint8_t peer_count[SAMURAI_CELLS];                          // Peers per cell
+    uint16_t peers[SAMURAI_CELLS][SAMURAI_MAX_PEERS];           // Cells sharing a unit
+    search_topology_t topology;                                 // The tables as seen by search.h
+} samurai_layout_t;
+
+// ============================================================================
+//                              LAYOUT FUNCTIONS
+// ============================================================================
+
+/**
+ * Get the Samurai tables
+ * Built on the first call (thread-safe)
+ *
+ * @return Read-only tables, valid for the life of the program
+ */
+const samurai_layout_t *samurai_layout(void);
+
+/**
+ * Check a digit against every unit of a cell
+ *
+ * @param cells The 369 cells (0 = empty)
+ * @param cell Cell index
+ * @param num Digit to check (1-9)
+ * @return 1 if no peer holds the digit, 0 otherwise
+ */
+int samurai_valid_placement(const int cells[SAMURAI_CELLS], int cell, int num);
+
+// ============================================================================
+//                              SEARCH FUNCTIONS
+// ============================================================================
+
+/**
+ * Count solutions up to a limit
+ *
+ * @param cells The 369 cells (0 = empty), not modified
+ * @param limit Stop once this many solutions are found (0 = no limit)
+ * @param solution Receives the first solution found (may be NULL)
+ * @return Number of solutions found
+ */
+long samurai_count_solutions(const int cells[SAMURAI_CELLS], long limit, int solution[SAMURAI_CELLS]);
+
+// ============================================================================
+//                            GENERATION FUNCTIONS
+// ============================================================================
+
+/**
+ * Fill all 369 cells with a random valid Samurai grid
+ * A few random digits are scattered and the search completes the layout
+ * under a node budget, restarting with new digits when it stalls
+ *
+ * @param solution Receives the complete grid
+ * @param rng Seeded random source (NULL = rand())
+ */
+void samurai_fill(int solution[SAMURAI_CELLS], rng_t *rng);
+
+/**
+ * Generate a Samurai puzzle with a unique solution
+ * Removes clues in random order, keeping each one whose removal admits a
+ * second solution (or whose check runs out of budget), until the clue
+ * target of the difficulty is reached
+ *
+ * @param puzzle Receives the puzzle (0 = empty)
+ * @param solution Receives the complete solution
+ * @param difficulty Level selecting the clue target
+ * @param rng Seeded random source (NULL = rand())
+ * @return Number of clues in the puzzle
+ */
+int samurai_generate(int puzzle[SAMURAI_CELLS], int solution[SAMURAI_CELLS],
+                     difficulty_t difficulty, rng_t *rng);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Layout:
+ * - Grids start at layout squares (0,0), (0,12), (6,6), (12,0) and (12,12);
+ *   squares outside every grid are holes with index -1
+ * - Cells are numbered row by row over the layout, skipping holes; the
+ *   text form of a puzzle is the 369 digits in that order
+ *
+ * Shared Boxes:
+ * - Each of the four shared boxes is one unit, listed once; its cells
+ *   carry the row and column units of both grids they belong to
+ *
+ * Searching:
+ * - search_init_cells(search, &samurai_layout()->topology, cells) prepares a
+ *   search_t over the 369 cells; search_run(), search_forbid() and the node
+ *   budgets then work exactly as for an 81-cell grid
+ */
@@ -0,0 +1,262 @@
+/**
+ * Search Engine Module Header File
+ *
+ * This header declares the iterative backtracking engine shared by the solver,
+ * the enumerator and other tools that need more control than solve_grid().
+ * The engine keeps its whole search stack inside a fixed-size structure, uses
+ * bitmask candidate sets and can be paused after any number of nodes and
+ * resumed later, or cancelled from another thread. The cells and units come
+ * from a search topology, so the same engine searches the 81-cell variants
+ * and the 369-cell Samurai layout.
+ *
+ * Key Responsibilities:
+ * - Track used digits per unit (row, column, box, variant extras) as 9-bit masks
+ * - Limit killer cage cells to the digits of the cage's still-possible sums
+ * - Branch on the empty cell with the fewest candidates
+ * - Report each solution and continue to the next one on demand
+ * - Honor node budgets and cancellation flags between nodes
+ * - Hand off untried branches of a paused search to another search
+ * - Classify a grid as having 0, 1 or 2+ solutions under one node budget
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+#include "../include/killer.h"
+
+// ============================================================================
+//                              SEARCH CONSTANTS
+// ============================================================================
+
+#define SEARCH_CELLS 81                 // Cells in a classic grid
+#define SEARCH_MAX_CELLS 369            // Largest layout searched (Samurai)
+#define SEARCH_MAX_UNITS 131            // Units of the largest layout (Samurai)
+#define ALL_DIGITS 0x1FF                // Candidate mask with digits 1-9 set
+
+// ============================================================================
+//                              SEARCH STRUCTURES
+// ============================================================================
+
+typedef enum
+{
+    SEARCH_RUNNING = 0,         // Budget used up; call search_run() again to continue
+    SEARCH_FOUND,               // A solution is available via search_get_grid()
+    SEARCH_EXHAUSTED,           // No further solutions exist
+    SEARCH_CANCELLED            // Stopped by the cancel flag; may be resumed
+} search_status_t;
+
+typedef enum
+{
+    SEARCH_COUNT_INVALID = 0,   // The givens already clash
+    SEARCH_COUNT_NONE,          // No solution
+    SEARCH_COUNT_UNIQUE,        // Exactly one solution
+    SEARCH_COUNT_MULTIPLE,      // Two or more solutions
+    SEARCH_COUNT_UNDECIDED,     // Node budget ran out before the count settled
+    SEARCH_COUNT_CANCELLED      // Stopped by the cancel flag
+} search_count_t;
+
+typedef struct
+{
+    int cell_count;                                         // Cells in the layout
+    const uint8_t *cell_unit_count;                         // Units per cell
+    const uint8_t (*cell_units)[TOPOLOGY_MAX_CELL_UNITS];   // Units of each cell, row, column and box first
+    const topology_t *cages;                                // 81-cell tables with killer cages (NULL = none)
+} search_topology_t;
+
+typedef struct
+{
+    uint16_t cell;              // Cell branched on at this depth (row * 9 + col)
+    uint8_t value;              // Digit currently placed (0 = none)
+    uint16_t remaining;         // Candidates not tried yet (bit n-1 = digit n)
+} search_frame_t;
+
+typedef struct
+{
+    uint8_t values[SEARCH_MAX_CELLS];       // Current assignment (0 = empty)
+    uint16_t forbidden[SEARCH_MAX_CELLS];   // Digits excluded per cell (search_forbid)
+    uint16_t last[SEARCH_MAX_CELLS];        // Digit tried last per cell (search_prefer_last)
+    uint16_t unit_used[SEARCH_MAX_UNITS];   // Digits used per unit (row, column, box, extras)
+    search_topology_t topology;             // Cells and units of the layout being solved
+
+    const combination_table_t *combinations;        // Cage digit sets (NULL = no cages)
+    uint16_t cage_used[TOPOLOGY_MAX_CAGES];         // Digits placed per killer cage
+    uint16_t cage_allowed[TOPOLOGY_MAX_CAGES];      // Digits that can still complete each cage
+    uint16_t cage_live[TOPOLOGY_MAX_CAGES];         // cage_allowed narrowed by cell candidates
+    uint8_t cage_sum[TOPOLOGY_MAX_CAGES];           // Sum the empty cells of each cage must make
+    uint8_t cage_empty[TOPOLOGY_MAX_CAGES];         // Empty cells per cage
+
+    uint16_t empty[SEARCH_MAX_CELLS];       // Initially empty cells; [0, depth) are on the stack
+    int empty_count;                        // Number of initially empty cells
+
+    search_frame_t stack[SEARCH_MAX_CELLS]; // One frame per assigned empty cell
+    int depth;                              // Frames in use
+    int selecting;                          // Flag: 1 = pick next cell, 0 = try next digit
+
+    search_status_t status;                 // Result of the last search_run()
+    uint64_t nodes;                         // Digits placed so far
+} search_t;
+
+// ============================================================================
+//                              SEARCH FUNCTIONS
+// ============================================================================
+
+/**
+ * Describe the cells and units of an 81-cell variant to the engine
+ *
+ * @param topology Unit tables of the variant (killer cages included)
+ * @param layout Receives the search topology; it points into the tables
+ */
+void search_topology_of(const topology_t *topology, search_topology_t *layout);
+
+/**
+ * Prepare a search over a puzzle under the active variant
+ *
+ * @param search Search state to initialize
+ * @param grid 9x9 puzzle (0 = empty cell), not modified
+ * @return 1 if ready, 0 if the givens already conflict (status EXHAUSTED)
+ */
+int search_init(search_t *search, int grid[9][9]);
+
+/**
+ * Prepare a search over the cells of any layout
+ *
+ * @param search Search state to initialize
+ * @param layout Cells and units to search (at most SEARCH_MAX_CELLS cells)
+ * @param cells One digit per cell of the layout (0 = empty), not modified
+ * @return 1 if ready, 0 if the givens already conflict (status EXHAUSTED)
+ */
+int search_init_cells(search_t *search, const search_topology_t *layout, const int *cells);
+
+/**
+ * Run the search until the next solution, exhaustion, budget or cancellation
+ * After SEARCH_FOUND, calling again continues with the next solution
+ *
+ * @param search Initialized search state
+ * @param max_nodes Maximum digits to place in this call (0 = no limit)
+ * @param cancel Optional flag; the search stops when it becomes non-zero
+ * @return New search status
+ */
+search_status_t search_run(search_t *search, uint64_t max_nodes, const volatile int *cancel);
+
+/**
+ * Exclude a digit from an empty cell for the rest of the search
+ * Call after search_init() and before the first search_run()
+ *
+ * @param search Search state
+ * @param cell Cell index (row * 9 + col in an 81-cell grid)
+ * @param value Digit to exclude (1-9)
+ */
+void search_forbid(search_t *search, int cell, int value);
+
+/**
+ * Turn a given cell back into an empty cell to be searched
+ * Lets one initialized search be copied and reused to test each clue of a
+ * puzzle without re-reading the grid
+ * Call after search_init() and before the first search_run()
+ *
+ * @param search Search state
+ * @param cell Cell index of a given (non-zero) cell
+ */
+void search_release(search_t *search, int cell);
+
+/**
+ * Try the digits of a known grid last in every cell
+ * With this ordering the known solution is the last solution the search can
+ * reach, so if it is also the first one found, it is the only one
+ * Call after search_init() and before the first search_run()
+ *
+ * @param search Search state
+ * @param known 9x9 grid of digits to defer (0 = no preference)
+ */
+void search_prefer_last(search_t *search, int known[9][9]);
+
+/**
+ * Copy the current assignment into a grid
+ * After SEARCH_FOUND this is the complete solution; otherwise it is the
+ * partial assignment the search is currently exploring
+ *
+ * @param search Search state over an 81-cell grid
+ * @param grid 9x9 array that receives the assignment
+ */
+void search_get_grid(const search_t *search, int grid[9][9]);
+
+/**
+ * Copy the current assignment of any layout into a cell array
+ *
+ * @param search Search state
+ * @param cells Receives one digit per cell of the layout
+ */
+void search_get_cells(const search_t *search, int *cells);
+
+/**
+ * Give away the untried digits of the shallowest branch point
+ * Lets a parallel search share a running subtree: the digits handed off are
+ * no longer tried by this search, which continues with the rest.
+ * Call only while the search is paused (RUNNING or FOUND)
+ *
+ * @param search Paused search state
+ * @param max_depth Only frames shallower than this are considered
+ * @param cells Receives the assignment above the branch point (one digit per cell)
+ * @param cell Receives the cell of the branch point
+ * @param digits Receives the digits handed off (bit n-1 = digit n)
+ * @return Frames above the branch point, or -1 if there is nothing to give
+ */
+int search_hand_off(search_t *search, int max_depth, int *cells, int *cell, uint16_t *digits);
+
+/**
+ * Count the solutions of a grid up to two under one node budget
+ * The uniqueness test of the editor and the corpus analyzer; the search for
+ * the second solution resumes the first, so both share the budget.
+ * search->nodes holds the digits placed afterwards
+ *
+ * @param search Search state to use (initialized by the call)
+ * @param grid 9x9 puzzle under the active variant, not modified
+ * @param budget Most digits to place in total
+ * @param cancel Optional flag; the count stops when it becomes non-zero
+ * @param solution Receives the first solution found (may be NULL)
+ * @return How many solutions the grid has, or why the count stopped
+ */
+search_count_t search_count_to_two(search_t *search, int grid[9][9], uint64_t budget,
+                                   const volatile int *cancel, int solution[9][9]);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Memory:
+ * - search_t is a fixed ~6 KB (sized for the 369-cell Samurai layout)
+ *   regardless of how many solutions are visited; there is no recursion and
+ *   no allocation. Keep it off small thread stacks
+ *
+ * Layouts:
+ * - search_init() searches the active 81-cell variant; any other layout
+ *   supplies a search_topology_t listing the units of each cell and calls
+ *   search_init_cells(). Unit indices must stay below SEARCH_MAX_UNITS
+ *
+ * Budgets:
+ * - search_run(search, 1000, NULL) returns SEARCH_RUNNING after 1000 nodes,
+ *   leaving the search paused at a consistent point
+ *
+ * Reusing a Known Solution:
+ * - search_forbid() turns "is there a solution with a different value here?"
+ *   into a single search that usually fails quickly
+ * - search_prefer_last() orders every branch so the known solution is visited
+ *   last; the first solution found differs from it unless the grid is unique
+ *
+ * Killer Cages:
+ * - Each placement in a cage recomputes the cage's allowed digits from the
+ *   combination tables (killer.h), so a cell only gets digits that belong to
+ *   a digit set with the right size and sum avoiding the digits already placed
+ *
+ * Sharing Work:
+ * - search_hand_off() takes the shallowest untried digits because they root
+ *   the largest subtrees; each becomes a grid of its own (cells plus that
+ *   digit) that another search covers in full
+ *
+ * Cancellation:
+ * - The cancel flag is polled before every node, so another thread (or a
+ *   signal handler) can stop a long enumeration promptly
+ */
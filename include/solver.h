@@ -11,6 +11,7 @@
  * - Analyze puzzle properties (uniqueness, completeness, validity)
  * - Support puzzle generation by ensuring quality constraints
  * - Provide utility functions for grid analysis
+ * - Rate puzzles by the techniques and search effort they need
  */
 
 #ifndef SOLVER_H
@@ -18,6 +19,13 @@
 
 #include "../include/sudoku.h"
 
+// ============================================================================
+//                             RATING CONSTANTS
+// ============================================================================
+
+#define RATING_SEARCH_NODES 1000000     // Search budget when singles get stuck
+#define RATING_HARD_NODES 100           // Most guesses a "hard" rating allows
+
 // ============================================================================
 //                          CORE SOLVING FUNCTIONS
 // ============================================================================
@@ -56,6 +64,7 @@ int find_empty_cell(int grid[9][9], int *row, int *col);
  * - No duplicate in same row
  * - No duplicate in same column  
  * - No duplicate in same 3x3 box
+ * plus the extra units of the active variant (see topology.h)
  * 
  * @param grid 9x9 Sudoku grid to check against
  * @param row Target row position (0-8)
@@ -110,6 +119,143 @@ int has_unique_solution(int grid[9][9]);
  */
 int count_solutions(int grid[9][9]);
 
+// ============================================================================
+//                      UNIQUENESS WITH A KNOWN SOLUTION
+// ============================================================================
+// Faster checks for generation, where the full solution is already known
+
+/**
+ * Look for a solution that differs from a known one
+ * Branches on the known digit last everywhere, so the known solution is the
+ * last one reachable; a single search either finds a different solution or
+ * proves there is none
+ *
+ * @param grid 9x9 puzzle to analyze (not modified)
+ * @param solution 9x9 known solution of the puzzle
+ * @param other 9x9 array that receives the different solution (may be NULL)
+ * @return 1 if a different solution exists, 0 if the puzzle is unique
+ */
+int find_other_solution(int grid[9][9], int solution[9][9], int other[9][9]);
+
+/**
+ * Look for a different solution within a node budget
+ * Sparse clue patterns can take long to decide; callers that can afford to
+ * add a clue instead of waiting use this to cap the work per check
+ *
+ * @param grid 9x9 puzzle to analyze (not modified)
+ * @param solution 9x9 known solution of the puzzle
+ * @param other 9x9 array that receives the different solution (may be NULL)
+ * @param max_nodes Search budget in placed digits (0 = no limit)
+ * @return 1 if a different solution exists, 0 if unique, -1 if the budget ran out
+ */
+int find_other_solution_limited(int grid[9][9], int solution[9][9], int other[9][9],
+                                uint64_t max_nodes);
+
+/**
+ * Check uniqueness after emptying one cell of a unique puzzle
+ * Any new solution must differ at the emptied cell, so the known digit is
+ * forbidden there and one (usually failing) search decides the question
+ *
+ * @param grid 9x9 puzzle with grid[row][col] already set to 0 (not modified)
+ * @param solution 9x9 known solution; grid plus this cell must be unique
+ * @param row Row of the emptied cell (0-8)
+ * @param col Column of the emptied cell (0-8)
+ * @return 1 if the puzzle is still unique, 0 otherwise
+ */
+int is_unique_without_cell(int grid[9][9], int solution[9][9], int row, int col);
+
+/**
+ * Check uniqueness after emptying a group of cells of a unique puzzle
+ * Any new solution differs from the known one in at least one emptied cell;
+ * one forbid-the-known-digit search per cell covers each case exactly once,
+ * with the earlier cells kept as clues so later searches are smaller
+ *
+ * @param grid 9x9 puzzle with the cells already set to 0 (not modified)
+ * @param solution 9x9 known solution; grid plus these cells must be unique
+ * @param cells Emptied cell indices (row * 9 + col)
+ * @param count Number of emptied cells
+ * @return 1 if the puzzle is still unique, 0 otherwise
+ */
+int is_unique_without_cells(int grid[9][9], int solution[9][9], const int *cells, int count);
+
+/**
+ * Find the clues that could be removed without losing uniqueness
+ * All clues are checked against one shared, pre-initialized search state:
+ * each check copies it, releases one clue and forbids that clue's digit, so
+ * every clue costs a single (usually failing) search
+ *
+ * @param grid 9x9 unique puzzle (not modified)
+ * @param solution 9x9 solution of the puzzle
+ * @param redundant 9x9 array set to 1 for removable clues, 0 elsewhere (may be NULL)
+ * @return Number of redundant clues (0 = the puzzle is minimal)
+ */
+int find_redundant_clues(int grid[9][9], int solution[9][9], int redundant[9][9]);
+
+/**
+ * Check that every clue of a unique puzzle is necessary
+ * Same checks as find_redundant_clues(), stopping at the first removable clue
+ *
+ * @param grid 9x9 unique puzzle (not modified)
+ * @param solution 9x9 solution of the puzzle
+ * @return 1 if removing any clue breaks uniqueness, 0 otherwise
+ */
+int is_minimal_puzzle(int grid[9][9], int solution[9][9]);
+
+// ============================================================================
+//                          SOLUTION ENUMERATION
+// ============================================================================
+// Streaming access to every solution of an under-constrained grid
+
+/**
+ * Callback invoked once per solution by enumerate_solutions()
+ *
+ * @param solution Complete 9x9 solution (valid only during the call)
+ * @param user_data Pointer passed through from enumerate_solutions()
+ * @return Non-zero to continue enumerating, 0 to stop
+ */
+typedef int (*solution_callback_t)(int solution[9][9], void *user_data);
+
+/**
+ * Enumerate the solutions of a grid, invoking a callback for each one
+ * Runs on the fixed-size iterative search engine, so memory use stays
+ * constant no matter how many solutions are visited
+ *
+ * @param grid 9x9 Sudoku grid to analyze (not modified)
+ * @param limit Maximum solutions to visit (0 or negative = no limit)
+ * @param callback Function called per solution (may be NULL to just count)
+ * @param user_data Pointer passed to the callback
+ * @param cancel Optional flag; enumeration stops when it becomes non-zero
+ * @return Number of solutions visited
+ */
+long enumerate_solutions(int grid[9][9], long limit, solution_callback_t callback,
+                         void *user_data, const volatile int *cancel);
+
+/**
+ * Count solutions up to a limit
+ * Unlike count_solutions(), which stops at 2, the limit is chosen by the caller
+ *
+ * @param grid 9x9 Sudoku grid to analyze (not modified)
+ * @param limit Stop counting once this many solutions are found (0 = no limit)
+ * @return Number of solutions found, at most limit
+ */
+long count_solutions_limit(int grid[9][9], long limit);
+
+// ============================================================================
+//                              PUZZLE RATING
+// ============================================================================
+
+/**
+ * Rate a puzzle by what it takes to solve
+ * Naked singles alone rate easy, naked and hidden singles medium; when
+ * singles get stuck the search engine finishes the grid, rating hard if it
+ * places at most RATING_HARD_NODES digits and expert otherwise
+ *
+ * @param grid 9x9 puzzle with a unique solution (not modified)
+ * @param search_nodes Receives the digits the search placed (may be NULL)
+ * @return Rating on the generator's difficulty scale
+ */
+difficulty_t rate_puzzle(int grid[9][9], uint64_t *search_nodes);
+
 #endif
 
 /**
@@ -124,10 +270,11 @@ int count_solutions(int grid[9][9]);
  * - solve_grid(): O(9^(empty_cells)) worst case, much faster in practice
  * - has_unique_solution(): More expensive as it must check all possibilities
  * - count_solutions(): Most expensive, only use when necessary
+ * - enumerate_solutions(): constant memory, cost proportional to solutions visited
  * 
  * Integration with Other Modules:
  * - Generator uses solve_grid() to create complete grids
- * - Generator uses has_unique_solution() to validate puzzle quality
+ * - Generator uses is_unique_without_cells() to validate each removal
  * - Game module uses is_valid_placement() for move validation
  * - Display module can use these for highlighting invalid moves
  * 
@@ -135,7 +282,10 @@ int count_solutions(int grid[9][9]);
  * - Row constraint: no duplicates in same horizontal line
  * - Column constraint: no duplicates in same vertical line
  * - Box constraint: no duplicates in same 3x3 subgrid
- * - All three constraints must be satisfied simultaneously
+ * - Variant constraints: no duplicates on a diagonal (X) or in a window (Windoku)
+ * - Killer cages: no duplicates in a cage, and its digits add up to its sum
+ * - All units must be satisfied simultaneously; the checks walk the
+ *   precomputed peer and unit tables of topology.h
  * 
  * Grid State Analysis:
  * - is_grid_valid(): checks rules compliance (allows empty cells)
@@ -7,7 +7,8 @@
  * 
  * Key Components:
  * - Game constants (grid size, box size)
- * - Difficulty enumeration
+ * - Difficulty and variant enumerations
+ * - Branch journal records for what-if exploration
  * - Complete game state structure
  * - Standard library includes for all modules
  */
@@ -50,6 +51,58 @@ typedef enum
     EXPERT                      // Hardest difficulty - minimal clues
 } difficulty_t;
 
+// ============================================================================
+//                             VARIANT ENUMERATION
+// ============================================================================
+// Rule sets; each adds units to the classic rows, columns and boxes
+
+typedef enum
+{
+    VARIANT_CLASSIC = 0,        // Rows, columns and 3x3 boxes
+    VARIANT_X,                  // Plus both main diagonals
+    VARIANT_WINDOKU,            // Plus four extra 3x3 windows
+    VARIANT_JIGSAW,             // Boxes replaced by irregular connected regions
+    VARIANT_KILLER,             // Plus cages with digit sums, usually no givens
+    VARIANT_SAMURAI,            // Five overlapping classic grids (see samurai.h)
+    VARIANT_COUNT               // Number of variants
+} variant_t;
+
+// ============================================================================
+//                              BRANCH JOURNAL
+// ============================================================================
+// Undo records that let a game branch and roll back (see branch.h)
+
+typedef struct
+{
+    uint8_t cell;               // Cell index (row * 9 + col)
+    uint8_t value;              // Number in the cell before the change
+    uint16_t marks;             // Pencil marks before the change (bit n-1 = mark n)
+} journal_entry_t;
+
+typedef struct
+{
+    int length;                 // Journal entries made before the branch opened
+    int cursor_row, cursor_col; // Cursor position
+    int show_marks;             // Mark mode flag
+    int moves;                  // Move counter
+    int is_completed;           // Completion flag
+    int is_paused;              // Timer pause flag
+    time_t start_time;          // Timer fields as they were
+    time_t pause_time;
+    time_t completion_time;
+    time_t opened_at;           // Wall time when the branch opened
+} branch_point_t;
+
+typedef struct
+{
+    journal_entry_t *entries;   // Cell changes made inside open branches, oldest first
+    int length;                 // Entries in use
+    int capacity;               // Entries allocated
+    branch_point_t *points;     // Open branches, outermost first
+    int depth;                  // Branches open (0 = none, nothing is recorded)
+    int point_capacity;         // Branch points allocated
+} branch_journal_t;
+
 // ============================================================================
 //                           MAIN GAME STATE STRUCTURE
 // ============================================================================
@@ -65,6 +118,7 @@ typedef struct
     int solution[GRID_SIZE][GRID_SIZE];          // Complete solution to the puzzle
     int given[GRID_SIZE][GRID_SIZE];             // Marks which cells are original clues (1) vs player-filled (0)
     int marks[GRID_SIZE][GRID_SIZE][GRID_SIZE];  // Pencil marks: [row][col][number-1] = 1 if marked
+    int has_solution;                            // Flag: 1 = solution[][] holds the answer
     
     // ========================================================================
     //                            DISPLAY STATE
@@ -78,6 +132,7 @@ typedef struct
     // ========================================================================
     
     difficulty_t difficulty;                     // Current puzzle difficulty level
+    variant_t variant;                           // Rule set of the current puzzle
     int moves;                                   // Count of player moves (for statistics)
     
     // ========================================================================
@@ -94,6 +149,12 @@ typedef struct
     
     int is_paused;                               // Flag: 1 = game paused, 0 = running
     int is_completed;                            // Flag: 1 = puzzle solved, 0 = in progress
+
+    // ========================================================================
+    //                            BRANCH JOURNAL
+    // ========================================================================
+
+    branch_journal_t journal;                    // Undo records of open what-if branches
     
 } game_state_t;
 
@@ -119,4 +180,8 @@ typedef struct
  * - pause_time: absolute time when pause started (only valid if is_paused = 1)
  * - completion_time: absolute time when puzzle was solved
  * - Elapsed time = current_time - start_time (adjusted for pause duration)
+ *
+ * Branch Journal:
+ * - Only cell changes are journaled; the small scalar fields are saved in
+ *   the branch point, so opening a branch never copies the grids
  */
\ No newline at end of file
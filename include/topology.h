@@ -0,0 +1,263 @@
+/**
+ * Unit Topology Module Header File
+ *
+ * This header declares the unit tables that describe which cells must hold
+ * different digits. Every rule check in the program (placement validation,
+ * grid validation, hints, conflict highlighting and the search engine) walks
+ * these tables instead of hard-coding rows, columns and boxes, so variants
+ * only add units. The tables are built once, so a placement check visits the
+ * 20 precomputed peers of a cell instead of scanning 27 cells.
+ *
+ * Key Responsibilities:
+ * - List the units (rows, columns, boxes and variant extras) as cell indices
+ * - List the units containing each cell
+ * - List the peers of each cell (cells sharing at least one unit)
+ * - Track the variant used by the game and the batch tools
+ * - Replace the boxes with jigsaw regions from a region map
+ * - Hold killer cages (cells and sums) and add cage mates to the peers
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include "../include/sudoku.h"
+
+// ============================================================================
+//                            TOPOLOGY CONSTANTS
+// ============================================================================
+
+#define TOPOLOGY_CELLS 81               // Cells in the grid
+#define TOPOLOGY_BOX_UNITS 18           // First box (or jigsaw region) unit
+#define TOPOLOGY_CLASSIC_UNITS 27       // 9 rows, 9 columns, 9 boxes
+#define TOPOLOGY_MAX_UNITS 31           // Classic units plus up to 4 extras
+#define TOPOLOGY_MAX_CELL_UNITS 5       // Centre cell of X-Sudoku: row, column, box, 2 diagonals
+#define TOPOLOGY_MAX_PEERS 32           // Centre cell of X-Sudoku has the most peers
+#define TOPOLOGY_MAX_CAGES 81           // Killer cages (one per cell at most)
+
+// ============================================================================
+//                             TOPOLOGY TABLES
+// ============================================================================
+
+typedef enum
+{
+    UNIT_ROW = 0,               // Units 0-8
+    UNIT_COLUMN,                // Units 9-17
+    UNIT_BOX,                   // Units 18-26 (jigsaw regions in VARIANT_JIGSAW)
+    UNIT_DIAGONAL,              // X-Sudoku diagonals
+    UNIT_WINDOW                 // Windoku windows
+} unit_kind_t;
+
+typedef struct
+{
+    uint8_t sum;                // Total of the cage's digits
+    uint8_t size;               // Cells in the cage (1-9)
+    uint8_t cells[GRID_SIZE];   // Cell indices; digits in a cage never repeat
+} cage_t;
+
+typedef struct
+{
+    int count;                              // Cages in use
+    cage_t cages[TOPOLOGY_MAX_CAGES];       // Cages covering every cell once
+} cage_layout_t;
+
+typedef struct
+{
+    variant_t variant;                                          // Rule set described
+    const char *name;                                           // Display name
+    int unit_count;                                             // Units in use
+    uint8_t units[TOPOLOGY_MAX_UNITS][GRID_SIZE];               // Cells of each unit
+    unit_kind_t kinds[TOPOLOGY_MAX_UNITS];                      // What each unit is
+    uint8_t cell_unit_count[TOPOLOGY_CELLS];                    // Units per cell
+    uint8_t cell_units[TOPOLOGY_CELLS][TOPOLOGY_MAX_CELL_UNITS]; // Row, column, box first
+    uint8_t peer_count[TOPOLOGY_CELLS];                         // Peers per cell
+    uint8_t peers[TOPOLOGY_CELLS][TOPOLOGY_MAX_PEERS];          // Cells sharing a unit or cage
+    int cage_count;                                             // Killer cages (0 = none)
+    cage_t cages[TOPOLOGY_MAX_CAGES];                           // Killer cages
+    int8_t cage_of[TOPOLOGY_CELLS];                             // Cage of each cell (-1 = none)
+} topology_t;
+
+// ============================================================================
+//                            TOPOLOGY FUNCTIONS
+// ============================================================================
+
+/**
+ * Get the unit tables of a variant
+ * The tables of all variants are built on the first call (thread-safe)
+ *
+ * @param variant Rule set
+ * @return Read-only tables, valid for the life of the program
+ */
+const topology_t *get_topology(variant_t variant);
+
+/**
+ * Get the tables of the active variant
+ * Used by every rule check that takes no explicit topology
+ *
+ * @return Tables of the variant last passed to set_current_variant()
+ */
+const topology_t *current_topology(void);
+
+/**
+ * Select the variant used by the rule checks, solver and generator
+ * Call before starting threads that generate or solve puzzles
+ *
+ * @param variant Rule set to activate
+ */
+void set_current_variant(variant_t variant);
+
+/**
+ * Parse a variant name
+ *
+ * @param name "classic", "x", "windoku", "jigsaw", "killer" or "samurai"
+ * @param variant Receives the parsed variant
+ * @return 1 if recognized, 0 otherwise
+ */
+int parse_variant(const char *name, variant_t *variant);
+
+/**
+ * Check whether a cell belongs to a variant's extra units
+ *
+ * @param topology Unit tables
+ * @param cell Cell index (row * 9 + col)
+ * @return 1 if the cell is on a diagonal or in a window, 0 otherwise
+ */
+int in_extra_unit(const topology_t *topology, int cell);
+
+/**
+ * Box (or jigsaw region) containing a cell
+ *
+ * @param topology Unit tables
+ * @param cell Cell index (row * 9 + col)
+ * @return Region 0-8
+ */
+static inline int region_of(const topology_t *topology, int cell)
+{
+    return topology->cell_units[cell][2] - TOPOLOGY_BOX_UNITS;
+}
+
+/**
+ * Copy the box or jigsaw region of every cell into a region map
+ *
+ * @param topology Unit tables
+ * @param regions Receives the region (0-8) of each cell
+ */
+void topology_regions(const topology_t *topology, uint8_t regions[TOPOLOGY_CELLS]);
+
+// ============================================================================
+//                              JIGSAW REGIONS
+// ============================================================================
+
+/**
+ * Check whether the cells of one region form a single orthogonal group
+ *
+ * @param regions Region (0-8) of each cell
+ * @param region Region to check
+ * @return 1 if connected, 0 if split or empty
+ */
+int region_connected(const uint8_t regions[TOPOLOGY_CELLS], int region);
+
+/**
+ * Check that a region map splits the grid into nine connected regions of nine
+ *
+ * @param regions Region (0-8) of each cell
+ * @return 1 if usable as a jigsaw layout, 0 otherwise
+ */
+int regions_valid(const uint8_t regions[TOPOLOGY_CELLS]);
+
+/**
+ * Build jigsaw tables for a region map into caller-owned storage
+ *
+ * @param topology Tables to fill
+ * @param regions Valid region map (see regions_valid())
+ */
+void build_region_topology(topology_t *topology, const uint8_t regions[TOPOLOGY_CELLS]);
+
+/**
+ * Install a jigsaw layout and make jigsaw the active variant
+ * Rebuilds the shared jigsaw tables, so call only while no worker threads run
+ *
+ * @param regions Valid region map
+ */
+void set_current_regions(const uint8_t regions[TOPOLOGY_CELLS]);
+
+/**
+ * Make the calling thread use its own tables instead of the active variant
+ * Lets worker threads solve puzzles with different jigsaw layouts at once
+ *
+ * @param topology Tables for this thread (NULL = follow the active variant)
+ * @return The thread's previous tables (NULL = it followed the active variant)
+ */
+const topology_t *use_thread_topology(const topology_t *topology);
+
+// ============================================================================
+//                              KILLER CAGES
+// ============================================================================
+
+/**
+ * Check that cages cover every cell once and that every sum is reachable
+ *
+ * @param cages Killer cages
+ * @return 1 if usable as a killer layout, 0 otherwise
+ */
+int cages_valid(const cage_layout_t *cages);
+
+/**
+ * Build killer tables for a cage layout into caller-owned storage
+ * Rows, columns and boxes are classic; cage mates are added to the peers
+ *
+ * @param topology Tables to fill
+ * @param cages Valid cage layout (see cages_valid())
+ */
+void build_cage_topology(topology_t *topology, const cage_layout_t *cages);
+
+/**
+ * Install a killer cage layout and make killer the active variant
+ * Rebuilds the shared killer tables, so call only while no worker threads run
+ *
+ * @param cages Valid cage layout
+ */
+void set_current_cages(const cage_layout_t *cages);
+
+/**
+ * Check a digit against the sum of the cell's killer cage
+ * Repeats inside the cage are caught by the peer list; this checks the sum
+ *
+ * @param topology Unit tables
+ * @param cells The 81 cells of the grid (0 = empty)
+ * @param cell Cell index (row * 9 + col)
+ * @param num Digit to check (1-9)
+ * @return 1 if the cage sum still works out (or the cell has no cage), 0 otherwise
+ */
+int cage_sum_allows(const topology_t *topology, const int *cells, int cell, int num);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Unit Order:
+ * - Units 0-26 are always rows, columns and boxes in that order, and
+ *   cell_units[cell][0..2] are always the cell's row, column and box, so
+ *   classic code paths can index them directly
+ * - Extra units start at TOPOLOGY_CLASSIC_UNITS
+ *
+ * Variants:
+ * - X-Sudoku: the two main diagonals also hold 1-9
+ * - Windoku: the four 3x3 windows with top-left corners (1,1), (1,5),
+ *   (5,1) and (5,5) also hold 1-9
+ * - Jigsaw: the boxes are replaced by nine connected regions of nine cells
+ *   read from a region map; each puzzle carries its own map
+ * - Killer: classic units plus cages whose digits differ and add up to the
+ *   cage sum; each puzzle carries its own cages (see killer.h)
+ * - Samurai: classic tables for each of five overlapping grids; the
+ *   369-cell layout is in samurai.h and is searched by search.h
+ *
+ * Threads:
+ * - The built-in tables are immutable after the first get_topology() call
+ *   (except the jigsaw and killer entries, rebuilt by set_current_regions()
+ *   and set_current_cages()); the active variant is a plain global, so
+ *   change it only while no worker threads run
+ * - Threads that need a different layout build their own tables with
+ *   build_region_topology() or build_cage_topology() and select them with
+ *   use_thread_topology()
+ */
@@ -0,0 +1,182 @@
+/**
+ * Result Writer Module Header File
+ *
+ * This header declares the output stage used by the batch tools. Worker threads
+ * format results into their own large buffers; the writer emits completed
+ * buffers strictly in sequence-number order, batching as many as are ready into
+ * a single writev() call.
+ *
+ * Key Responsibilities:
+ * - Format grids as 82-byte text lines or 41-byte packed binary records
+ * - Preserve input order across threads using per-buffer sequence numbers
+ * - Emit ready buffers with writev(), handling partial writes
+ * - Let workers reuse a buffer only after its contents have been written
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+#include <pthread.h>
+
+// ============================================================================
+//                              WRITER CONSTANTS
+// ============================================================================
+
+#define WRITER_WINDOW 64                // Maximum buffers queued out of order
+#define WRITER_BUFFER_SIZE (1 << 20)    // Default per-buffer capacity (1 MiB)
+#define TEXT_RECORD_SIZE 82             // 81 digits + newline
+#define BINARY_RECORD_SIZE 41           // 81 cells packed two per byte
+#define CAGE_RECORD_MAX 488             // Longest text cage list (81 cages) + newline
+#define CAGE_BINARY_SIZE 162            // Cage number per cell + sum per cage
+
+// ============================================================================
+//                              WRITER STRUCTURES
+// ============================================================================
+
+typedef enum
+{
+    WRITER_TEXT = 0,            // One line of 81 digits per grid
+    WRITER_BINARY               // 41 bytes per grid, high nibble first
+} writer_format_t;
+
+typedef struct
+{
+    char *data;                 // Formatted output bytes
+    size_t length;              // Bytes used
+    size_t capacity;            // Bytes allocated
+    long seq;                   // Sequence number assigned on submit
+    int pending;                // Flag: 1 = queued and not yet written
+} writer_buffer_t;
+
+typedef struct
+{
+    int fd;                                 // Destination file descriptor
+    writer_format_t format;                 // Record format for writer_append_grid()
+    pthread_mutex_t lock;                   // Protects everything below
+    pthread_cond_t flushed;                 // Signalled whenever buffers are written
+    long next_seq;                          // Next sequence number to emit
+    writer_buffer_t *slots[WRITER_WINDOW];  // Submitted buffers indexed by seq % window
+    uint64_t bytes_written;                 // Total bytes emitted so far
+    int error;                              // Flag: 1 = a write failed
+} writer_t;
+
+// ============================================================================
+//                              WRITER FUNCTIONS
+// ============================================================================
+
+/**
+ * Initialize a writer for a file descriptor
+ *
+ * @param writer Writer to initialize
+ * @param fd Destination file descriptor (not closed by the writer)
+ * @param format Record format
+ * @return 1 on success, 0 on failure
+ */
+int writer_init(writer_t *writer, int fd, writer_format_t format);
+
+/**
+ * Release writer synchronization objects
+ *
+ * @param writer Writer to destroy (all submitted buffers must be written)
+ */
+void writer_destroy(writer_t *writer);
+
+/**
+ * Allocate an output buffer
+ *
+ * @param buffer Buffer to initialize
+ * @param capacity Bytes to allocate
+ * @return 1 on success, 0 if allocation failed
+ */
+int writer_buffer_init(writer_buffer_t *buffer, size_t capacity);
+
+/**
+ * Free an output buffer
+ *
+ * @param buffer Buffer to free
+ */
+void writer_buffer_free(writer_buffer_t *buffer);
+
+/**
+ * Append one grid to a buffer in the writer's record format
+ * The caller must leave room for one record (see writer_record_size())
+ *
+ * @param writer Writer whose format is used
+ * @param buffer Buffer to append to
+ * @param grid 9x9 grid to format
+ */
+void writer_append_grid(const writer_t *writer, writer_buffer_t *buffer, int grid[9][9]);
+
+/**
+ * Append a jigsaw region map to the record just appended
+ * Text records become "<81 cells> <81 region digits 1-9>"; binary records
+ * are followed by the map packed like a grid. Needs one more record of room
+ *
+ * @param writer Writer whose format is used
+ * @param buffer Buffer holding the grid record
+ * @param regions Region (0-8) of each cell
+ */
+void writer_append_regions(const writer_t *writer, writer_buffer_t *buffer, const uint8_t regions[81]);
+
+/**
+ * Append a killer cage list to the record just appended
+ * Text records become "<81 cells> <cage list>" in the format read by
+ * parse_cage_list(); binary records are followed by 81 cage numbers and 81
+ * cage sums, one byte each. Needs CAGE_RECORD_MAX more bytes of room
+ *
+ * @param writer Writer whose format is used
+ * @param buffer Buffer holding the grid record
+ * @param cages Killer cages
+ */
+void writer_append_cages(const writer_t *writer, writer_buffer_t *buffer, const cage_layout_t *cages);
+
+/**
+ * Size in bytes of one record in the writer's format
+ *
+ * @param writer Writer to query
+ * @return TEXT_RECORD_SIZE or BINARY_RECORD_SIZE
+ */
+size_t writer_record_size(const writer_t *writer);
+
+/**
+ * Queue a filled buffer for output under a sequence number
+ * Returns immediately; if this buffer completes an in-order run, the calling
+ * thread writes the whole run with one writev() call
+ *
+ * @param writer Writer to submit to
+ * @param buffer Filled buffer (must not be touched until writer_buffer_wait())
+ * @param seq Sequence number (0, 1, 2, ... across all threads)
+ * @return 1 on success, 0 if a write error occurred
+ */
+int writer_submit(writer_t *writer, writer_buffer_t *buffer, long seq);
+
+/**
+ * Wait until a submitted buffer has been written, then empty it for reuse
+ * Returns immediately for buffers that were never submitted
+ *
+ * @param writer Writer the buffer was submitted to
+ * @param buffer Buffer to wait for
+ */
+void writer_buffer_wait(writer_t *writer, writer_buffer_t *buffer);
+
+#endif
+
+/**
+ * MODULE USAGE NOTES:
+ *
+ * Worker Pattern (double buffering):
+ *   writer_buffer_wait(writer, &buffers[i]);    // previous contents written
+ *   ... writer_append_grid() for each result ...
+ *   writer_submit(writer, &buffers[i], seq);
+ *   i ^= 1;
+ *
+ * Ordering:
+ * - Sequence numbers must be handed out in input order without gaps
+ * - At most WRITER_WINDOW buffers may be outstanding; submit blocks beyond that
+ *
+ * Binary Records:
+ * - Cell n is stored in byte n / 2, high nibble for even n, low nibble for odd n
+ * - The low nibble of byte 40 is always zero
+ */
@@ -0,0 +1,680 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/analyze.h"
+#include "../include/batch.h"
+#include "../include/reader.h"
+#include "../include/search.h"
+#include "../include/solver.h"
+#include "../include/topology.h"
+#include <math.h>
+#include <pthread.h>
+
+#define GEOMETRY_LINE 1         // Same row or same column
+#define GEOMETRY_BOX 2          // Same box
+#define GEOMETRY_CHUTE 4        // Same band or same stack
+#define RELATION_DIGIT 8        // Both clues with the same digit
+
+typedef struct
+{
+    int grid[9][9];             // Puzzle
+    int has_regions;            // Flag: regions[] holds a jigsaw layout
+    uint8_t regions[81];        // Jigsaw layout of the puzzle
+    int has_cages;              // Flag: the puzzle carries killer cages
+    cage_layout_t cages;        // Killer cages of the puzzle
+} analyze_item_t;
+
+typedef struct
+{
+    reader_t *reader;           // Shared input (guarded by input_lock)
+    pthread_mutex_t input_lock; // Serializes chunk reads
+    int classic;                // Flag: rules are classic, so invariants apply
+    analyze_stats_t *stats;     // One statistics block per worker
+} analyze_job_t;
+
+typedef struct
+{
+    analyze_job_t *job;         // Shared job
+    analyze_stats_t *stats;     // This worker's own block
+} analyze_worker_t;
+
+static pthread_once_t geometry_built = PTHREAD_ONCE_INIT;
+static uint8_t geometry[81][81]; // GEOMETRY_* relations between two cells
+
+/**
+ * Fill the table of geometric relations between cells
+ * Rows and columns are not told apart, so transposition keeps every relation
+ */
+static void build_geometry(void)
+{
+    for (int a = 0; a < 81; a++)
+    {
+        for (int b = 0; b < 81; b++)
+        {
+            int row_a = a / 9, col_a = a % 9, row_b = b / 9, col_b = b % 9;
+            int band = row_a / 3 == row_b / 3, stack = col_a / 3 == col_b / 3;
+
+            geometry[a][b] = (uint8_t)(((row_a == row_b || col_a == col_b) ? GEOMETRY_LINE : 0) |
+                                       (band && stack ? GEOMETRY_BOX : 0) |
+                                       (band || stack ? GEOMETRY_CHUTE : 0));
+        }
+    }
+}
+
+/**
+ * Scramble a 64-bit value (SplitMix64 finalizer)
+ *
+ * Parameters:
+ *   z - value to scramble
+ *
+ * Returns: scrambled value
+ */
+static inline uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Compute an isomorphism invariant of a classic puzzle
+ * Colour refinement: every cell starts coloured by whether it holds a clue,
+ * then repeatedly takes a new colour from its old one and the multiset of
+ * (relation, colour) over all other cells. Sums keep the multisets
+ * independent of cell order, so only the relations matter
+ *
+ * Parameters:
+ *   grid - 9x9 puzzle (0 = empty)
+ *
+ * Returns: 64-bit invariant
+ */
+uint64_t puzzle_invariant(int grid[9][9])
+{
+    uint64_t color[81], next[81];
+    uint64_t invariant = 0;
+
+    pthread_once(&geometry_built, build_geometry);
+
+    for (int cell = 0; cell < 81; cell++)
+        color[cell] = mix64(grid[cell / 9][cell % 9] != 0);
+
+    for (int round = 0; round < ANALYZE_WL_ROUNDS; round++)
+    {
+        for (int a = 0; a < 81; a++)
+        {
+            int digit = grid[a / 9][a % 9];
+            uint64_t sum = 0;
+
+            for (int b = 0; b < 81; b++)
+            {
+                if (b == a)
+                    continue;
+
+                // Digit names are arbitrary; only equality between clues counts
+                uint64_t relation = geometry[a][b];
+
+                if (digit != 0 && grid[b / 9][b % 9] == digit)
+                    relation |= RELATION_DIGIT;
+
+                sum += mix64(color[b] ^ (relation * 0x9E3779B97F4A7C15ULL));
+            }
+
+            next[a] = mix64(color[a] * 31 + sum);
+        }
+
+        memcpy(color, next, sizeof(color));
+    }
+
+    for (int cell = 0; cell < 81; cell++)
+        invariant += mix64(color[cell]);
+
+    return invariant;
+}
+
+/**
+ * Hash the clues of a puzzle exactly
+ *
+ * Parameters:
+ *   grid - 9x9 puzzle
+ *
+ * Returns: 64-bit hash
+ */
+static uint64_t puzzle_hash(int grid[9][9])
+{
+    uint64_t hash = 0;
+
+    for (int cell = 0; cell < 81; cell++)
+        hash = mix64(hash ^ (uint64_t)(grid[cell / 9][cell % 9] + 16 * cell));
+
+    return hash;
+}
+
+/**
+ * Set the bit of a hash in a sketch
+ *
+ * Parameters:
+ *   sketch - ANALYZE_SKETCH_BITS-bit map
+ *   hash   - 64-bit hash
+ */
+static inline void sketch_add(uint64_t *sketch, uint64_t hash)
+{
+    uint64_t bit = hash % ANALYZE_SKETCH_BITS;
+
+    sketch[bit / 64] |= 1ULL << (bit % 64);
+}
+
+/**
+ * Estimate the distinct hashes in a sketch by linear counting
+ *
+ * Parameters:
+ *   sketch    - ANALYZE_SKETCH_BITS-bit map
+ *   saturated - set to 1 if the sketch is too full to trust
+ *
+ * Returns: estimated distinct values
+ */
+static double sketch_estimate(const uint64_t *sketch, int *saturated)
+{
+    uint64_t set = 0;
+
+    for (size_t word = 0; word < ANALYZE_SKETCH_BITS / 64; word++)
+        set += (uint64_t)__builtin_popcountll(sketch[word]);
+
+    uint64_t zeros = ANALYZE_SKETCH_BITS - set;
+
+    // Past about 99% fill the estimate's error explodes
+    *saturated = zeros < ANALYZE_SKETCH_BITS / 100;
+
+    if (zeros == 0)
+        zeros = 1;
+
+    return -(double)ANALYZE_SKETCH_BITS * log((double)zeros / ANALYZE_SKETCH_BITS);
+}
+
+/**
+ * Find the log-scale bucket of a value
+ * Values below 8 get their own bucket; above, each power of two is split in 4
+ *
+ * Parameters:
+ *   value - sample
+ *
+ * Returns: bucket index below ANALYZE_BUCKETS
+ */
+static int bucket_of(uint64_t value)
+{
+    if (value < 8)
+        return (int)value;
+
+    int exponent = 63 - __builtin_clzll(value);
+    return 4 * exponent - 4 + (int)((value >> (exponent - 2)) & 3);
+}
+
+/**
+ * Smallest value that falls in a bucket
+ *
+ * Parameters:
+ *   bucket - bucket index
+ *
+ * Returns: lower bound of the bucket
+ */
+static uint64_t bucket_floor(int bucket)
+{
+    if (bucket < 8)
+        return (uint64_t)bucket;
+
+    return (uint64_t)(4 + bucket % 4) << (bucket / 4 - 1);
+}
+
+/**
+ * Add a sample to a histogram
+ *
+ * Parameters:
+ *   histogram - histogram to update
+ *   value     - sample
+ */
+static void histogram_add(analyze_histogram_t *histogram, uint64_t value)
+{
+    histogram->counts[bucket_of(value)]++;
+    histogram->samples++;
+    histogram->total += value;
+
+    if (value > histogram->max)
+        histogram->max = value;
+}
+
+/**
+ * Add one histogram into another
+ *
+ * Parameters:
+ *   into - histogram receiving the sum
+ *   from - histogram added
+ */
+static void histogram_merge(analyze_histogram_t *into, const analyze_histogram_t *from)
+{
+    for (int i = 0; i < ANALYZE_BUCKETS; i++)
+        into->counts[i] += from->counts[i];
+
+    into->samples += from->samples;
+    into->total += from->total;
+
+    if (from->max > into->max)
+        into->max = from->max;
+}
+
+/**
+ * Read a percentile off a histogram
+ *
+ * Parameters:
+ *   histogram - histogram to read
+ *   fraction  - percentile as a fraction (0.5 = median)
+ *
+ * Returns: lower bound of the bucket holding the percentile
+ */
+static uint64_t histogram_percentile(const analyze_histogram_t *histogram, double fraction)
+{
+    uint64_t wanted = (uint64_t)(fraction * (double)histogram->samples);
+    uint64_t seen = 0;
+
+    for (int i = 0; i < ANALYZE_BUCKETS; i++)
+    {
+        seen += histogram->counts[i];
+
+        if (seen >= wanted && seen > 0)
+            return bucket_floor(i);
+    }
+
+    return histogram->max;
+}
+
+/**
+ * Count solutions up to two under the node budget
+ *
+ * Parameters:
+ *   search - search state to use
+ *   grid   - puzzle
+ *   nodes  - receives the digits placed
+ *
+ * Returns: ANALYZE_UNIQUE, _MULTIPLE, _UNSOLVABLE, _INVALID or _UNDECIDED
+ */
+static analyze_status_t count_up_to_two(search_t *search, int grid[9][9], uint64_t *nodes)
+{
+    search_count_t count = search_count_to_two(search, grid, ANALYZE_SEARCH_NODES, NULL, NULL);
+
+    *nodes = search->nodes;
+
+    switch (count)
+    {
+        case SEARCH_COUNT_INVALID:
+            return ANALYZE_INVALID; // Clues already clash
+        case SEARCH_COUNT_NONE:
+            return ANALYZE_UNSOLVABLE;
+        case SEARCH_COUNT_UNIQUE:
+            return ANALYZE_UNIQUE;
+        case SEARCH_COUNT_MULTIPLE:
+            return ANALYZE_MULTIPLE;
+        default:
+            return ANALYZE_UNDECIDED;
+    }
+}
+
+/**
+ * Analyze one puzzle into a statistics block
+ *
+ * Parameters:
+ *   stats   - this worker's statistics
+ *   search  - search state to use
+ *   grid    - puzzle (rules already active)
+ *   classic - flag: hash the isomorphism invariant
+ */
+static void analyze_puzzle(analyze_stats_t *stats, search_t *search, int grid[9][9], int classic)
+{
+    struct timespec start, end;
+    uint64_t nodes;
+    int clues = 0;
+
+    for (int cell = 0; cell < 81; cell++)
+        clues += grid[cell / 9][cell % 9] != 0;
+
+    stats->puzzles++;
+    stats->clues[clues]++;
+    sketch_add(stats->puzzle_sketch, puzzle_hash(grid));
+
+    if (classic)
+    {
+        sketch_add(stats->class_sketch, puzzle_invariant(grid));
+        stats->classed++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    analyze_status_t status = count_up_to_two(search, grid, &nodes);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    stats->status[status]++;
+
+    if (status == ANALYZE_INVALID)
+        return;
+
+    uint64_t micros = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000 +
+                      (uint64_t)((end.tv_nsec - start.tv_nsec) / 1000);
+
+    histogram_add(&stats->nodes, nodes);
+    histogram_add(&stats->micros, micros);
+
+    if (status == ANALYZE_UNIQUE)
+    {
+        difficulty_t rating = rate_puzzle(grid, NULL);
+
+        stats->ratings[rating]++;
+        stats->rating_clues[rating] += clues;
+    }
+}
+
+/**
+ * Worker: analyze chunks from the shared reader into its own statistics
+ *
+ * Parameters:
+ *   arg - analyze_worker_t of this thread
+ *
+ * Returns: NULL
+ */
+static void *analyze_worker(void *arg)
+{
+    analyze_worker_t *worker = arg;
+    analyze_job_t *job = worker->job;
+    analyze_item_t *items = malloc(sizeof(*items) * BATCH_CHUNK);
+    topology_t *layout = malloc(sizeof(*layout)); // Tables of a jigsaw or killer puzzle
+    search_t *search = malloc(sizeof(*search));
+
+    if (items == NULL || layout == NULL || search == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (;;)
+    {
+        int count = 0;
+
+        pthread_mutex_lock(&job->input_lock);
+        while (count < BATCH_CHUNK && reader_next(job->reader, items[count].grid))
+        {
+            // Jigsaw layouts and killer cages differ per puzzle
+            analyze_item_t *item = &items[count++];
+
+            item->has_regions = job->reader->has_regions;
+            if (item->has_regions)
+                memcpy(item->regions, job->reader->regions, sizeof(item->regions));
+
+            item->has_cages = job->reader->has_cages;
+            if (item->has_cages)
+                memcpy(&item->cages, &job->reader->cages, sizeof(item->cages));
+        }
+        pthread_mutex_unlock(&job->input_lock);
+
+        if (count == 0)
+            break; // Input exhausted
+
+        for (int i = 0; i < count; i++)
+        {
+            analyze_item_t *item = &items[i];
+
+            if ((item->has_regions && !regions_valid(item->regions)) ||
+                (item->has_cages && !cages_valid(&item->cages)))
+            {
+                worker->stats->puzzles++;
+                worker->stats->status[ANALYZE_INVALID]++;
+                continue;
+            }
+
+            // This thread's own tables; other workers may be on other layouts
+            if (item->has_regions)
+                build_region_topology(layout, item->regions);
+            else if (item->has_cages)
+                build_cage_topology(layout, &item->cages);
+
+            use_thread_topology(item->has_regions || item->has_cages ? layout : NULL);
+            analyze_puzzle(worker->stats, search, item->grid,
+                           job->classic && !item->has_regions && !item->has_cages);
+        }
+    }
+
+    use_thread_topology(NULL);
+    free(items);
+    free(layout);
+    free(search);
+    return NULL;
+}
+
+/**
+ * Add one worker's statistics into another's
+ *
+ * Parameters:
+ *   into - block receiving the sum
+ *   from - block added
+ */
+static void merge_stats(analyze_stats_t *into, const analyze_stats_t *from)
+{
+    into->puzzles += from->puzzles;
+    into->classed += from->classed;
+
+    for (int i = 0; i < 82; i++)
+        into->clues[i] += from->clues[i];
+
+    for (int i = 0; i < ANALYZE_STATUS_COUNT; i++)
+        into->status[i] += from->status[i];
+
+    for (int i = 0; i < 4; i++)
+    {
+        into->ratings[i] += from->ratings[i];
+        into->rating_clues[i] += from->rating_clues[i];
+    }
+
+    histogram_merge(&into->nodes, &from->nodes);
+    histogram_merge(&into->micros, &from->micros);
+
+    // Sketches merge by OR: a bit is set if any worker saw the hash
+    for (size_t word = 0; word < ANALYZE_SKETCH_BITS / 64; word++)
+    {
+        into->puzzle_sketch[word] |= from->puzzle_sketch[word];
+        into->class_sketch[word] |= from->class_sketch[word];
+    }
+}
+
+/**
+ * Print a histogram summary line
+ *
+ * Parameters:
+ *   label     - line label
+ *   histogram - histogram to summarize
+ */
+static void print_distribution(const char *label, const analyze_histogram_t *histogram)
+{
+    if (histogram->samples == 0)
+    {
+        printf("%-12s -\n", label);
+        return;
+    }
+
+    printf("%-12s avg %.0f  p50 %llu  p90 %llu  p99 %llu  max %llu\n", label,
+           (double)histogram->total / (double)histogram->samples,
+           (unsigned long long)histogram_percentile(histogram, 0.50),
+           (unsigned long long)histogram_percentile(histogram, 0.90),
+           (unsigned long long)histogram_percentile(histogram, 0.99),
+           (unsigned long long)histogram->max);
+}
+
+/**
+ * Print the report for the merged statistics
+ *
+ * Parameters:
+ *   stats   - merged statistics
+ *   skipped - malformed lines skipped by the reader
+ *   threads - workers used
+ *   seconds - wall time of the analysis
+ */
+static void print_report(const analyze_stats_t *stats, long skipped, int threads, double seconds)
+{
+    const char *status_names[] = {"unique", "multiple", "unsolvable", "invalid", "undecided"};
+    const char *rating_names[] = {"easy", "medium", "hard", "expert"};
+    long widest = 1;
+    int saturated;
+
+    printf("puzzles:     %ld (%ld malformed line(s) skipped)\n", stats->puzzles, skipped);
+    printf("throughput:  %.0f puzzles/s on %d thread(s), %.2f s\n",
+           seconds > 0 ? (double)stats->puzzles / seconds : 0.0, threads, seconds);
+
+    if (stats->puzzles == 0)
+        return;
+
+    printf("\nstatus:\n");
+    for (int i = 0; i < ANALYZE_STATUS_COUNT; i++)
+    {
+        printf("  %-11s %10ld  %5.1f%%\n", status_names[i], stats->status[i],
+               100.0 * (double)stats->status[i] / (double)stats->puzzles);
+    }
+
+    printf("\nclues:\n");
+    for (int i = 0; i < 82; i++)
+    {
+        if (stats->clues[i] > widest)
+            widest = stats->clues[i];
+    }
+
+    for (int i = 0; i < 82; i++)
+    {
+        if (stats->clues[i] == 0)
+            continue;
+
+        int bar = (int)((40 * stats->clues[i] + widest - 1) / widest);
+        printf("  %2d %10ld  %.*s\n", i, stats->clues[i], bar,
+               "########################################");
+    }
+
+    printf("\nrating (unique puzzles):\n");
+    for (int i = 0; i < 4; i++)
+    {
+        printf("  %-11s %10ld  %5.1f%%  avg clues %.1f\n", rating_names[i], stats->ratings[i],
+               stats->status[ANALYZE_UNIQUE]
+                   ? 100.0 * (double)stats->ratings[i] / (double)stats->status[ANALYZE_UNIQUE]
+                   : 0.0,
+               stats->ratings[i] ? (double)stats->rating_clues[i] / (double)stats->ratings[i]
+                                 : 0.0);
+    }
+
+    printf("\n");
+    print_distribution("nodes:", &stats->nodes);
+    print_distribution("time (us):", &stats->micros);
+
+    double distinct = sketch_estimate(stats->puzzle_sketch, &saturated);
+    double puzzles = (double)stats->puzzles;
+
+    // Noise can push the estimate slightly past the true total
+    if (distinct > puzzles)
+        distinct = puzzles;
+
+    printf("\nduplicates:  ~%.0f (distinct puzzles ~%.0f)%s\n", puzzles - distinct, distinct,
+           saturated ? "  [sketch saturated]" : "");
+
+    if (stats->classed > 0)
+    {
+        double classes = sketch_estimate(stats->class_sketch, &saturated);
+        double classed_distinct = distinct * (double)stats->classed / puzzles;
+
+        if (classes > classed_distinct)
+            classes = classed_distinct;
+
+        printf("isomorphs:   ~%.0f (isomorphism classes ~%.0f)%s\n", classed_distinct - classes,
+               classes, saturated ? "  [sketch saturated]" : "");
+    }
+    else
+    {
+        printf("isomorphs:   n/a (classic rules only)\n");
+    }
+}
+
+/**
+ * Analyze every puzzle in a file and print the report to stdout
+ *
+ * Parameters:
+ *   path    - puzzle file, or "-" for stdin
+ *   threads - worker threads (0 = one per online CPU)
+ *
+ * Returns: 0 on success, 1 on I/O error
+ */
+int analyze_corpus(const char *path, int threads)
+{
+    int thread_count = batch_thread_count(threads);
+    pthread_t handles[BATCH_MAX_THREADS];
+    analyze_worker_t workers[BATCH_MAX_THREADS];
+    analyze_stats_t *stats = calloc((size_t)thread_count, sizeof(*stats));
+    analyze_job_t job;
+    reader_t reader;
+    struct timespec start, end;
+
+    if (stats == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        stats[i].puzzle_sketch = calloc(ANALYZE_SKETCH_BITS / 64, sizeof(uint64_t));
+        stats[i].class_sketch = calloc(ANALYZE_SKETCH_BITS / 64, sizeof(uint64_t));
+
+        if (stats[i].puzzle_sketch == NULL || stats[i].class_sketch == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        for (int i = 0; i < thread_count; i++)
+        {
+            free(stats[i].puzzle_sketch);
+            free(stats[i].class_sketch);
+        }
+        free(stats);
+        return 1;
+    }
+
+    job.reader = &reader;
+    job.classic = current_topology()->variant == VARIANT_CLASSIC;
+    job.stats = stats;
+    pthread_mutex_init(&job.input_lock, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].job = &job;
+        workers[i].stats = &stats[i];
+        pthread_create(&handles[i], NULL, analyze_worker, &workers[i]);
+    }
+
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(handles[i], NULL);
+
+    // Merge once, after the workers: they never share a counter
+    for (int i = 1; i < thread_count; i++)
+        merge_stats(&stats[0], &stats[i]);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    print_report(&stats[0], reader.skipped, thread_count,
+                 (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9);
+
+    pthread_mutex_destroy(&job.input_lock);
+    reader_close(&reader);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        free(stats[i].puzzle_sketch);
+        free(stats[i].class_sketch);
+    }
+    free(stats);
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/animate.h"
+#include "../include/search.h"
+#include "../include/branch.h"
+
+/**
+ * Read the monotonic clock
+ *
+ * Returns: seconds since an arbitrary fixed point
+ */
+static double monotonic_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * Copy the search assignment into the non-given cells of the game grid
+ *
+ * Parameters:
+ *   anim - running animation
+ *   game - game being animated
+ */
+static void show_search_state(const animation_t *anim, game_state_t *game)
+{
+    for (int cell = 0; cell < SEARCH_CELLS; cell++)
+    {
+        int row = cell / 9;
+        int col = cell % 9;
+
+        if (!game->given[row][col])
+            game->grid[row][col] = anim->search.values[cell];
+    }
+}
+
+/**
+ * Begin an animated solve of the current puzzle
+ *
+ * Parameters:
+ *   anim - animation state to initialize
+ *   game - game whose puzzle is solved
+ */
+void start_animation(animation_t *anim, game_state_t *game)
+{
+    int puzzle[9][9];
+
+    // Search from the givens only: player entries may be wrong
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            anim->saved_grid[row][col] = game->grid[row][col];
+
+            // The search rewrites every open cell; an open branch must be
+            // able to undo a solve that finishes
+            if (!game->given[row][col])
+                record_cell(game, row, col);
+
+            puzzle[row][col] = game->given[row][col] ? game->grid[row][col] : 0;
+        }
+    }
+
+    search_init(&anim->search, puzzle);
+
+    if (anim->nodes_per_frame < ANIMATION_MIN_SPEED)
+        anim->nodes_per_frame = ANIMATION_MIN_SPEED;
+
+    anim->active = 1;
+    anim->start_seconds = monotonic_seconds();
+    anim->rate = 0;
+    anim->rate_seconds = anim->start_seconds;
+    anim->rate_nodes = 0;
+}
+
+/**
+ * Advance the animation by one frame's node budget
+ *
+ * Parameters:
+ *   anim - running animation
+ *   game - game being animated
+ *
+ * Returns: 1 while still running, 0 once finished
+ */
+int step_animation(animation_t *anim, game_state_t *game)
+{
+    if (!anim->active)
+        return 0;
+
+    search_status_t status = search_run(&anim->search, anim->nodes_per_frame, NULL);
+
+    show_search_state(anim, game);
+
+    // Refresh the nodes/second figure about twice per second
+    double now = monotonic_seconds();
+
+    if (now - anim->rate_seconds >= 0.5)
+    {
+        anim->rate = (double)(anim->search.nodes - anim->rate_nodes) / (now - anim->rate_seconds);
+        anim->rate_seconds = now;
+        anim->rate_nodes = anim->search.nodes;
+    }
+
+    if (status == SEARCH_RUNNING)
+        return 1;
+
+    // Final figure: average over the whole animation
+    if (now > anim->start_seconds)
+        anim->rate = (double)anim->search.nodes / (now - anim->start_seconds);
+
+    anim->active = 0;
+
+    if (status == SEARCH_FOUND)
+    {
+        game->is_completed = 1; // Same outcome as solve_puzzle()
+    }
+    else
+    {
+        // Givens admit no solution: put the player's grid back
+        memcpy(game->grid, anim->saved_grid, sizeof(anim->saved_grid));
+    }
+
+    return 0;
+}
+
+/**
+ * Stop the animation and restore the player's grid
+ *
+ * Parameters:
+ *   anim - running animation
+ *   game - game being animated
+ */
+void cancel_animation(animation_t *anim, game_state_t *game)
+{
+    if (!anim->active)
+        return;
+
+    memcpy(game->grid, anim->saved_grid, sizeof(anim->saved_grid));
+    anim->active = 0;
+}
+
+/**
+ * Double or halve the number of nodes searched per frame
+ *
+ * Parameters:
+ *   anim   - animation state
+ *   faster - 1 to double, 0 to halve
+ */
+void change_animation_speed(animation_t *anim, int faster)
+{
+    if (faster && anim->nodes_per_frame < ANIMATION_MAX_SPEED)
+        anim->nodes_per_frame *= 2;
+    else if (!faster && anim->nodes_per_frame > ANIMATION_MIN_SPEED)
+        anim->nodes_per_frame /= 2;
+}
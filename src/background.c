@@ -0,0 +1,182 @@
+#include "../include/sudoku.h"
+#include "../include/background.h"
+
+/**
+ * Worker: check the newest posted board until stopped
+ *
+ * Parameters:
+ *   arg - background_t of the worker
+ *
+ * Returns: NULL
+ */
+static void *background_worker(void *arg)
+{
+    background_t *background = arg;
+
+    pthread_mutex_lock(&background->lock);
+
+    while (!background->stop)
+    {
+        if (background->answered == background->posted)
+        {
+            pthread_cond_wait(&background->wake, &background->lock);
+            continue;
+        }
+
+        // Take a private copy so the UI can post again while this runs
+        unsigned long sequence = background->posted;
+
+        *background->work_board = background->board;
+        background->cancel = 0;
+        pthread_mutex_unlock(&background->lock);
+
+        memset(background->work_answer, 0, background->answer_size);
+        use_thread_topology(&background->work_board->topology);
+
+        int finished = background->check(background->search, background->work_board,
+                                         &background->cancel, background->work_answer);
+
+        pthread_mutex_lock(&background->lock);
+
+        // A cancelled check belongs to a board that is no longer current
+        if (finished && sequence == background->posted)
+        {
+            memcpy(background->answer, background->work_answer, background->answer_size);
+            background->answered = sequence;
+        }
+    }
+
+    pthread_mutex_unlock(&background->lock);
+
+    use_thread_topology(NULL);
+    return NULL;
+}
+
+/**
+ * Release the memory of a worker
+ *
+ * Parameters:
+ *   background - worker whose buffers are freed
+ */
+static void free_buffers(background_t *background)
+{
+    free(background->search);
+    free(background->work_board);
+    free(background->answer);
+    free(background->work_answer);
+}
+
+/**
+ * Start the worker thread
+ *
+ * Parameters:
+ *   background  - worker to initialize
+ *   check       - check to run on each posted board
+ *   answer_size - bytes of one answer
+ *
+ * Returns: 1 on success, 0 if memory or the thread could not be obtained
+ */
+int background_start(background_t *background, background_check_t check, size_t answer_size)
+{
+    memset(background, 0, sizeof(*background));
+    background->check = check;
+    background->answer_size = answer_size;
+    background->search = malloc(sizeof(*background->search));
+    background->work_board = malloc(sizeof(*background->work_board));
+    background->answer = calloc(1, answer_size);
+    background->work_answer = malloc(answer_size);
+
+    if (background->search == NULL || background->work_board == NULL ||
+        background->answer == NULL || background->work_answer == NULL)
+    {
+        free_buffers(background);
+        return 0;
+    }
+
+    pthread_mutex_init(&background->lock, NULL);
+    pthread_cond_init(&background->wake, NULL);
+
+    if (pthread_create(&background->thread, NULL, background_worker, background) != 0)
+    {
+        pthread_cond_destroy(&background->wake);
+        pthread_mutex_destroy(&background->lock);
+        free_buffers(background);
+        return 0;
+    }
+
+    background->started = 1;
+    return 1;
+}
+
+/**
+ * Cancel any check in progress and join the worker thread
+ *
+ * Parameters:
+ *   background - started worker
+ */
+void background_stop(background_t *background)
+{
+    if (!background->started)
+        return;
+
+    pthread_mutex_lock(&background->lock);
+    background->stop = 1;
+    background->cancel = 1;
+    pthread_cond_signal(&background->wake);
+    pthread_mutex_unlock(&background->lock);
+
+    pthread_join(background->thread, NULL);
+    pthread_cond_destroy(&background->wake);
+    pthread_mutex_destroy(&background->lock);
+    free_buffers(background);
+    background->started = 0;
+}
+
+/**
+ * Post a board for checking and return at once
+ *
+ * Parameters:
+ *   background - started worker
+ *   grid       - board
+ *   solution   - stored solution, or NULL
+ */
+void background_post(background_t *background, int grid[9][9], int solution[9][9])
+{
+    pthread_mutex_lock(&background->lock);
+
+    memcpy(background->board.grid, grid, sizeof(background->board.grid));
+    background->board.has_solution = solution != NULL;
+
+    if (solution != NULL)
+        memcpy(background->board.solution, solution, sizeof(background->board.solution));
+
+    memcpy(&background->board.topology, current_topology(), sizeof(background->board.topology));
+    background->posted++;
+    background->cancel = 1; // Abandon the board in work, if any
+    pthread_cond_signal(&background->wake);
+    pthread_mutex_unlock(&background->lock);
+}
+
+/**
+ * Read the answer for the newest posted board without waiting
+ *
+ * Parameters:
+ *   background - started worker
+ *   answer     - receives the answer if it is ready
+ *
+ * Returns: 1 if the newest board has been checked, 0 otherwise
+ */
+int background_answer(background_t *background, void *answer)
+{
+    int ready;
+
+    pthread_mutex_lock(&background->lock);
+    ready = background->posted > 0 && background->answered == background->posted;
+
+    if (ready)
+        memcpy(answer, background->answer, background->answer_size);
+
+    pthread_mutex_unlock(&background->lock);
+
+    return ready;
+}
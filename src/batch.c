@@ -0,0 +1,1730 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/batch.h"
+#include "../include/reader.h"
+#include "../include/solver.h"
+#include "../include/writer.h"
+#include "../include/codec.h"
+#include "../include/generator.h"
+#include "../include/restart.h"
+#include "../include/topology.h"
+#include "../include/samurai.h"
+#include "../include/format.h"
+#include "../include/analyze.h"
+#include "../include/daily.h"
+#include "../include/pool.h"
+#include "../include/checkpoint.h"
+#include "../include/counter.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+// ============================================================================
+//                          PARALLEL SOLVE STATE
+// ============================================================================
+
+// Input position after a chunk, kept until the chunk's output is written;
+// chunks read but not yet written never exceed WRITER_WINDOW
+#define SOLVE_MARKS (2 * WRITER_WINDOW)
+
+typedef struct
+{
+    uint64_t input_offset;      // reader_offset() after the chunk
+    long input_line;            // Input lines read through the chunk
+    long skipped;               // Malformed lines through the chunk
+    long done;                  // Puzzles read through the chunk
+} solve_mark_t;
+
+typedef struct
+{
+    reader_t *reader;           // Shared input (guarded by input_lock)
+    pthread_mutex_t input_lock; // Serializes chunk reads and seq assignment
+    long next_seq;              // Sequence number of the next chunk read
+    writer_t *writer;           // Shared ordered output
+    long done;                  // Puzzles read so far, resumed ones included
+    int running;                // Workers still running (guarded by input_lock)
+    solve_mark_t marks[SOLVE_MARKS]; // Position after chunk seq, at seq % SOLVE_MARKS
+} solve_job_t;
+
+typedef struct
+{
+    writer_t *writer;           // Ordered output
+    writer_buffer_t *buffer;    // Single reusable output buffer
+    long seq;                   // Sequence number for the next flush
+} enumerate_output_t;
+
+static volatile int interrupted = 0;   // Set by SIGINT to cancel long runs
+
+/**
+ * SIGINT handler: request cancellation of the running tool
+ *
+ * Parameters:
+ *   signum - signal number (unused)
+ */
+static void handle_interrupt(int signum)
+{
+    (void)signum;
+    interrupted = 1;
+}
+
+/**
+ * Print command-line usage to the given stream
+ *
+ * Parameters:
+ *   out  - stream to print to
+ *   name - program name (argv[0])
+ */
+static void print_usage(FILE *out, const char *name)
+{
+    fprintf(out, "Usage: %s [option]\n", name);
+    fprintf(out, "  (no option)        Start the interactive game\n");
+    fprintf(out, "  --play FILE        Start the game on the first puzzle in FILE\n");
+    fprintf(out, "  --solve FILE       Solve every puzzle in FILE (\"-\" = stdin)\n");
+    fprintf(out, "  --validate FILE    Check every puzzle in FILE for a unique solution\n");
+    fprintf(out, "  --enumerate FILE   Print every solution of each puzzle in FILE\n");
+    fprintf(out, "  --count FILE       Count the solutions of each puzzle in FILE on all threads\n");
+    fprintf(out, "  --limit N          Stop --enumerate or --count after N solutions per puzzle\n");
+    fprintf(out, "  --generate N       Print N newly generated puzzles\n");
+    fprintf(out, "  --difficulty LEVEL easy, medium, hard or expert (default: medium)\n");
+    fprintf(out, "  --clues N          Clue target for --generate (17-81), raced on all threads\n");
+    fprintf(out, "  --attempts N       Removal passes per puzzle before settling (default: %d)\n",
+            GENERATOR_ATTEMPTS);
+    fprintf(out, "  --budget SECONDS   Time allowed per --clues puzzle (default: %.0f)\n",
+            RESTART_DEFAULT_BUDGET);
+    fprintf(out, "  --hitting-set      Choose clues as a hitting set of unavoidable sets\n");
+    fprintf(out, "  --minimal          Generate minimal puzzles (every clue necessary)\n");
+    fprintf(out, "  --symmetry TYPE    Clue symmetry for --generate: none, rotational,\n");
+    fprintf(out, "                     diagonal, mirror, dihedral\n");
+    fprintf(out, "  --variant NAME     Rules for every tool: classic, x, windoku, jigsaw, killer\n");
+    fprintf(out, "                     or samurai (--generate only, 369-digit lines)\n");
+    fprintf(out, "  --daily DATE       Print the daily puzzle of DATE (YYYY-MM-DD or \"today\")\n");
+    fprintf(out, "  --convert FILE     Rewrite every puzzle in FILE (line, SDK, .ss or JSON input)\n");
+    fprintf(out, "  --format NAME      Output of --convert: line, sdk, ss or json (default: line)\n");
+    fprintf(out, "  --analyze FILE     Report clues, solutions, ratings, effort and repeats in FILE\n");
+    fprintf(out, "  --daemon           Keep the shared pool of ready classic puzzles full\n");
+    fprintf(out, "  --bench-codec FILE Measure puzzle encode/decode rate on FILE\n");
+    fprintf(out, "  --checkpoint FILE  Save --generate or --solve progress to FILE every %.0f s\n",
+            CHECKPOINT_INTERVAL);
+    fprintf(out, "  --resume           Continue from the checkpoint (append output with >>)\n");
+    fprintf(out, "  --threads N        Worker threads for --solve, --count, --clues and --analyze\n");
+    fprintf(out, "                     (default: all)\n");
+    fprintf(out, "  --binary           Write 41-byte binary records instead of text lines\n");
+    fprintf(out, "  --help             Show this message\n");
+}
+
+/**
+ * Parse a difficulty name
+ *
+ * Parameters:
+ *   name       - "easy", "medium", "hard" or "expert"
+ *   difficulty - receives the parsed level
+ *
+ * Returns: 1 if recognized, 0 otherwise
+ */
+static int parse_difficulty(const char *name, difficulty_t *difficulty)
+{
+    const char *names[] = {"easy", "medium", "hard", "expert"};
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *difficulty = (difficulty_t)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Parse a clue symmetry name
+ *
+ * Parameters:
+ *   name     - symmetry name
+ *   symmetry - receives the parsed symmetry
+ *
+ * Returns: 1 if recognized, 0 otherwise
+ */
+static int parse_symmetry(const char *name, symmetry_t *symmetry)
+{
+    const char *names[] = {"none", "rotational", "diagonal", "mirror", "dihedral"};
+
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *symmetry = (symmetry_t)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Run the batch tool selected by the command-line arguments
+ *
+ * Parameters:
+ *   argc - argument count
+ *   argv - argument vector
+ *
+ * Returns: process exit status
+ */
+int batch_main(int argc, char *argv[])
+{
+    batch_options_t options = {0, WRITER_TEXT, 0, MEDIUM, 0, 0, SYMMETRY_NONE, 0, 0,
+                               GENERATOR_REMOVAL, FORMAT_LINE, NULL, 0};
+    const char *mode = NULL;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+        {
+            print_usage(stdout, argv[0]);
+            return 0;
+        }
+        else if ((strcmp(arg, "--solve") == 0 || strcmp(arg, "--validate") == 0 ||
+                  strcmp(arg, "--bench-codec") == 0 || strcmp(arg, "--enumerate") == 0 ||
+                  strcmp(arg, "--convert") == 0 || strcmp(arg, "--analyze") == 0 ||
+                  strcmp(arg, "--count") == 0) &&
+                 i + 1 < argc)
+        {
+            mode = arg;
+            path = argv[++i];
+        }
+        else if (strcmp(arg, "--threads") == 0 && i + 1 < argc)
+        {
+            options.threads = atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--generate") == 0 || strcmp(arg, "--daily") == 0) && i + 1 < argc)
+        {
+            mode = arg;
+            path = argv[++i]; // Puzzle count or date
+        }
+        else if (strcmp(arg, "--difficulty") == 0 && i + 1 < argc)
+        {
+            if (!parse_difficulty(argv[++i], &options.difficulty))
+            {
+                mode = NULL;
+                break;
+            }
+        }
+        else if (strcmp(arg, "--clues") == 0 && i + 1 < argc)
+        {
+            options.clues = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--attempts") == 0 && i + 1 < argc)
+        {
+            options.attempts = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--budget") == 0 && i + 1 < argc)
+        {
+            options.budget = atof(argv[++i]);
+        }
+        else if (strcmp(arg, "--hitting-set") == 0)
+        {
+            options.method = GENERATOR_HITTING_SET;
+        }
+        else if (strcmp(arg, "--minimal") == 0)
+        {
+            options.minimal = 1;
+        }
+        else if (strcmp(arg, "--symmetry") == 0 && i + 1 < argc)
+        {
+            if (!parse_symmetry(argv[++i], &options.symmetry))
+            {
+                mode = NULL;
+                break;
+            }
+        }
+        else if (strcmp(arg, "--variant") == 0 && i + 1 < argc)
+        {
+            variant_t variant;
+
+            if (!parse_variant(argv[++i], &variant))
+            {
+                mode = NULL;
+                break;
+            }
+
+            set_current_variant(variant); // Before any worker thread starts
+        }
+        else if (strcmp(arg, "--limit") == 0 && i + 1 < argc)
+        {
+            options.limit = atol(argv[++i]);
+        }
+        else if (strcmp(arg, "--format") == 0 && i + 1 < argc)
+        {
+            if (!parse_format(argv[++i], &options.convert))
+            {
+                mode = NULL;
+                break;
+            }
+        }
+        else if (strcmp(arg, "--binary") == 0)
+        {
+            options.format = WRITER_BINARY;
+        }
+        else if (strcmp(arg, "--daemon") == 0)
+        {
+            mode = arg;
+        }
+        else if (strcmp(arg, "--checkpoint") == 0 && i + 1 < argc)
+        {
+            options.checkpoint = argv[++i];
+        }
+        else if (strcmp(arg, "--resume") == 0)
+        {
+            options.resume = 1;
+        }
+        else
+        {
+            mode = NULL; // Unknown option
+            break;
+        }
+    }
+
+    // Samurai puzzles are 369-cell lines the 9x9 readers cannot parse
+    if (mode != NULL && strcmp(mode, "--generate") != 0 &&
+        current_topology()->variant == VARIANT_SAMURAI)
+    {
+        fprintf(stderr, "Samurai puzzles are supported by --generate only\n");
+        return 1;
+    }
+
+    // Only the long-running jobs that write a file of records can resume
+    if (mode != NULL && (options.checkpoint != NULL || options.resume) &&
+        ((strcmp(mode, "--generate") != 0 && strcmp(mode, "--solve") != 0) ||
+         options.checkpoint == NULL ||
+         strlen(options.checkpoint) >= CHECKPOINT_PATH_MAX ||
+         current_topology()->variant == VARIANT_SAMURAI))
+    {
+        fprintf(stderr, "--checkpoint FILE applies to --generate and --solve; "
+                "--resume needs it\n");
+        return 1;
+    }
+
+    if (mode != NULL && strcmp(mode, "--solve") == 0)
+        return batch_solve(path, &options);
+
+    if (mode != NULL && strcmp(mode, "--validate") == 0)
+        return batch_validate(path);
+
+    if (mode != NULL && strcmp(mode, "--enumerate") == 0)
+        return batch_enumerate(path, &options);
+
+    if (mode != NULL && strcmp(mode, "--count") == 0)
+        return batch_count(path, &options);
+
+    if (mode != NULL && strcmp(mode, "--generate") == 0)
+        return batch_generate(atol(path), &options);
+
+    if (mode != NULL && strcmp(mode, "--daily") == 0)
+        return batch_daily(path, &options);
+
+    if (mode != NULL && strcmp(mode, "--convert") == 0)
+        return batch_convert(path, &options);
+
+    if (mode != NULL && strcmp(mode, "--daemon") == 0)
+        return pool_daemon(options.threads);
+
+    if (mode != NULL && strcmp(mode, "--analyze") == 0)
+        return analyze_corpus(path, options.threads);
+
+    if (mode != NULL && strcmp(mode, "--bench-codec") == 0)
+        return batch_bench_codec(path);
+
+    print_usage(stderr, argv[0]);
+    return 2; // Unknown option or missing argument
+}
+
+/**
+ * Read the monotonic clock
+ *
+ * Returns: seconds since an arbitrary fixed point
+ */
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * Resolve the worker thread count for a batch run
+ *
+ * Parameters:
+ *   requested - requested thread count (0 = one per online CPU)
+ *
+ * Returns: thread count between 1 and BATCH_MAX_THREADS
+ */
+int batch_thread_count(int requested)
+{
+    int threads = requested;
+
+    if (threads <= 0)
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (threads < 1)
+        threads = 1;
+
+    if (threads > BATCH_MAX_THREADS)
+        threads = BATCH_MAX_THREADS;
+
+    return threads;
+}
+
+/**
+ * Switch to the jigsaw layout or killer cages carried by the puzzle just
+ * read, if any
+ * A region map or cage list is built into the caller's tables and selected
+ * for this thread only; lines without one return to the variant selected on
+ * the command line, so a layout never leaks into the lines after it
+ *
+ * Parameters:
+ *   reader - reader that returned the puzzle
+ *   layout - tables that receive a layout carried by the line
+ *
+ * Returns: 1 if the puzzle can be checked, 0 if its layout is unusable
+ */
+static int apply_puzzle_layout(const reader_t *reader, topology_t *layout)
+{
+    use_thread_topology(NULL);
+
+    if (reader->has_regions)
+    {
+        if (!regions_valid(reader->regions))
+            return 0;
+
+        build_region_topology(layout, reader->regions);
+        use_thread_topology(layout);
+    }
+    else if (reader->has_cages)
+    {
+        if (!cages_valid(&reader->cages))
+            return 0;
+
+        build_cage_topology(layout, &reader->cages);
+        use_thread_topology(layout);
+    }
+
+    return 1;
+}
+
+/**
+ * Solution callback that copies the first solution into a grid
+ *
+ * Parameters:
+ *   solution  - complete solution grid
+ *   user_data - 9x9 grid that receives it
+ *
+ * Returns: 0 to stop after this solution
+ */
+static int copy_solution(int solution[9][9], void *user_data)
+{
+    memcpy(user_data, solution, sizeof(int[9][9]));
+    return 0;
+}
+
+/**
+ * Solve a puzzle in place under the active rules
+ * Killer puzzles usually have no givens, far beyond plain backtracking, so
+ * they go through the search engine and its cage-combination pruning
+ *
+ * Parameters:
+ *   grid - 9x9 puzzle, replaced by its solution
+ *
+ * Returns: 1 if solved, 0 if unsolvable
+ */
+static int solve_puzzle(int grid[9][9])
+{
+    if (current_topology()->cage_count > 0)
+        return enumerate_solutions(grid, 1, copy_solution, grid, NULL) == 1;
+
+    return solve_grid(grid);
+}
+
+/**
+ * Worker thread for batch_solve()
+ * Reads a chunk, solves it into one of two alternating buffers and submits it
+ *
+ * Parameters:
+ *   arg - shared solve_job_t
+ *
+ * Returns: NULL
+ */
+static void *solve_worker(void *arg)
+{
+    solve_job_t *job = arg;
+    writer_t *writer = job->writer;
+    size_t record = writer_record_size(writer);
+    writer_buffer_t buffers[2];
+    int (*grids)[9][9] = malloc(sizeof(int[9][9]) * BATCH_CHUNK);
+    uint8_t (*regions)[81] = malloc(sizeof(uint8_t[81]) * BATCH_CHUNK);
+    int *has_regions = malloc(sizeof(int) * BATCH_CHUNK);
+    int *has_cages = malloc(sizeof(int) * BATCH_CHUNK);
+    topology_t *layout = malloc(sizeof(topology_t)); // Tables of a jigsaw or killer puzzle
+    cage_layout_t *cages = NULL; // Allocated on the first killer puzzle
+    int current = 0;
+
+    if (grids == NULL || regions == NULL || has_regions == NULL || has_cages == NULL ||
+        layout == NULL ||
+        !writer_buffer_init(&buffers[0], record * BATCH_CHUNK) ||
+        !writer_buffer_init(&buffers[1], record * BATCH_CHUNK))
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (;;)
+    {
+        writer_buffer_t *buffer = &buffers[current];
+        int count = 0;
+        long seq;
+
+        // Reuse this buffer only once its previous contents are written
+        writer_buffer_wait(writer, buffer);
+
+        pthread_mutex_lock(&job->input_lock);
+        while (count < BATCH_CHUNK && reader_next(job->reader, grids[count]))
+        {
+            // Jigsaw layouts and killer cages differ per puzzle, so each one
+            // travels with its grid
+            has_regions[count] = job->reader->has_regions;
+            if (has_regions[count])
+                memcpy(regions[count], job->reader->regions, sizeof(regions[count]));
+
+            has_cages[count] = job->reader->has_cages;
+            if (has_cages[count])
+            {
+                if (cages == NULL && (cages = malloc(sizeof(cage_layout_t) * BATCH_CHUNK)) == NULL)
+                {
+                    fprintf(stderr, "Out of memory\n");
+                    exit(1);
+                }
+
+                memcpy(&cages[count], &job->reader->cages, sizeof(cages[count]));
+            }
+            count++;
+        }
+        seq = job->next_seq;
+        if (count > 0)
+        {
+            solve_mark_t *mark = &job->marks[seq % SOLVE_MARKS];
+
+            job->done += count;
+            mark->input_offset = reader_offset(job->reader);
+            mark->input_line = job->reader->line;
+            mark->skipped = job->reader->skipped;
+            mark->done = job->done;
+            job->next_seq++;
+        }
+        pthread_mutex_unlock(&job->input_lock);
+
+        if (count == 0)
+            break; // Input exhausted
+
+        for (int i = 0; i < count; i++)
+        {
+            int layout_ok = has_regions[i] ? regions_valid(regions[i]) :
+                            has_cages[i] ? cages_valid(&cages[i]) : 1;
+
+            // This thread's own tables; other workers may be on other layouts
+            if (has_regions[i] && layout_ok)
+                build_region_topology(layout, regions[i]);
+            else if (has_cages[i] && layout_ok)
+                build_cage_topology(layout, &cages[i]);
+
+            use_thread_topology(has_regions[i] || has_cages[i] ? layout : NULL);
+
+            if (!(layout_ok && is_grid_valid(grids[i]) && solve_puzzle(grids[i])))
+            {
+                // Unsolvable puzzles are emitted as an all-zero record
+                memset(grids[i], 0, sizeof(grids[i]));
+            }
+
+            writer_append_grid(writer, buffer, grids[i]);
+        }
+
+        writer_submit(writer, buffer, seq);
+        current ^= 1;
+    }
+
+    writer_buffer_wait(writer, &buffers[0]);
+    writer_buffer_wait(writer, &buffers[1]);
+    writer_buffer_free(&buffers[0]);
+    writer_buffer_free(&buffers[1]);
+    use_thread_topology(NULL);
+
+    pthread_mutex_lock(&job->input_lock);
+    job->running--;
+    pthread_mutex_unlock(&job->input_lock);
+
+    free(cages);
+    free(layout);
+    free(has_cages);
+    free(has_regions);
+    free(regions);
+    free(grids);
+
+    return NULL;
+}
+
+/**
+ * Make everything up to now durable and record it as the checkpoint
+ * Output first, then the duplicate journal, then the checkpoint that
+ * refers to both
+ *
+ * Parameters:
+ *   path     - checkpoint file
+ *   progress - state to save (dedup_count is filled in)
+ *   dedup    - duplicate filter to journal (NULL = none)
+ *
+ * Returns: 1 on success, 0 on I/O error (reported on stderr)
+ */
+static int save_checkpoint(const char *path, checkpoint_t *progress, dedup_t *dedup)
+{
+    if (fdatasync(STDOUT_FILENO) != 0 || (dedup != NULL && !dedup_flush(dedup)))
+    {
+        perror("fdatasync");
+        return 0;
+    }
+
+    progress->dedup_count = dedup != NULL ? (long)dedup->count : 0;
+
+    if (!checkpoint_save(path, progress))
+    {
+        fprintf(stderr, "Cannot write checkpoint %s\n", path);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Save a checkpoint of a running solve at the last chunk fully written
+ * Holding input_lock keeps workers from reading (and so from reusing the
+ * mark of) further chunks meanwhile
+ *
+ * Parameters:
+ *   job      - running job
+ *   progress - checkpoint to fill and save
+ *   path     - checkpoint file
+ *   base     - file offset where this run's output started
+ *
+ * Returns: 1 on success or when nothing is written yet, 0 on I/O error
+ */
+static int checkpoint_solve(solve_job_t *job, checkpoint_t *progress, const char *path,
+                            uint64_t base)
+{
+    pthread_mutex_lock(&job->input_lock);
+    pthread_mutex_lock(&job->writer->lock);
+    long written = job->writer->next_seq;
+    uint64_t bytes = job->writer->bytes_written;
+    pthread_mutex_unlock(&job->writer->lock);
+
+    solve_mark_t mark = job->marks[(written - 1 + SOLVE_MARKS) % SOLVE_MARKS];
+    pthread_mutex_unlock(&job->input_lock);
+
+    if (written == 0)
+        return 1; // The first chunk is still being solved
+
+    progress->done = mark.done;
+    progress->input_offset = mark.input_offset;
+    progress->input_line = mark.input_line;
+    progress->skipped = mark.skipped;
+    progress->output_offset = base + bytes;
+
+    return save_checkpoint(path, progress, NULL);
+}
+
+/**
+ * Solve every puzzle in a file and write the solutions in input order
+ * With a checkpoint, the main thread saves the position of the last chunk
+ * fully written every CHECKPOINT_INTERVAL seconds while the workers run
+ *
+ * Parameters:
+ *   path    - puzzle file, or "-" for stdin
+ *   options - thread count, output format and checkpoint
+ *
+ * Returns: 0 on success, 1 on I/O error
+ */
+int batch_solve(const char *path, const batch_options_t *options)
+{
+    reader_t reader;
+    writer_t writer;
+    solve_job_t *job = calloc(1, sizeof(*job));
+    pthread_t threads[BATCH_MAX_THREADS];
+    int thread_count = batch_thread_count(options->threads);
+    checkpoint_t progress;
+    uint64_t base = 0;
+    long failed_saves = 0;
+
+    memset(&progress, 0, sizeof(progress));
+    snprintf(progress.job, sizeof(progress.job), "solve %s format=%d variant=%d", path,
+             (int)options->format, (int)current_topology()->variant);
+
+    if (job == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        free(job);
+        return 1;
+    }
+
+    if (options->checkpoint != NULL)
+    {
+        char expected[CHECKPOINT_JOB_MAX];
+
+        memcpy(expected, progress.job, sizeof(expected));
+
+        if ((options->resume && !checkpoint_load(options->checkpoint, expected, &progress)) ||
+            !checkpoint_output(STDOUT_FILENO, options->resume ? &progress : NULL, &base) ||
+            !reader_seek(&reader, progress.input_offset, progress.input_line, progress.skipped))
+        {
+            reader_close(&reader);
+            free(job);
+            return 1;
+        }
+
+        if (options->resume)
+            fprintf(stderr, "resuming after puzzle %ld (line %ld)\n", progress.done,
+                    progress.input_line);
+    }
+
+    if (!writer_init(&writer, STDOUT_FILENO, options->format))
+    {
+        reader_close(&reader);
+        free(job);
+        return 1;
+    }
+
+    job->reader = &reader;
+    job->writer = &writer;
+    job->next_seq = 0;
+    job->done = progress.done;
+    job->running = thread_count;
+    pthread_mutex_init(&job->input_lock, NULL);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_create(&threads[i], NULL, solve_worker, job);
+    }
+
+    if (options->checkpoint != NULL)
+    {
+        double next_checkpoint = now_seconds() + CHECKPOINT_INTERVAL;
+
+        for (;;)
+        {
+            struct timespec pause = {0, 50 * 1000000L};
+
+            pthread_mutex_lock(&job->input_lock);
+            int running = job->running;
+            pthread_mutex_unlock(&job->input_lock);
+
+            if (running == 0)
+                break;
+
+            nanosleep(&pause, NULL);
+
+            if (now_seconds() >= next_checkpoint)
+            {
+                // A failed save leaves the last good checkpoint; keep solving
+                // and try again at the next interval
+                if (!checkpoint_solve(job, &progress, options->checkpoint, base))
+                    failed_saves++;
+
+                next_checkpoint = now_seconds() + CHECKPOINT_INTERVAL;
+            }
+        }
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (reader.skipped > 0)
+        fprintf(stderr, "Skipped %ld malformed line(s)\n", reader.skipped);
+
+    if (failed_saves > 0)
+        fprintf(stderr, "checkpoint: %ld save(s) failed\n", failed_saves);
+
+    int status = writer.error ? 1 : 0;
+
+    if (writer.error)
+        fprintf(stderr, "Write error on output\n");
+
+    if (options->checkpoint != NULL && status == 0)
+        checkpoint_remove(options->checkpoint);
+
+    pthread_mutex_destroy(&job->input_lock);
+    writer_destroy(&writer);
+    reader_close(&reader);
+    free(job);
+
+    return status;
+}
+
+/**
+ * Validate every puzzle in a file and print a summary
+ *
+ * Parameters:
+ *   path - puzzle file, or "-" for stdin
+ *
+ * Returns: 0 if every puzzle has a unique solution, 1 otherwise
+ */
+int batch_validate(const char *path)
+{
+    reader_t reader;
+    int grid[9][9];
+    long total = 0, unique = 0, multiple = 0, unsolvable = 0, invalid = 0;
+    topology_t *layout = malloc(sizeof(topology_t)); // Tables of a jigsaw or killer puzzle
+
+    if (layout == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        free(layout);
+        return 1;
+    }
+
+    while (reader_next(&reader, grid))
+    {
+        total++;
+
+        // Conflicting givens (or a broken region map) can never be solved
+        if (!apply_puzzle_layout(&reader, layout) || !is_grid_valid(grid))
+        {
+            invalid++;
+            continue;
+        }
+
+        // Killer puzzles (usually no givens) need the pruned search engine
+        long solutions = current_topology()->cage_count > 0 ? count_solutions_limit(grid, 2)
+                                                            : count_solutions(grid);
+
+        switch (solutions)
+        {
+            case 0:
+                unsolvable++;
+                break;
+            case 1:
+                unique++;
+                break;
+            default:
+                multiple++;
+                break;
+        }
+    }
+
+    printf("puzzles:    %ld\n", total);
+    printf("unique:     %ld\n", unique);
+    printf("multiple:   %ld\n", multiple);
+    printf("unsolvable: %ld\n", unsolvable);
+    printf("invalid:    %ld\n", invalid);
+    printf("malformed:  %ld\n", reader.skipped);
+
+    use_thread_topology(NULL);
+    free(layout);
+    reader_close(&reader);
+    return (unique == total && reader.skipped == 0) ? 0 : 1;
+}
+
+/**
+ * Solution callback for batch_enumerate(): append one record, flushing the
+ * buffer through the writer whenever it fills up
+ *
+ * Parameters:
+ *   solution  - complete solution grid
+ *   user_data - enumerate_output_t
+ *
+ * Returns: 1 to keep enumerating
+ */
+static int emit_solution(int solution[9][9], void *user_data)
+{
+    enumerate_output_t *out = user_data;
+
+    if (out->buffer->length + writer_record_size(out->writer) > out->buffer->capacity)
+    {
+        writer_submit(out->writer, out->buffer, out->seq++);
+        writer_buffer_wait(out->writer, out->buffer);
+    }
+
+    writer_append_grid(out->writer, out->buffer, solution);
+    return 1;
+}
+
+/**
+ * Print every solution of every puzzle in a file
+ * Ctrl-C cancels the current enumeration and reports how far it got
+ *
+ * Parameters:
+ *   path    - puzzle file, or "-" for stdin
+ *   options - solution limit and output format
+ *
+ * Returns: 0 on success, 1 on I/O error, 130 if interrupted
+ */
+int batch_enumerate(const char *path, const batch_options_t *options)
+{
+    reader_t reader;
+    writer_t writer;
+    writer_buffer_t buffer;
+    enumerate_output_t out = {&writer, &buffer, 0};
+    struct sigaction action;
+    int grid[9][9];
+    topology_t *layout = malloc(sizeof(topology_t)); // Tables of a jigsaw or killer puzzle
+
+    if (layout == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        free(layout);
+        return 1;
+    }
+
+    if (!writer_init(&writer, STDOUT_FILENO, options->format) ||
+        !writer_buffer_init(&buffer, WRITER_BUFFER_SIZE))
+    {
+        reader_close(&reader);
+        free(layout);
+        return 1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_interrupt;
+    sigaction(SIGINT, &action, NULL);
+
+    while (!interrupted && reader_next(&reader, grid))
+    {
+        if (!apply_puzzle_layout(&reader, layout))
+        {
+            fprintf(stderr, "line %ld: invalid region map or cages\n", reader.line);
+            continue;
+        }
+
+        long count = enumerate_solutions(grid, options->limit, emit_solution, &out, &interrupted);
+
+        fprintf(stderr, "line %ld: %ld solution(s)%s\n", reader.line, count,
+                interrupted ? " (interrupted)" :
+                (options->limit > 0 && count == options->limit) ? " (limit reached)" : "");
+    }
+
+    writer_submit(&writer, &buffer, out.seq);
+    writer_buffer_wait(&writer, &buffer);
+
+    int status = writer.error ? 1 : interrupted ? 130 : 0;
+
+    writer_buffer_free(&buffer);
+    writer_destroy(&writer);
+    reader_close(&reader);
+    use_thread_topology(NULL);
+    free(layout);
+
+    return status;
+}
+
+/**
+ * Count the solutions of every puzzle in a file on all threads
+ * Ctrl-C cancels the current count and reports how far it got
+ *
+ * Parameters:
+ *   path    - puzzle file, or "-" for stdin
+ *   options - solution limit and thread count
+ *
+ * Returns: 0 on success, 1 if the file cannot be read, 130 if interrupted
+ */
+int batch_count(const char *path, const batch_options_t *options)
+{
+    reader_t reader;
+    struct sigaction action;
+    int grid[9][9];
+    long puzzles = 0, tasks = 0, steals = 0;
+    uint64_t nodes = 0;
+    int threads = batch_thread_count(options->threads);
+    double start = now_seconds();
+    topology_t *layout = malloc(sizeof(topology_t)); // Tables of a jigsaw or killer puzzle
+
+    if (layout == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        free(layout);
+        return 1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_interrupt;
+    sigaction(SIGINT, &action, NULL);
+
+    while (!interrupted && reader_next(&reader, grid))
+    {
+        counter_report_t report;
+
+        if (!apply_puzzle_layout(&reader, layout))
+        {
+            fprintf(stderr, "line %ld: invalid region map or cages\n", reader.line);
+            continue;
+        }
+
+        long count = count_solutions_parallel(grid, options->limit, threads, &interrupted, &report);
+
+        printf("line %ld: %ld solution(s)%s\n", reader.line, count,
+               interrupted ? " (interrupted)" :
+               (options->limit > 0 && count == options->limit) ? " (limit reached)" : "");
+
+        puzzles++;
+        tasks += report.tasks;
+        steals += report.steals;
+        nodes += report.nodes;
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "%ld puzzle(s) in %.3f s on %d thread(s): %ld subtasks, %ld stolen, "
+            "%llu nodes\n", puzzles, now_seconds() - start, threads, tasks, steals,
+            (unsigned long long)nodes);
+
+    use_thread_topology(NULL);
+    free(layout);
+    reader_close(&reader);
+
+    return interrupted ? 130 : 0;
+}
+
+/**
+ * Compare two doubles for qsort()
+ *
+ * Parameters:
+ *   a - pointer to first double
+ *   b - pointer to second double
+ *
+ * Returns: negative, zero or positive like strcmp()
+ */
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * Print success rate and time-to-target statistics for --clues generation
+ *
+ * Parameters:
+ *   target  - requested clue count
+ *   count   - puzzles generated
+ *   times   - seconds to reach the target, one per success in this run
+ *   timed   - entries in times (fewer than reached after a resume)
+ *   reached - number of successful puzzles
+ *   passes  - removal passes over all puzzles and threads
+ *   threads - racing threads per puzzle
+ */
+static void print_target_report(int target, long count, double *times, long timed,
+                                long reached, long passes, int threads)
+{
+    fprintf(stderr, "target %d clues: reached %ld/%ld (%.1f%%)  passes/puzzle: %.1f  threads: %d\n",
+            target, reached, count, 100.0 * (double)reached / (double)count,
+            (double)passes / (double)count, threads);
+
+    if (timed == 0)
+        return;
+
+    double sum = 0;
+
+    qsort(times, (size_t)timed, sizeof(double), compare_doubles);
+
+    for (long i = 0; i < timed; i++)
+    {
+        sum += times[i];
+    }
+
+    fprintf(stderr, "time to target: avg %.1f ms  p50 %.1f ms  p90 %.1f ms  max %.1f ms\n",
+            sum * 1000.0 / (double)timed, times[timed / 2] * 1000.0,
+            times[timed * 9 / 10] * 1000.0, times[timed - 1] * 1000.0);
+}
+
+/**
+ * Generate Samurai puzzles and print each as a line of 369 digits
+ * (0 = empty), cells in the order of samurai.h
+ *
+ * Parameters:
+ *   count   - number of puzzles
+ *   options - difficulty; clue targets and binary output do not apply
+ *
+ * Returns: 0 on success, 1 on bad options or write error
+ */
+static int generate_samurai_batch(long count, const batch_options_t *options)
+{
+    int puzzle[SAMURAI_CELLS], solution[SAMURAI_CELLS];
+    char line[SAMURAI_CELLS + 1];
+    long total_clues = 0;
+    int fewest = SAMURAI_CELLS, most = 0;
+
+    if (options->clues > 0 || options->format == WRITER_BINARY)
+    {
+        fprintf(stderr, "Clue targets and binary records do not apply to samurai puzzles\n");
+        return 1;
+    }
+
+    if (count <= 0)
+    {
+        fprintf(stderr, "Nothing to generate\n");
+        return 1;
+    }
+
+    double start = now_seconds();
+    srand((unsigned)time(NULL));
+
+    for (long i = 0; i < count; i++)
+    {
+        int clues = samurai_generate(puzzle, solution, options->difficulty, NULL);
+
+        total_clues += clues;
+        fewest = clues < fewest ? clues : fewest;
+        most = clues > most ? clues : most;
+
+        for (int cell = 0; cell < SAMURAI_CELLS; cell++)
+            line[cell] = (char)('0' + puzzle[cell]);
+        line[SAMURAI_CELLS] = '\n';
+
+        fwrite(line, 1, sizeof(line), stdout);
+    }
+
+    double elapsed = now_seconds() - start;
+
+    fprintf(stderr, "puzzles: %ld  clues: avg %.2f min %d max %d  %.2f ms/puzzle\n", count,
+            (double)total_clues / (double)count, fewest, most, elapsed * 1000.0 / (double)count);
+
+    return fflush(stdout) == 0 && !ferror(stdout) ? 0 : 1;
+}
+
+/**
+ * Hash a generated puzzle with its layout for the duplicate filter
+ * Killer puzzles have no clues, so their cages are the puzzle
+ *
+ * Parameters:
+ *   grid    - clues
+ *   regions - jigsaw layout (NULL = none)
+ *   cages   - killer cages (NULL = none)
+ *
+ * Returns: 64-bit FNV-1a hash
+ */
+static uint64_t puzzle_key(int grid[9][9], const uint8_t *regions, const cage_layout_t *cages)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        hash ^= (uint64_t)grid[cell / 9][cell % 9];
+        hash *= 0x100000001B3ULL;
+
+        if (regions != NULL)
+        {
+            hash ^= (uint64_t)regions[cell] << 8;
+            hash *= 0x100000001B3ULL;
+        }
+    }
+
+    for (int c = 0; cages != NULL && c < cages->count; c++)
+    {
+        hash ^= (uint64_t)cages->cages[c].sum << 16;
+        hash *= 0x100000001B3ULL;
+
+        for (int i = 0; i < cages->cages[c].size; i++)
+        {
+            hash ^= cages->cages[c].cells[i];
+            hash *= 0x100000001B3ULL;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * Generate puzzles and print one per line
+ * With a checkpoint, repeats are dropped and progress is saved every
+ * CHECKPOINT_INTERVAL seconds; a resumed run continues the saved random
+ * stream after the last saved puzzle
+ *
+ * Parameters:
+ *   count   - number of puzzles
+ *   options - difficulty, clue target, minimal flag, symmetry and checkpoint
+ *
+ * Returns: 0 on success, 1 on error
+ */
+int batch_generate(long count, const batch_options_t *options)
+{
+    writer_t writer;
+    writer_buffer_t buffer;
+    generator_options_t generator = {options->difficulty, options->clues, options->symmetry,
+                                     NULL, options->minimal, options->attempts, NULL,
+                                     options->method};
+    restart_options_t race = {options->clues, options->symmetry, options->minimal,
+                              options->threads, options->budget, 0, options->method};
+    generator_report_t report;
+    restart_report_t race_report;
+    int grid[9][9], solution[9][9], given[9][9];
+    checkpoint_t progress;      // Totals so far; saved as the checkpoint
+    dedup_t dedup;
+    uint64_t base = 0;
+    rng_t rng;
+    long timed = 0;
+    int threads = 1;
+    int jigsaw = current_topology()->variant == VARIANT_JIGSAW;
+    int killer = current_topology()->variant == VARIANT_KILLER;
+    uint8_t regions[81];
+    cage_layout_t cages;
+    size_t record_room = TEXT_RECORD_SIZE + (killer ? CAGE_RECORD_MAX : TEXT_RECORD_SIZE);
+
+    if (current_topology()->variant == VARIANT_SAMURAI)
+        return generate_samurai_batch(count, options);
+
+    // An explicit clue target is raced on all threads under a time budget
+    int racing = options->clues > 0;
+    double *times = NULL;
+
+    if (racing && killer)
+    {
+        fprintf(stderr, "Clue targets do not apply to killer puzzles\n");
+        return 1;
+    }
+
+    if (racing && (options->clues < 17 || options->clues > 81))
+    {
+        fprintf(stderr, "Clue target must be between 17 and 81\n");
+        return 1;
+    }
+
+    if (racing && (times = malloc((size_t)(count > 0 ? count : 1) * sizeof(double))) == NULL)
+    {
+        perror("malloc");
+        return 1;
+    }
+
+    if (count <= 0 || !writer_init(&writer, STDOUT_FILENO, WRITER_TEXT) ||
+        !writer_buffer_init(&buffer, WRITER_BUFFER_SIZE))
+    {
+        fprintf(stderr, "Nothing to generate\n");
+        free(times);
+        return 1;
+    }
+
+    memset(&progress, 0, sizeof(progress));
+    memset(&dedup, 0, sizeof(dedup));
+    dedup.journal = -1;
+    progress.fewest = 81;
+    rng_seed(&rng, (uint64_t)time(NULL) * 0x9E3779B97F4A7C15ULL);
+
+    // The settings are part of the job: a resume must not mix two banks
+    snprintf(progress.job, sizeof(progress.job),
+             "generate %ld level=%d variant=%d clues=%d minimal=%d symmetry=%d attempts=%d "
+             "method=%d", count, (int)options->difficulty, (int)current_topology()->variant,
+             options->clues, options->minimal, (int)options->symmetry, options->attempts,
+             (int)options->method);
+
+    if (options->checkpoint != NULL)
+    {
+        char job[CHECKPOINT_JOB_MAX];
+
+        memcpy(job, progress.job, sizeof(job));
+
+        if ((options->resume && !checkpoint_load(options->checkpoint, job, &progress)) ||
+            !dedup_open(&dedup, options->checkpoint, progress.dedup_count) ||
+            !checkpoint_output(STDOUT_FILENO, options->resume ? &progress : NULL, &base))
+        {
+            dedup_close(&dedup);
+            free(times);
+            writer_buffer_free(&buffer);
+            writer_destroy(&writer);
+            return 1;
+        }
+
+        if (options->resume)
+        {
+            rng.state = progress.rng_state;
+            fprintf(stderr, "resuming after puzzle %ld of %ld\n", progress.done, count);
+        }
+    }
+
+    long seq = 0;
+    long first = progress.done;
+    long next = progress.done;  // Index of the next puzzle to keep
+    long failed_saves = 0;      // Checkpoints that could not be written
+    double start = now_seconds();
+    double next_checkpoint = start + CHECKPOINT_INTERVAL;
+
+    generator.rng = &rng;
+
+    while (next < count)
+    {
+        int success;
+
+        // Every jigsaw puzzle is generated on its own region layout
+        if (jigsaw)
+        {
+            generate_regions(regions, &rng);
+            set_current_regions(regions);
+        }
+
+        if (killer)
+        {
+            // Cages replace clues: report each cage split as an attempt
+            report.attempts = 1 + generate_killer_puzzle(grid, solution, given, options->difficulty,
+                                                         &rng, &cages);
+            report.clues = 0;
+            success = 1;
+        }
+        else if (racing)
+        {
+            race.seed = rng_next(&rng);
+
+            success = generate_target_puzzle(grid, solution, given, &race, &race_report);
+
+            report.clues = race_report.clues;
+            report.attempts = (int)race_report.passes;
+            threads = race_report.threads;
+        }
+        else
+        {
+            success = generate_puzzle_ex(grid, solution, given, &generator, &report);
+        }
+
+        // A bank must not hold the same puzzle twice, across resumes too
+        if (options->checkpoint != NULL &&
+            !dedup_insert(&dedup, puzzle_key(grid, jigsaw ? regions : NULL,
+                                             killer ? &cages : NULL)))
+        {
+            progress.duplicates++;
+            continue;
+        }
+
+        if (racing && success)
+            times[timed++] = race_report.seconds;
+
+        progress.reached += success;
+        progress.total_clues += report.clues;
+        progress.total_attempts += report.attempts;
+        progress.fewest = report.clues < progress.fewest ? report.clues : progress.fewest;
+        progress.most = report.clues > progress.most ? report.clues : progress.most;
+
+        // With symmetry, minimality holds per group of cells, not per clue
+        if (options->minimal && options->symmetry == SYMMETRY_NONE &&
+            is_minimal_puzzle(grid, solution))
+            progress.minimal++;
+
+        if (buffer.length + record_room > buffer.capacity)
+        {
+            writer_submit(&writer, &buffer, seq++);
+            writer_buffer_wait(&writer, &buffer);
+        }
+        writer_append_grid(&writer, &buffer, grid);
+
+        if (jigsaw)
+            writer_append_regions(&writer, &buffer, regions);
+        else if (killer)
+            writer_append_cages(&writer, &buffer, &cages);
+
+        next++;
+
+        if (options->checkpoint != NULL && next < count && now_seconds() >= next_checkpoint)
+        {
+            writer_submit(&writer, &buffer, seq++);
+            writer_buffer_wait(&writer, &buffer);
+
+            progress.done = next;
+            progress.rng_state = rng.state;
+            progress.output_offset = base + writer.bytes_written;
+
+            if (writer.error)
+                break;
+
+            // A failed save leaves the last good checkpoint; keep generating
+            // and try again at the next interval
+            if (!save_checkpoint(options->checkpoint, &progress, &dedup))
+                failed_saves++;
+
+            next_checkpoint = now_seconds() + CHECKPOINT_INTERVAL;
+        }
+    }
+
+    writer_submit(&writer, &buffer, seq);
+    writer_buffer_wait(&writer, &buffer);
+
+    double elapsed = now_seconds() - start;
+    long made = next - first;
+    long written = next > 0 ? next : 1; // Puzzles the totals cover, resumed ones included
+
+    fprintf(stderr, "puzzles: %ld  clues: avg %.2f min %d max %d  target reached: %ld  "
+            "passes: %.2f  %.2f ms/puzzle\n",
+            next, (double)progress.total_clues / (double)written, progress.fewest, progress.most,
+            progress.reached, (double)progress.total_attempts / (double)written,
+            elapsed * 1000.0 / (double)(made > 0 ? made : 1));
+
+    if (racing)
+        print_target_report(options->clues, next, times, timed, progress.reached,
+                            progress.total_attempts, threads);
+
+    if (options->minimal && options->symmetry == SYMMETRY_NONE)
+        fprintf(stderr, "minimal: %ld/%ld verified\n", progress.minimal, next);
+
+    if (options->checkpoint != NULL && progress.duplicates > 0)
+        fprintf(stderr, "duplicates: %ld generated and dropped\n", progress.duplicates);
+
+    if (failed_saves > 0)
+        fprintf(stderr, "checkpoint: %ld save(s) failed\n", failed_saves);
+
+    int status = writer.error || next < count ? 1 : 0;
+
+    if (writer.error)
+        fprintf(stderr, "Write error on output\n");
+
+    // A stopped run keeps its last checkpoint; a finished one has no use for it
+    if (options->checkpoint != NULL)
+    {
+        dedup_close(&dedup);
+
+        if (status == 0)
+            checkpoint_remove(options->checkpoint);
+    }
+
+    free(times);
+    writer_buffer_free(&buffer);
+    writer_destroy(&writer);
+
+    return status;
+}
+
+/**
+ * Benchmark the puzzle codec on every puzzle in a file
+ * Loads all puzzles, then times repeated encode and decode passes and checks
+ * that every puzzle survives the round trip
+ *
+ * Parameters:
+ *   path - puzzle file, or "-" for stdin
+ *
+ * Returns: 0 on success, 1 on I/O error or round-trip mismatch
+ */
+int batch_bench_codec(const char *path)
+{
+    reader_t reader;
+    int (*grids)[9][9] = NULL;
+    size_t count = 0, capacity = 0;
+
+    if (!reader_open(&reader, path))
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return 1;
+    }
+
+    for (;;)
+    {
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 4096;
+            grids = realloc(grids, capacity * sizeof(int[9][9]));
+
+            if (grids == NULL)
+            {
+                fprintf(stderr, "Out of memory\n");
+                reader_close(&reader);
+                return 1;
+            }
+        }
+
+        if (!reader_next(&reader, grids[count]))
+            break;
+        count++;
+    }
+    reader_close(&reader);
+
+    if (count == 0)
+    {
+        fprintf(stderr, "No puzzles in %s\n", path);
+        free(grids);
+        return 1;
+    }
+
+    uint8_t *encoded = malloc(count * CODEC_MAX_BYTES);
+    size_t *offsets = malloc((count + 1) * sizeof(size_t));
+
+    if (encoded == NULL || offsets == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        free(grids);
+        free(encoded);
+        free(offsets);
+        return 1;
+    }
+
+    // Repeat passes so small files still measure at least ~1M operations
+    int rounds = (int)(1000000 / count) + 1;
+    double start = now_seconds();
+
+    for (int round = 0; round < rounds; round++)
+    {
+        size_t offset = 0;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            offsets[i] = offset;
+            offset += encode_puzzle(grids[i], encoded + offset);
+        }
+        offsets[count] = offset;
+    }
+
+    double encode_time = now_seconds() - start;
+    int decoded[9][9];
+    size_t mismatches = 0;
+
+    start = now_seconds();
+
+    for (int round = 0; round < rounds; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            decode_puzzle(encoded + offsets[i], offsets[i + 1] - offsets[i], decoded);
+        }
+    }
+
+    double decode_time = now_seconds() - start;
+
+    // Verify the round trip once, outside the timed loops
+    for (size_t i = 0; i < count; i++)
+    {
+        if (decode_puzzle(encoded + offsets[i], offsets[i + 1] - offsets[i], decoded) == 0 ||
+            memcmp(decoded, grids[i], sizeof(decoded)) != 0)
+        {
+            mismatches++;
+        }
+    }
+
+    double operations = (double)count * rounds;
+
+    printf("puzzles:       %zu\n", count);
+    printf("bytes/puzzle:  %.2f (text: 82)\n", (double)offsets[count] / (double)count);
+    printf("encode:        %.2f M/s\n", operations / encode_time / 1e6);
+    printf("decode:        %.2f M/s\n", operations / decode_time / 1e6);
+    printf("round-trip:    %s\n", mismatches == 0 ? "ok" : "MISMATCH");
+
+    // Solution-relative decoding regenerates the grid, so time fewer samples.
+    // Each sample keeps a file puzzle's clue pattern but takes its values from
+    // the solution its own seed produces, as generated puzzles do
+    int seeded_count = 1000;
+    uint8_t (*seeded)[CODEC_SEEDED_BYTES] = malloc(seeded_count * sizeof(*seeded));
+    int (*samples)[2][9][9] = malloc(seeded_count * sizeof(*samples));
+    int solution[9][9];
+    size_t seeded_mismatches = 0;
+
+    if (seeded == NULL || samples == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        free(seeded);
+        free(samples);
+        free(grids);
+        free(encoded);
+        free(offsets);
+        return 1;
+    }
+
+    for (int i = 0; i < seeded_count; i++)
+    {
+        int (*puzzle)[9] = samples[i][0];
+
+        generate_solution_from_seed(samples[i][1], (uint64_t)i);
+
+        for (int row = 0; row < 9; row++)
+        {
+            for (int col = 0; col < 9; col++)
+            {
+                puzzle[row][col] = grids[i % count][row][col] != 0 ? samples[i][1][row][col] : 0;
+            }
+        }
+
+        encode_puzzle_seeded(puzzle, (uint64_t)i, seeded[i]);
+    }
+
+    start = now_seconds();
+
+    for (int i = 0; i < seeded_count; i++)
+    {
+        decode_puzzle_seeded(seeded[i], CODEC_SEEDED_BYTES, decoded, solution);
+    }
+
+    double seeded_time = now_seconds() - start;
+
+    // Verify the seeded round trip outside the timed loop as well
+    for (int i = 0; i < seeded_count; i++)
+    {
+        if (decode_puzzle_seeded(seeded[i], CODEC_SEEDED_BYTES, decoded, solution) == 0 ||
+            memcmp(decoded, samples[i][0], sizeof(decoded)) != 0 ||
+            memcmp(solution, samples[i][1], sizeof(solution)) != 0)
+        {
+            seeded_mismatches++;
+        }
+    }
+
+    printf("seeded:        %d bytes, %.0f decodes/s, %s\n", CODEC_SEEDED_BYTES,
+           seeded_count / seeded_time, seeded_mismatches == 0 ? "ok" : "MISMATCH");
+
+    free(seeded);
+    free(samples);
+    free(grids);
+    free(encoded);
+    free(offsets);
+
+    return mismatches == 0 && seeded_mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Convert every puzzle in a file to another format
+ * Streams the input through the format parser in fixed-size chunks, so any
+ * mix of line, SDK, .ss and JSON input converts in constant memory
+ *
+ * Parameters:
+ *   path    - puzzle file, or "-" for stdin
+ *   options - output format
+ *
+ * Returns: 0 on success, 1 on I/O error
+ */
+int batch_convert(const char *path, const batch_options_t *options)
+{
+    int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    char *buffer = malloc(FORMAT_READ_BUFFER);
+    char record_text[FORMAT_RECORD_MAX];
+    format_parser_t parser;
+    puzzle_record_t record;
+    int status = 0;
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "Cannot open %s\n", path);
+        free(buffer);
+        return 1;
+    }
+
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        if (fd != STDIN_FILENO)
+            close(fd);
+        return 1;
+    }
+
+    format_parser_init(&parser);
+
+    for (;;)
+    {
+        ssize_t got = read(fd, buffer, FORMAT_READ_BUFFER);
+        size_t pos = 0, used;
+
+        if (got < 0 && errno == EINTR)
+            continue; // Interrupted - retry
+
+        if (got < 0)
+        {
+            fprintf(stderr, "Read error on %s\n", path);
+            status = 1;
+            break;
+        }
+
+        if (got == 0)
+        {
+            if (format_finish(&parser, &record))
+                fwrite(record_text, 1, format_puzzle(&record, options->convert, record_text),
+                       stdout);
+            break;
+        }
+
+        while (format_feed(&parser, buffer + pos, (size_t)got - pos, &used, &record))
+        {
+            pos += used;
+            fwrite(record_text, 1, format_puzzle(&record, options->convert, record_text), stdout);
+        }
+    }
+
+    if (parser.skipped > 0)
+        fprintf(stderr, "Skipped %ld malformed puzzle(s)\n", parser.skipped);
+
+    if (fflush(stdout) != 0)
+    {
+        fprintf(stderr, "Write error on output\n");
+        status = 1;
+    }
+
+    if (fd != STDIN_FILENO)
+        close(fd);
+    free(buffer);
+
+    return status;
+}
+
+/**
+ * Print the daily puzzle of a date, built from its seed
+ * Ignores the cache, so the output is the reference for every machine
+ *
+ * Parameters:
+ *   date_text - "YYYY-MM-DD" or "today"
+ *   options   - difficulty
+ *
+ * Returns: 0 on success, 2 for an invalid date
+ */
+int batch_daily(const char *date_text, const batch_options_t *options)
+{
+    const char *rating_names[] = {"easy", "medium", "hard", "expert"};
+    daily_puzzle_t puzzle;
+    char line[83];
+    long date;
+
+    if (strcmp(date_text, "today") == 0)
+    {
+        date = daily_today();
+    }
+    else if (!parse_daily_date(date_text, &date))
+    {
+        fprintf(stderr, "Invalid date %s (expected YYYY-MM-DD)\n", date_text);
+        return 2;
+    }
+
+    set_current_variant(VARIANT_CLASSIC); // Daily puzzles are classic
+    daily_generate(date, options->difficulty, &puzzle, NULL);
+
+    for (int cell = 0; cell < 81; cell++)
+        line[cell] = (char)('0' + puzzle.grid[cell / 9][cell % 9]);
+    line[81] = '\n';
+    line[82] = '\0';
+
+    fputs(line, stdout);
+    fprintf(stderr, "daily %04ld-%02ld-%02ld  rated %s\n", date / 10000, date / 100 % 100,
+            date % 100, rating_names[rate_puzzle(puzzle.grid, NULL)]);
+    return 0;
+}
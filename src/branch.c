@@ -0,0 +1,192 @@
+#include "../include/sudoku.h"
+#include "../include/branch.h"
+
+/**
+ * Start with no branches and an empty journal
+ *
+ * Parameters:
+ *   game - game state whose journal is initialized
+ */
+void init_branches(game_state_t *game)
+{
+    memset(&game->journal, 0, sizeof(game->journal));
+}
+
+/**
+ * Close every branch, keeping the current state
+ *
+ * Parameters:
+ *   game - game state
+ */
+void clear_branches(game_state_t *game)
+{
+    game->journal.length = 0;
+    game->journal.depth = 0;
+}
+
+/**
+ * Release the journal storage
+ *
+ * Parameters:
+ *   game - game state
+ */
+void free_branches(game_state_t *game)
+{
+    free(game->journal.entries);
+    free(game->journal.points);
+    init_branches(game);
+}
+
+/**
+ * Append the current number and marks of a cell to the journal
+ *
+ * Parameters:
+ *   game - game state with at least one open branch
+ *   row  - cell row (0-8)
+ *   col  - cell column (0-8)
+ */
+void journal_cell(game_state_t *game, int row, int col)
+{
+    branch_journal_t *journal = &game->journal;
+
+    if (journal->length == journal->capacity)
+    {
+        int capacity = journal->capacity ? journal->capacity * 2 : BRANCH_JOURNAL_INITIAL;
+        journal_entry_t *entries = realloc(journal->entries, (size_t)capacity * sizeof(*entries));
+
+        if (entries == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+
+        journal->entries = entries;
+        journal->capacity = capacity;
+    }
+
+    journal_entry_t *entry = &journal->entries[journal->length++];
+    uint16_t marks = 0;
+
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        if (game->marks[row][col][i])
+            marks |= (uint16_t)(1u << i);
+    }
+
+    entry->cell = (uint8_t)(row * 9 + col);
+    entry->value = (uint8_t)game->grid[row][col];
+    entry->marks = marks;
+}
+
+/**
+ * Open a branch on top of the current state
+ *
+ * Parameters:
+ *   game - game state
+ *
+ * Returns: new branch depth, or 0 if out of memory
+ */
+int open_branch(game_state_t *game)
+{
+    branch_journal_t *journal = &game->journal;
+
+    if (journal->depth == journal->point_capacity)
+    {
+        int capacity = journal->point_capacity ? journal->point_capacity * 2 : BRANCH_POINTS_INITIAL;
+        branch_point_t *points = realloc(journal->points, (size_t)capacity * sizeof(*points));
+
+        if (points == NULL)
+            return 0;
+
+        journal->points = points;
+        journal->point_capacity = capacity;
+    }
+
+    branch_point_t *point = &journal->points[journal->depth++];
+
+    point->length = journal->length;
+    point->cursor_row = game->cursor_row;
+    point->cursor_col = game->cursor_col;
+    point->show_marks = game->show_marks;
+    point->moves = game->moves;
+    point->is_completed = game->is_completed;
+    point->is_paused = game->is_paused;
+    point->start_time = game->start_time;
+    point->pause_time = game->pause_time;
+    point->completion_time = game->completion_time;
+    point->opened_at = time(NULL);
+
+    return journal->depth;
+}
+
+/**
+ * Discard the innermost branch, restoring the state it was opened on
+ *
+ * Parameters:
+ *   game - game state
+ *
+ * Returns: 1 if a branch was discarded, 0 if none was open
+ */
+int discard_branch(game_state_t *game)
+{
+    branch_journal_t *journal = &game->journal;
+
+    if (journal->depth == 0)
+        return 0;
+
+    const branch_point_t *point = &journal->points[--journal->depth];
+
+    // Newest first, so a cell changed twice ends with its oldest record
+    while (journal->length > point->length)
+    {
+        const journal_entry_t *entry = &journal->entries[--journal->length];
+        int row = entry->cell / 9, col = entry->cell % 9;
+
+        game->grid[row][col] = entry->value;
+
+        for (int i = 0; i < GRID_SIZE; i++)
+            game->marks[row][col][i] = (entry->marks >> i) & 1;
+    }
+
+    game->cursor_row = point->cursor_row;
+    game->cursor_col = point->cursor_col;
+    game->show_marks = point->show_marks;
+    game->moves = point->moves;
+    game->is_completed = point->is_completed;
+    game->is_paused = point->is_paused;
+    game->start_time = point->start_time;
+    game->pause_time = point->pause_time;
+    game->completion_time = point->completion_time;
+
+    // A running timer shows the reading it had at the branch point; a
+    // paused, finished or unstarted one is frozen and needs no shift
+    if (game->start_time != 0 && !game->is_paused && game->completion_time == 0)
+        game->start_time += time(NULL) - point->opened_at;
+
+    return 1;
+}
+
+/**
+ * Keep the innermost branch
+ *
+ * Parameters:
+ *   game - game state
+ *
+ * Returns: 1 if a branch was kept, 0 if none was open
+ */
+int merge_branch(game_state_t *game)
+{
+    branch_journal_t *journal = &game->journal;
+
+    if (journal->depth == 0)
+        return 0;
+
+    journal->depth--;
+
+    // The parent keeps the records so discarding it still undoes them; the
+    // main line has nothing to undo to
+    if (journal->depth == 0)
+        journal->length = 0;
+
+    return 1;
+}
@@ -0,0 +1,462 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/checkpoint.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CHECKPOINT_TEXT_MAX 1024        // Longest checkpoint file
+#define DEDUP_READ_HASHES 8192          // Journal hashes read per read() call
+
+/**
+ * Hash text with 64-bit FNV-1a
+ *
+ * Parameters:
+ *   data   - bytes to hash
+ *   length - number of bytes
+ *
+ * Returns: hash of the bytes and CHECKPOINT_VERSION
+ */
+static uint64_t text_hash(const char *data, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    hash ^= CHECKPOINT_VERSION;
+    hash *= 0x100000001B3ULL;
+    return hash;
+}
+
+/**
+ * Write a whole buffer, retrying after partial writes
+ *
+ * Parameters:
+ *   fd     - destination
+ *   data   - bytes to write
+ *   length - number of bytes
+ *
+ * Returns: 1 on success, 0 on write error
+ */
+static int write_fully(int fd, const void *data, size_t length)
+{
+    const char *next = data;
+
+    while (length > 0)
+    {
+        ssize_t written = write(fd, next, length);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue; // Interrupted - retry
+            return 0;
+        }
+
+        next += written;
+        length -= (size_t)written;
+    }
+
+    return 1;
+}
+
+/**
+ * Write a checkpoint atomically
+ *
+ * Parameters:
+ *   path       - checkpoint file
+ *   checkpoint - state to save
+ *
+ * Returns: 1 on success, 0 on I/O error
+ */
+int checkpoint_save(const char *path, const checkpoint_t *checkpoint)
+{
+    char text[CHECKPOINT_TEXT_MAX];
+    char temporary[CHECKPOINT_PATH_MAX + 32];
+    int length = snprintf(text, sizeof(text),
+                          "sudoku-checkpoint %d\n"
+                          "job %s\n"
+                          "done %ld\n"
+                          "input_offset %llu\n"
+                          "input_line %ld\n"
+                          "skipped %ld\n"
+                          "output_offset %llu\n"
+                          "rng %016llx\n"
+                          "dedup %ld\n"
+                          "duplicates %ld\n"
+                          "clues %ld\n"
+                          "attempts %ld\n"
+                          "reached %ld\n"
+                          "minimal %ld\n"
+                          "fewest %d\n"
+                          "most %d\n",
+                          CHECKPOINT_VERSION, checkpoint->job, checkpoint->done,
+                          (unsigned long long)checkpoint->input_offset, checkpoint->input_line,
+                          checkpoint->skipped, (unsigned long long)checkpoint->output_offset,
+                          (unsigned long long)checkpoint->rng_state, checkpoint->dedup_count,
+                          checkpoint->duplicates, checkpoint->total_clues,
+                          checkpoint->total_attempts, checkpoint->reached, checkpoint->minimal,
+                          checkpoint->fewest, checkpoint->most);
+
+    length += snprintf(text + length, sizeof(text) - (size_t)length, "hash %016llx\n",
+                       (unsigned long long)text_hash(text, (size_t)length));
+
+    snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", path, (long)getpid());
+
+    int fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        return 0;
+
+    // Contents must be on disk before the rename makes them the checkpoint
+    int ok = write_fully(fd, text, (size_t)length) && fdatasync(fd) == 0;
+
+    ok &= close(fd) == 0;
+
+    if (!ok || rename(temporary, path) != 0)
+    {
+        remove(temporary);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Read a checkpoint and verify its hash and job
+ *
+ * Parameters:
+ *   path       - checkpoint file
+ *   job        - job description the checkpoint must belong to
+ *   checkpoint - receives the state
+ *
+ * Returns: 1 if a matching checkpoint was read, 0 otherwise
+ */
+int checkpoint_load(const char *path, const char *job, checkpoint_t *checkpoint)
+{
+    char text[CHECKPOINT_TEXT_MAX + 1];
+    unsigned long long input_offset, output_offset, rng_state, hash;
+    int version;
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "No checkpoint to resume: %s\n", path);
+        return 0;
+    }
+
+    size_t length = fread(text, 1, CHECKPOINT_TEXT_MAX, file);
+    fclose(file);
+    text[length] = '\0';
+
+    // The hash line covers everything before it
+    char *hash_line = strstr(text, "\nhash ");
+
+    if (hash_line == NULL || sscanf(hash_line + 6, "%16llx", &hash) != 1 ||
+        hash != text_hash(text, (size_t)(hash_line + 1 - text)))
+    {
+        fprintf(stderr, "Checkpoint %s is damaged or from another version\n", path);
+        return 0;
+    }
+
+    memset(checkpoint, 0, sizeof(*checkpoint));
+
+    if (sscanf(text,
+               "sudoku-checkpoint %d job %255[^\n] done %ld input_offset %llu input_line %ld "
+               "skipped %ld output_offset %llu rng %llx dedup %ld duplicates %ld clues %ld "
+               "attempts %ld reached %ld minimal %ld fewest %d most %d",
+               &version, checkpoint->job, &checkpoint->done, &input_offset,
+               &checkpoint->input_line, &checkpoint->skipped, &output_offset, &rng_state,
+               &checkpoint->dedup_count, &checkpoint->duplicates, &checkpoint->total_clues,
+               &checkpoint->total_attempts, &checkpoint->reached, &checkpoint->minimal,
+               &checkpoint->fewest, &checkpoint->most) != 16 ||
+        version != CHECKPOINT_VERSION)
+    {
+        fprintf(stderr, "Checkpoint %s is damaged or from another version\n", path);
+        return 0;
+    }
+
+    if (strcmp(checkpoint->job, job) != 0)
+    {
+        fprintf(stderr, "Checkpoint %s belongs to another job: %s\n", path, checkpoint->job);
+        return 0;
+    }
+
+    checkpoint->input_offset = input_offset;
+    checkpoint->output_offset = output_offset;
+    checkpoint->rng_state = rng_state;
+    return 1;
+}
+
+/**
+ * Delete a checkpoint and its duplicate journal
+ *
+ * Parameters:
+ *   path - checkpoint file
+ */
+void checkpoint_remove(const char *path)
+{
+    char journal[CHECKPOINT_PATH_MAX + 8];
+
+    snprintf(journal, sizeof(journal), "%s.dedup", path);
+    remove(journal);
+    remove(path);
+}
+
+/**
+ * Prepare the output file of a checkpointed job
+ *
+ * Parameters:
+ *   fd     - output descriptor
+ *   resume - checkpoint being resumed (NULL = fresh run)
+ *   base   - receives the file offset of the next output byte
+ *
+ * Returns: 1 on success, 0 if the output cannot be checkpointed
+ */
+int checkpoint_output(int fd, const checkpoint_t *resume, uint64_t *base)
+{
+    struct stat info;
+
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        fprintf(stderr, "Checkpoints need the output redirected to a regular file\n");
+        return 0;
+    }
+
+    if (resume == NULL)
+    {
+        // Appended output starts at the end, anything else at the file position
+        int flags = fcntl(fd, F_GETFL);
+        off_t start = (flags >= 0 && (flags & O_APPEND)) ? info.st_size : lseek(fd, 0, SEEK_CUR);
+
+        if (start < 0)
+        {
+            perror("lseek");
+            return 0;
+        }
+
+        *base = (uint64_t)start;
+        return 1;
+    }
+
+    if ((uint64_t)info.st_size < resume->output_offset)
+    {
+        fprintf(stderr, "Output has %lld bytes but the checkpoint covers %llu; "
+                "resume with >> instead of >\n",
+                (long long)info.st_size, (unsigned long long)resume->output_offset);
+        return 0;
+    }
+
+    // Records written after the checkpoint are produced again
+    if (ftruncate(fd, (off_t)resume->output_offset) != 0 ||
+        lseek(fd, (off_t)resume->output_offset, SEEK_SET) < 0)
+    {
+        perror("ftruncate");
+        return 0;
+    }
+
+    *base = resume->output_offset;
+    return 1;
+}
+
+/**
+ * Insert a hash into the table, growing it at half load
+ *
+ * Parameters:
+ *   dedup - open filter
+ *   hash  - non-zero hash
+ *
+ * Returns: 1 if the hash is new, 0 if it was present
+ */
+static int table_insert(dedup_t *dedup, uint64_t hash)
+{
+    if (2 * (dedup->count + 1) > dedup->capacity)
+    {
+        size_t capacity = dedup->capacity ? 2 * dedup->capacity : DEDUP_INITIAL_SLOTS;
+        uint64_t *slots = calloc(capacity, sizeof(uint64_t));
+
+        if (slots == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+
+        for (size_t i = 0; i < dedup->capacity; i++)
+        {
+            if (dedup->slots[i] == 0)
+                continue;
+
+            size_t slot = dedup->slots[i] & (capacity - 1);
+
+            while (slots[slot] != 0)
+                slot = (slot + 1) & (capacity - 1);
+
+            slots[slot] = dedup->slots[i];
+        }
+
+        free(dedup->slots);
+        dedup->slots = slots;
+        dedup->capacity = capacity;
+    }
+
+    size_t slot = hash & (dedup->capacity - 1);
+
+    while (dedup->slots[slot] != 0)
+    {
+        if (dedup->slots[slot] == hash)
+            return 0;
+
+        slot = (slot + 1) & (dedup->capacity - 1);
+    }
+
+    dedup->slots[slot] = hash;
+    dedup->count++;
+    return 1;
+}
+
+/**
+ * Open the duplicate filter of a checkpoint
+ *
+ * Parameters:
+ *   dedup - filter to initialize
+ *   path  - checkpoint file
+ *   keep  - hashes to keep from the journal
+ *
+ * Returns: 1 on success, 0 on I/O error or a short journal
+ */
+int dedup_open(dedup_t *dedup, const char *path, long keep)
+{
+    char journal[CHECKPOINT_PATH_MAX + 8];
+    uint64_t *hashes = malloc(DEDUP_READ_HASHES * sizeof(uint64_t));
+    long loaded = 0;
+
+    memset(dedup, 0, sizeof(*dedup));
+    snprintf(journal, sizeof(journal), "%s.dedup", path);
+    dedup->journal = open(journal, O_RDWR | O_CREAT, 0644);
+
+    if (dedup->journal < 0 || hashes == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", journal);
+        free(hashes);
+        dedup_close(dedup);
+        return 0;
+    }
+
+    while (loaded < keep)
+    {
+        long want = keep - loaded < DEDUP_READ_HASHES ? keep - loaded : DEDUP_READ_HASHES;
+        ssize_t got = read(dedup->journal, hashes, (size_t)want * sizeof(uint64_t));
+
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got <= 0 || got % sizeof(uint64_t) != 0)
+            break;
+
+        for (long i = 0; i < got / (ssize_t)sizeof(uint64_t); i++)
+            table_insert(dedup, hashes[i]);
+
+        loaded += got / (ssize_t)sizeof(uint64_t);
+    }
+
+    free(hashes);
+
+    if (loaded < keep)
+    {
+        fprintf(stderr, "Duplicate journal %s is shorter than its checkpoint\n", journal);
+        dedup_close(dedup);
+        return 0;
+    }
+
+    // Hashes journaled after the checkpoint belong to puzzles that are cut
+    if (ftruncate(dedup->journal, (off_t)keep * (off_t)sizeof(uint64_t)) != 0 ||
+        lseek(dedup->journal, 0, SEEK_END) < 0)
+    {
+        perror("ftruncate");
+        dedup_close(dedup);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Add a hash to the duplicate filter
+ *
+ * Parameters:
+ *   dedup - open filter
+ *   hash  - 64-bit hash of a puzzle
+ *
+ * Returns: 1 if the hash is new, 0 if it was seen before
+ */
+int dedup_insert(dedup_t *dedup, uint64_t hash)
+{
+    hash += hash == 0; // 0 marks a free slot
+
+    if (!table_insert(dedup, hash))
+        return 0;
+
+    if (dedup->pending_count == dedup->pending_capacity)
+    {
+        size_t capacity = dedup->pending_capacity ? 2 * dedup->pending_capacity : 1024;
+        uint64_t *pending = realloc(dedup->pending, capacity * sizeof(uint64_t));
+
+        if (pending == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+
+        dedup->pending = pending;
+        dedup->pending_capacity = capacity;
+    }
+
+    dedup->pending[dedup->pending_count++] = hash;
+    return 1;
+}
+
+/**
+ * Append the new hashes to the journal and sync it
+ * The hashes go right after the ones already synced, so a retry after a
+ * failed flush overwrites whatever part of them reached the file
+ *
+ * Parameters:
+ *   dedup - open filter
+ *
+ * Returns: 1 on success, 0 on I/O error
+ */
+int dedup_flush(dedup_t *dedup)
+{
+    off_t synced = (off_t)(dedup->count - dedup->pending_count) * (off_t)sizeof(uint64_t);
+
+    if (lseek(dedup->journal, synced, SEEK_SET) < 0 ||
+        !write_fully(dedup->journal, dedup->pending, dedup->pending_count * sizeof(uint64_t)) ||
+        fdatasync(dedup->journal) != 0)
+        return 0;
+
+    dedup->pending_count = 0;
+    return 1;
+}
+
+/**
+ * Free the filter and close its journal
+ *
+ * Parameters:
+ *   dedup - filter to close
+ */
+void dedup_close(dedup_t *dedup)
+{
+    if (dedup->journal >= 0)
+        close(dedup->journal);
+
+    free(dedup->slots);
+    free(dedup->pending);
+    memset(dedup, 0, sizeof(*dedup));
+    dedup->journal = -1;
+}
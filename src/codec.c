@@ -0,0 +1,210 @@
+#include "../include/sudoku.h"
+#include "../include/codec.h"
+#include "../include/generator.h"
+
+/**
+ * Number of bytes encode_puzzle() needs for a given clue count
+ *
+ * Parameters:
+ *   clues - number of given cells
+ *
+ * Returns: encoded size in bytes
+ */
+size_t encoded_puzzle_size(int clues)
+{
+    int tail = clues % 5;
+
+    // 9^2 = 81 fits one byte, 9^4 = 6561 needs two
+    return CODEC_MASK_BYTES + 2 * (size_t)(clues / 5) + (tail == 0 ? 0 : tail <= 2 ? 1 : 2);
+}
+
+/**
+ * Write the 81-bit given mask of a grid
+ *
+ * Parameters:
+ *   grid - 9x9 grid (non-zero cells are set in the mask)
+ *   out  - destination for CODEC_MASK_BYTES bytes
+ *
+ * Returns: number of set cells
+ */
+static int write_mask(int grid[9][9], uint8_t *out)
+{
+    const int *cells = &grid[0][0];
+    int clues = 0;
+
+    memset(out, 0, CODEC_MASK_BYTES);
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (cells[cell] != 0)
+        {
+            out[cell >> 3] |= (uint8_t)(1u << (cell & 7));
+            clues++;
+        }
+    }
+
+    return clues;
+}
+
+/**
+ * Encode a puzzle as given mask + base-9 packed clue values
+ *
+ * Parameters:
+ *   grid - 9x9 puzzle
+ *   out  - destination buffer (CODEC_MAX_BYTES)
+ *
+ * Returns: number of bytes written
+ */
+size_t encode_puzzle(int grid[9][9], uint8_t *out)
+{
+    const int *cells = &grid[0][0];
+    uint8_t *pos = out + CODEC_MASK_BYTES;
+    uint32_t group = 0;
+    int in_group = 0;
+
+    write_mask(grid, out);
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (cells[cell] == 0)
+            continue;
+
+        // Most significant digit first: group = group * 9 + digit
+        group = group * 9 + (uint32_t)(cells[cell] - 1);
+        in_group++;
+
+        if (in_group == 5)
+        {
+            *pos++ = (uint8_t)group;
+            *pos++ = (uint8_t)(group >> 8);
+            group = 0;
+            in_group = 0;
+        }
+    }
+
+    if (in_group > 0)
+    {
+        *pos++ = (uint8_t)group;
+
+        if (in_group > 2)
+            *pos++ = (uint8_t)(group >> 8);
+    }
+
+    return (size_t)(pos - out);
+}
+
+/**
+ * Decode a puzzle produced by encode_puzzle()
+ *
+ * Parameters:
+ *   in     - encoded bytes
+ *   length - bytes available
+ *   grid   - 9x9 array that receives the puzzle
+ *
+ * Returns: bytes consumed, or 0 if truncated or corrupt
+ */
+size_t decode_puzzle(const uint8_t *in, size_t length, int grid[9][9])
+{
+    int *cells = &grid[0][0];
+    int positions[81];
+    int clues = 0;
+
+    if (length < CODEC_MASK_BYTES || (in[CODEC_MASK_BYTES - 1] & 0xFE) != 0)
+        return 0; // Truncated, or bits set beyond cell 80
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        cells[cell] = 0;
+
+        if (in[cell >> 3] & (1u << (cell & 7)))
+            positions[clues++] = cell;
+    }
+
+    size_t size = encoded_puzzle_size(clues);
+
+    if (length < size)
+        return 0; // Clue values truncated
+
+    const uint8_t *pos = in + CODEC_MASK_BYTES;
+
+    for (int first = 0; first < clues; first += 5)
+    {
+        int count = clues - first < 5 ? clues - first : 5;
+        uint32_t group = pos[0];
+
+        if (count > 2)
+            group |= (uint32_t)pos[1] << 8;
+        pos += (count > 2) ? 2 : 1;
+
+        // Digits come out least significant (last clue) first
+        for (int i = count - 1; i >= 0; i--)
+        {
+            cells[positions[first + i]] = (int)(group % 9) + 1;
+            group /= 9;
+        }
+
+        if (group != 0)
+            return 0; // Value out of range for this group size
+    }
+
+    return size;
+}
+
+/**
+ * Encode a solution-relative puzzle (seed + given mask)
+ *
+ * Parameters:
+ *   given - 9x9 clue markers
+ *   seed  - seed that reproduces the solution
+ *   out   - destination buffer (CODEC_SEEDED_BYTES)
+ *
+ * Returns: number of bytes written
+ */
+size_t encode_puzzle_seeded(int given[9][9], uint64_t seed, uint8_t *out)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        out[i] = (uint8_t)(seed >> (8 * i));
+    }
+
+    write_mask(given, out + 8);
+    return CODEC_SEEDED_BYTES;
+}
+
+/**
+ * Decode a solution-relative puzzle by regenerating its solution
+ *
+ * Parameters:
+ *   in       - encoded bytes
+ *   length   - bytes available
+ *   grid     - 9x9 array that receives the puzzle
+ *   solution - 9x9 array that receives the solution
+ *
+ * Returns: bytes consumed, or 0 if truncated
+ */
+size_t decode_puzzle_seeded(const uint8_t *in, size_t length, int grid[9][9], int solution[9][9])
+{
+    uint64_t seed = 0;
+
+    if (length < CODEC_SEEDED_BYTES)
+        return 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        seed |= (uint64_t)in[i] << (8 * i);
+    }
+
+    if (!generate_solution_from_seed(solution, seed))
+        return 0;
+
+    const uint8_t *mask = in + 8;
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int is_given = (mask[cell >> 3] >> (cell & 7)) & 1;
+
+        grid[cell / 9][cell % 9] = is_given ? solution[cell / 9][cell % 9] : 0;
+    }
+
+    return CODEC_SEEDED_BYTES;
+}
@@ -0,0 +1,575 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/counter.h"
+#include "../include/batch.h"
+#include "../include/search.h"
+#include "../include/solver.h"
+#include "../include/topology.h"
+#include <pthread.h>
+
+#define COUNTER_PUBLISH_MAX 1024        // Largest batch of solutions published at once
+
+typedef struct
+{
+    uint8_t cells[81];          // Grid of the subtask (0 = empty)
+    uint8_t depth;              // Cells fixed beyond the original grid
+} counter_task_t;
+
+typedef struct
+{
+    pthread_mutex_t lock;       // Guards everything below
+    counter_task_t *tasks;      // Subtasks in [top, bottom)
+    size_t top;                 // Oldest subtask; thieves take from here
+    size_t bottom;              // One past the newest; the owner takes from here
+    size_t capacity;            // Subtasks allocated
+} counter_deque_t;
+
+typedef struct
+{
+    counter_deque_t deques[COUNTER_MAX_THREADS]; // One per worker
+    int threads;                // Workers running
+    const topology_t *topology; // Rules of the caller, shared by all workers
+
+    pthread_mutex_t lock;       // Guards pending, available and idle
+    pthread_cond_t work;        // Signalled when subtasks arrive or all are done
+    long pending;               // Subtasks created and not yet finished
+    long available;             // Subtasks waiting in deques
+    int idle;                   // Workers waiting for work (read unlocked as a hint)
+
+    long limit;                 // Solutions wanted (0 = all)
+    long publish;               // Solutions a worker counts before publishing
+    long published;             // Solutions published so far (atomic)
+    volatile int stop;          // Set once the limit is reached or on cancel
+    const volatile int *cancel; // Caller's cancel flag (may be NULL)
+} counter_pool_t;
+
+typedef struct
+{
+    counter_pool_t *pool;       // Shared pool
+    int index;                  // This worker's deque
+    long count;                 // Solutions counted by this worker
+    long steals;                // Subtasks taken from other deques
+    long splits;                // Subtasks this worker created by splitting
+    uint64_t nodes;             // Search nodes placed by this worker
+} counter_worker_t;
+
+/**
+ * Split a subtask on its empty cell with the fewest candidates
+ *
+ * Parameters:
+ *   task     - subtask to split
+ *   children - receives one subtask per candidate digit (up to 9)
+ *
+ * Returns: number of children (0 = a cell has no candidate), or -1 if the
+ *          grid is full or its best cell is forced, so a split would not
+ *          share anything
+ */
+static int split_task(const counter_task_t *task, counter_task_t children[9])
+{
+    int grid[9][9];
+    int best = -1, best_count = 10;
+    uint16_t best_digits = 0;
+
+    for (int cell = 0; cell < 81; cell++)
+        grid[cell / 9][cell % 9] = task->cells[cell];
+
+    for (int cell = 0; cell < 81 && best_count > 1; cell++)
+    {
+        uint16_t digits = 0;
+        int count = 0;
+
+        if (task->cells[cell] != 0)
+            continue;
+
+        for (int num = 1; num <= 9; num++)
+        {
+            if (is_valid_placement(grid, cell / 9, cell % 9, num))
+            {
+                digits |= (uint16_t)(1u << num);
+                count++;
+            }
+        }
+
+        if (count < best_count)
+        {
+            best = cell;
+            best_count = count;
+            best_digits = digits;
+        }
+    }
+
+    if (best < 0 || best_count == 1)
+        return -1;
+
+    int made = 0;
+
+    for (int num = 1; num <= 9; num++)
+    {
+        if (!(best_digits & (1u << num)))
+            continue;
+
+        children[made] = *task;
+        children[made].cells[best] = (uint8_t)num;
+        children[made].depth = (uint8_t)(task->depth + 1);
+        made++;
+    }
+
+    return made;
+}
+
+/**
+ * Add subtasks to the newest end of a worker's deque and wake idle workers
+ *
+ * Parameters:
+ *   pool  - shared pool
+ *   index - deque to add to
+ *   tasks - subtasks
+ *   count - number of subtasks
+ */
+static void push_tasks(counter_pool_t *pool, int index, const counter_task_t *tasks, int count)
+{
+    counter_deque_t *deque = &pool->deques[index];
+
+    pthread_mutex_lock(&deque->lock);
+
+    if (deque->bottom + (size_t)count > deque->capacity)
+    {
+        // Slide the live range to the front, growing only when that is not enough
+        size_t live = deque->bottom - deque->top;
+
+        memmove(deque->tasks, deque->tasks + deque->top, live * sizeof(counter_task_t));
+        deque->top = 0;
+        deque->bottom = live;
+
+        if (live + (size_t)count > deque->capacity)
+        {
+            size_t capacity = 2 * (live + (size_t)count);
+            counter_task_t *tasks_grown = realloc(deque->tasks, capacity * sizeof(counter_task_t));
+
+            if (tasks_grown == NULL)
+            {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
+
+            deque->tasks = tasks_grown;
+            deque->capacity = capacity;
+        }
+    }
+
+    memcpy(deque->tasks + deque->bottom, tasks, (size_t)count * sizeof(counter_task_t));
+    deque->bottom += (size_t)count;
+    pthread_mutex_unlock(&deque->lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->available += count;
+    if (pool->idle > 0)
+        pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Take a subtask: the newest of the worker's own, else the oldest of another's
+ *
+ * Parameters:
+ *   worker - worker looking for work
+ *   task   - receives the subtask
+ *
+ * Returns: 1 if a subtask was taken, 0 if every deque looked empty
+ */
+static int take_task(counter_worker_t *worker, counter_task_t *task)
+{
+    counter_pool_t *pool = worker->pool;
+    int taken = 0;
+
+    for (int i = 0; i < pool->threads && !taken; i++)
+    {
+        int victim = (worker->index + i) % pool->threads;
+        counter_deque_t *deque = &pool->deques[victim];
+
+        pthread_mutex_lock(&deque->lock);
+
+        if (deque->bottom > deque->top)
+        {
+            // Own work depth-first; stolen work is the largest subtask left
+            *task = victim == worker->index ? deque->tasks[--deque->bottom]
+                                            : deque->tasks[deque->top++];
+            taken = 1;
+            worker->steals += victim != worker->index;
+        }
+
+        pthread_mutex_unlock(&deque->lock);
+    }
+
+    if (taken)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pool->available--;
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return taken;
+}
+
+/**
+ * Mark subtasks as finished, waking everyone when the last one is done
+ *
+ * Parameters:
+ *   pool     - shared pool
+ *   finished - subtasks finished
+ *   created  - subtasks created meanwhile (by splitting)
+ */
+static void finish_tasks(counter_pool_t *pool, long finished, long created)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->pending += created - finished;
+    if (pool->pending == 0)
+        pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Add solutions to the shared total and stop everyone at the limit
+ *
+ * Parameters:
+ *   pool  - shared pool
+ *   count - solutions to publish
+ */
+static void publish_solutions(counter_pool_t *pool, long count)
+{
+    if (count == 0)
+        return;
+
+    if (__atomic_add_fetch(&pool->published, count, __ATOMIC_RELAXED) >= pool->limit)
+        pool->stop = 1;
+}
+
+/**
+ * Turn the shallowest untried digits of a running count into subtasks
+ *
+ * Parameters:
+ *   search   - paused search over the subtask
+ *   task     - subtask being counted
+ *   children - receives one subtask per digit handed off (up to 9)
+ *
+ * Returns: number of children (0 = nothing left to hand off)
+ */
+static int hand_off(search_t *search, const counter_task_t *task, counter_task_t children[9])
+{
+    int cells[81], cell;
+    uint16_t digits;
+    int frames = search_hand_off(search, COUNTER_SPLIT_DEPTH - task->depth, cells, &cell, &digits);
+    int made = 0;
+
+    if (frames < 0)
+        return 0;
+
+    for (int num = 1; num <= 9; num++)
+    {
+        if (!(digits & (1u << (num - 1))))
+            continue;
+
+        for (int i = 0; i < 81; i++)
+            children[made].cells[i] = (uint8_t)cells[i];
+
+        children[made].cells[cell] = (uint8_t)num;
+        children[made].depth = (uint8_t)(task->depth + frames + 1);
+        made++;
+    }
+
+    return made;
+}
+
+/**
+ * Count the solutions of one subtask
+ *
+ * Parameters:
+ *   worker - worker doing the count
+ *   search - search state to use
+ *   task   - subtask to count
+ */
+static void count_task(counter_worker_t *worker, search_t *search, const counter_task_t *task)
+{
+    counter_pool_t *pool = worker->pool;
+    int grid[9][9];
+    long unpublished = 0;
+    counter_task_t children[9];
+
+    for (int cell = 0; cell < 81; cell++)
+        grid[cell / 9][cell % 9] = task->cells[cell];
+
+    if (!search_init(search, grid))
+        return; // The fixed cells clash
+
+    while (!pool->stop)
+    {
+        search_status_t status = search_run(search, COUNTER_SLICE_NODES, &pool->stop);
+
+        if (status == SEARCH_FOUND)
+        {
+            worker->count++;
+
+            if (pool->limit > 0 && ++unpublished >= pool->publish)
+            {
+                publish_solutions(pool, unpublished);
+                unpublished = 0;
+            }
+        }
+        else if (status != SEARCH_RUNNING)
+        {
+            break; // Exhausted, or stopped through the flag
+        }
+
+        // Checked after every solution too: dense grids may never use up a slice
+        if (pool->cancel != NULL && *pool->cancel)
+            pool->stop = 1;
+
+        // Others are waiting and nothing is queued: give them part of this subtree
+        if (__atomic_load_n(&pool->idle, __ATOMIC_RELAXED) > 0 &&
+            __atomic_load_n(&pool->available, __ATOMIC_RELAXED) == 0)
+        {
+            int made = hand_off(search, task, children);
+
+            if (made > 0)
+            {
+                finish_tasks(pool, 0, made);
+                push_tasks(pool, worker->index, children, made);
+                worker->splits += made;
+                worker->nodes += (uint64_t)made;
+            }
+        }
+    }
+
+    worker->nodes += search->nodes;
+
+    if (pool->limit > 0)
+        publish_solutions(pool, unpublished);
+}
+
+/**
+ * Worker: take, split or count subtasks until all are done or stopped
+ *
+ * Parameters:
+ *   arg - counter_worker_t of this thread
+ *
+ * Returns: NULL
+ */
+static void *counter_worker(void *arg)
+{
+    counter_worker_t *worker = arg;
+    counter_pool_t *pool = worker->pool;
+    search_t *search = malloc(sizeof(*search));
+    counter_task_t task, children[9];
+
+    if (search == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    use_thread_topology(pool->topology);
+
+    while (!pool->stop)
+    {
+        if (!take_task(worker, &task))
+        {
+            pthread_mutex_lock(&pool->lock);
+
+            if (pool->pending == 0)
+            {
+                pthread_mutex_unlock(&pool->lock);
+                break; // Every subtask is done
+            }
+
+            // Work is still being counted elsewhere and may be split for us
+            pool->idle++;
+            while (pool->available == 0 && pool->pending > 0 && !pool->stop)
+                pthread_cond_wait(&pool->work, &pool->lock);
+            pool->idle--;
+
+            pthread_mutex_unlock(&pool->lock);
+            continue;
+        }
+
+        // Others are waiting and nothing is queued here: share this subtask
+        if (__atomic_load_n(&pool->idle, __ATOMIC_RELAXED) > 0 &&
+            task.depth < COUNTER_SPLIT_DEPTH)
+        {
+            int made = split_task(&task, children);
+
+            if (made >= 0)
+            {
+                // Counted as pending first so a fast thief cannot finish the pool
+                finish_tasks(pool, 1, made);
+
+                if (made > 0)
+                    push_tasks(pool, worker->index, children, made);
+
+                worker->splits += made;
+                worker->nodes += (uint64_t)made;
+                continue;
+            }
+        }
+
+        count_task(worker, search, &task);
+        finish_tasks(pool, 1, 0);
+    }
+
+    // Release waiters once the limit or a cancel stops the count
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    use_thread_topology(NULL);
+    free(search);
+    return NULL;
+}
+
+/**
+ * Count solutions on several threads, up to a limit
+ *
+ * Parameters:
+ *   grid    - 9x9 grid to analyze (not modified)
+ *   limit   - stop once this many solutions are found (0 = no limit)
+ *   threads - counting threads (0 = one per online CPU)
+ *   cancel  - optional cancel flag
+ *   report  - receives threads, subtasks, steals and nodes (may be NULL)
+ *
+ * Returns: number of solutions found, at most limit
+ */
+long count_solutions_parallel(int grid[9][9], long limit, int threads,
+                              const volatile int *cancel, counter_report_t *report)
+{
+    int thread_count = batch_thread_count(threads);
+    counter_pool_t *pool = calloc(1, sizeof(*pool));
+    counter_worker_t workers[COUNTER_MAX_THREADS];
+    pthread_t handles[COUNTER_MAX_THREADS];
+    long wanted = (long)thread_count * COUNTER_TASKS_PER_THREAD;
+    counter_task_t *level = malloc(sizeof(counter_task_t) * (size_t)(wanted * 9 + 9));
+    counter_task_t *next = malloc(sizeof(counter_task_t) * (size_t)(wanted * 9 + 9));
+    long level_count = 1, created = 1;
+
+    if (pool == NULL || level == NULL || next == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (int cell = 0; cell < 81; cell++)
+        level[0].cells[cell] = (uint8_t)grid[cell / 9][cell % 9];
+    level[0].depth = 0;
+
+    // Split breadth-first until every thread has a handful of subtasks;
+    // full and forced subtasks are carried along unsplit
+    while (level_count < wanted)
+    {
+        long next_count = 0;
+        int split_any = 0;
+
+        for (long i = 0; i < level_count; i++)
+        {
+            int made = split_task(&level[i], next + next_count);
+
+            if (made < 0)
+            {
+                next[next_count++] = level[i];
+                continue;
+            }
+
+            next_count += made;
+            created += made;
+            split_any = 1;
+        }
+
+        counter_task_t *swap = level;
+        level = next;
+        next = swap;
+        level_count = next_count;
+
+        if (!split_any || level_count == 0)
+            break;
+    }
+
+    pool->threads = thread_count;
+    pool->topology = current_topology();
+    pool->limit = limit > 0 ? limit : 0;
+    pool->cancel = cancel;
+    pool->pending = level_count;
+    pool->available = level_count;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work, NULL);
+
+    // Small limits are published at once so "stop at 2" stops everyone promptly
+    pool->publish = limit / (4L * thread_count);
+    pool->publish = pool->publish < 1 ? 1 :
+                    pool->publish > COUNTER_PUBLISH_MAX ? COUNTER_PUBLISH_MAX : pool->publish;
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        counter_deque_t *deque = &pool->deques[i];
+        long share = level_count / thread_count + (i < level_count % thread_count);
+
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->capacity = (size_t)share + 16;
+        deque->tasks = malloc(deque->capacity * sizeof(counter_task_t));
+
+        if (deque->tasks == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+
+        // Deal the subtasks round-robin so neighbouring branches spread out
+        for (long t = i; t < level_count; t += thread_count)
+            deque->tasks[deque->bottom++] = level[t];
+    }
+
+    free(level);
+    free(next);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        memset(&workers[i], 0, sizeof(workers[i]));
+        workers[i].pool = pool;
+        workers[i].index = i;
+        pthread_create(&handles[i], NULL, counter_worker, &workers[i]);
+    }
+
+    long total = 0;
+    long steals = 0;
+    uint64_t nodes = (uint64_t)(created - 1); // One digit fixed per subtask split off
+
+    // Per-thread counts are merged only here
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(handles[i], NULL);
+        total += workers[i].count;
+        steals += workers[i].steals;
+        created += workers[i].splits;
+        nodes += workers[i].nodes;
+    }
+
+    if (limit > 0 && total > limit)
+        total = limit; // Several threads may pass the limit at once
+
+    if (report != NULL)
+    {
+        report->threads = thread_count;
+        report->tasks = created;
+        report->steals = steals;
+        report->nodes = nodes;
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
+    }
+
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+
+    return total;
+}
@@ -0,0 +1,491 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/daily.h"
+#include "../include/generator.h"
+#include "../include/solver.h"
+#include "../include/topology.h"
+#include "../include/rng.h"
+#include "../include/codec.h"
+#include <unistd.h>
+
+#define DAILY_LEVELS 4                                  // EASY through EXPERT
+#define DAILY_SLOTS (DAILY_CACHE_DAYS * DAILY_LEVELS)   // Entries kept in the cache
+#define DAILY_ENTRY_MAX (11 + 4 * CODEC_MAX_BYTES + 2 + 16) // Longest entry without newline
+
+/**
+ * Hash bytes with 64-bit FNV-1a
+ *
+ * Parameters:
+ *   data   - bytes to hash
+ *   length - number of bytes
+ *
+ * Returns: hash of the bytes and DAILY_VERSION
+ */
+static uint64_t entry_hash(const char *data, size_t length)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (uint8_t)data[i];
+        hash *= 0x100000001B3ULL;
+    }
+
+    // Entries of an older generator fail verification
+    hash ^= DAILY_VERSION;
+    hash *= 0x100000001B3ULL;
+    return hash;
+}
+
+/**
+ * Get today's local date
+ *
+ * Returns: date as YYYYMMDD
+ */
+long daily_today(void)
+{
+    time_t now = time(NULL);
+    struct tm local;
+
+    localtime_r(&now, &local);
+    return (local.tm_year + 1900) * 10000L + (local.tm_mon + 1) * 100L + local.tm_mday;
+}
+
+/**
+ * Move a date by whole days
+ *
+ * Parameters:
+ *   date - date as YYYYMMDD
+ *   days - days to add (may be negative)
+ *
+ * Returns: resulting date as YYYYMMDD
+ */
+long daily_add_days(long date, int days)
+{
+    struct tm when;
+
+    memset(&when, 0, sizeof(when));
+    when.tm_year = (int)(date / 10000) - 1900;
+    when.tm_mon = (int)(date / 100 % 100) - 1;
+    when.tm_mday = (int)(date % 100) + days;
+    when.tm_hour = 12; // Noon: daylight saving shifts cannot change the day
+    when.tm_isdst = -1;
+    mktime(&when);     // Normalizes the day into month and year
+
+    return (when.tm_year + 1900) * 10000L + (when.tm_mon + 1) * 100L + when.tm_mday;
+}
+
+/**
+ * Parse a date written as YYYY-MM-DD
+ *
+ * Parameters:
+ *   text - date text
+ *   date - receives the date as YYYYMMDD
+ *
+ * Returns: 1 if valid, 0 otherwise
+ */
+int parse_daily_date(const char *text, long *date)
+{
+    int year, month, day;
+    char extra;
+
+    if (sscanf(text, "%4d-%2d-%2d%c", &year, &month, &day, &extra) != 3)
+        return 0;
+
+    if (year < 1900 || month < 1 || month > 12 || day < 1 || day > 31)
+        return 0;
+
+    long parsed = year * 10000L + month * 100L + day;
+
+    // Normalizing rejects days past the end of the month
+    if (daily_add_days(parsed, 0) != parsed)
+        return 0;
+
+    *date = parsed;
+    return 1;
+}
+
+/**
+ * Build the daily puzzle of a date from its seed
+ * Uses the active rules, which the caller sets to classic
+ *
+ * Parameters:
+ *   date       - date as YYYYMMDD
+ *   difficulty - level
+ *   puzzle     - receives the puzzle
+ *   cancel     - optional flag; generation stops when it becomes non-zero
+ *
+ * Returns: 1 on success, 0 if cancelled
+ */
+int daily_generate(long date, difficulty_t difficulty, daily_puzzle_t *puzzle,
+                   const volatile int *cancel)
+{
+    generator_options_t options = {difficulty, 0, SYMMETRY_NONE, NULL, 0, 0, cancel,
+                                   GENERATOR_REMOVAL};
+    int given[9][9];
+    rng_t rng;
+
+    uint64_t seed = (uint64_t)date * DAILY_LEVELS + difficulty;
+
+    rng_seed(&rng, seed ^ ((uint64_t)DAILY_VERSION << 48));
+    options.rng = &rng;
+
+    puzzle->date = date;
+    puzzle->difficulty = difficulty;
+
+    // Draw from the one stream until the rating agrees with the level
+    for (int attempt = 0; attempt < DAILY_ATTEMPTS; attempt++)
+    {
+        generate_puzzle_ex(puzzle->grid, puzzle->solution, given, &options, NULL);
+
+        if (cancel != NULL && *cancel)
+            return 0;
+
+        if (rate_puzzle(puzzle->grid, NULL) == difficulty)
+            break;
+    }
+
+    return 1;
+}
+
+/**
+ * Append bytes to an entry as lowercase hex
+ *
+ * Parameters:
+ *   out    - destination (2 * length characters)
+ *   bytes  - bytes to write
+ *   length - number of bytes
+ *
+ * Returns: characters written
+ */
+static size_t write_hex(char *out, const uint8_t *bytes, size_t length)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (size_t i = 0; i < length; i++)
+    {
+        out[2 * i] = digits[bytes[i] >> 4];
+        out[2 * i + 1] = digits[bytes[i] & 0x0F];
+    }
+
+    return 2 * length;
+}
+
+/**
+ * Read one hex field of an entry and decode it as a codec puzzle
+ *
+ * Parameters:
+ *   text   - start of the field
+ *   length - characters in the field
+ *   grid   - receives the decoded grid
+ *
+ * Returns: 1 if the field is valid hex holding exactly one encoded puzzle
+ */
+static int read_hex_puzzle(const char *text, size_t length, int grid[9][9])
+{
+    uint8_t bytes[CODEC_MAX_BYTES];
+
+    if (length % 2 != 0 || length / 2 > CODEC_MAX_BYTES)
+        return 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = text[i];
+        int nibble = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+
+        if (nibble < 0)
+            return 0;
+
+        bytes[i / 2] = (uint8_t)(i % 2 == 0 ? nibble << 4 : bytes[i / 2] | nibble);
+    }
+
+    return decode_puzzle(bytes, length / 2, grid) == length / 2;
+}
+
+/**
+ * Write a puzzle as a cache entry
+ * Clues and solution are stored with the shared puzzle codec (codec.h)
+ *
+ * Parameters:
+ *   puzzle - puzzle to write
+ *   out    - buffer of at least DAILY_ENTRY_MAX + 2 bytes
+ *
+ * Returns: bytes written, newline included
+ */
+static size_t format_entry(const daily_puzzle_t *puzzle, char *out)
+{
+    uint8_t encoded[CODEC_MAX_BYTES];
+    int grid[9][9], solution[9][9];
+    size_t length = (size_t)snprintf(out, 12, "%08ld %d ", puzzle->date, (int)puzzle->difficulty);
+
+    memcpy(grid, puzzle->grid, sizeof(grid));
+    memcpy(solution, puzzle->solution, sizeof(solution));
+
+    length += write_hex(out + length, encoded, encode_puzzle(grid, encoded));
+    out[length++] = ' ';
+    length += write_hex(out + length, encoded, encode_puzzle(solution, encoded));
+    out[length++] = ' ';
+
+    snprintf(out + length, 18, "%016llx", (unsigned long long)entry_hash(out, length));
+    length += 16;
+    out[length++] = '\n';
+
+    return length;
+}
+
+/**
+ * Read and verify a cache entry
+ *
+ * Parameters:
+ *   line   - entry text without newline
+ *   length - bytes in line
+ *   puzzle - receives the puzzle
+ *
+ * Returns: 1 if the entry is well formed and its hash matches, 0 otherwise
+ */
+static int parse_entry(const char *line, size_t length, daily_puzzle_t *puzzle)
+{
+    char hash_text[17];
+    long date;
+    int level;
+
+    if (length < 11 + 2 + 16 || length > DAILY_ENTRY_MAX || line[8] != ' ' || line[10] != ' ' ||
+        line[length - 17] != ' ')
+        return 0;
+
+    size_t hash_offset = length - 16;
+
+    snprintf(hash_text, sizeof(hash_text), "%016llx",
+             (unsigned long long)entry_hash(line, hash_offset));
+
+    if (memcmp(hash_text, line + hash_offset, 16) != 0)
+        return 0; // Damaged, or written by another generator version
+
+    if (sscanf(line, "%8ld %1d", &date, &level) != 2 || level < EASY || level > EXPERT)
+        return 0;
+
+    const char *clues = line + 11;
+    const char *space = memchr(clues, ' ', hash_offset - 1 - 11);
+
+    if (space == NULL ||
+        !read_hex_puzzle(clues, (size_t)(space - clues), puzzle->grid) ||
+        !read_hex_puzzle(space + 1, (size_t)(line + hash_offset - 1 - (space + 1)), puzzle->solution))
+        return 0;
+
+    puzzle->date = date;
+    puzzle->difficulty = (difficulty_t)level;
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int clue = puzzle->grid[cell / 9][cell % 9];
+        int value = puzzle->solution[cell / 9][cell % 9];
+
+        if (value == 0 || (clue != 0 && clue != value))
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Read the cache entries for the wanted dates and levels
+ *
+ * Parameters:
+ *   entries - cache slots; entries[i].date and .difficulty say what is wanted
+ *   have    - set to 1 for each slot found
+ *   count   - number of slots
+ *
+ * Returns: number of slots found
+ */
+static int read_cache(daily_puzzle_t *entries, int *have, int count)
+{
+    FILE *file = fopen(DAILY_CACHE_FILE, "r");
+    char line[DAILY_ENTRY_MAX + 8];
+    daily_puzzle_t entry;
+    int found = 0;
+
+    if (file == NULL)
+        return 0;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        size_t length = strcspn(line, "\r\n");
+
+        if (!parse_entry(line, length, &entry))
+            continue;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (!have[i] && entries[i].date == entry.date &&
+                entries[i].difficulty == entry.difficulty)
+            {
+                entries[i] = entry;
+                have[i] = 1;
+                found++;
+                break;
+            }
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+/**
+ * Replace the cache file with the slots found or generated so far
+ * Writes a private temporary file and renames it over the cache, so a
+ * reader never sees a half-written file
+ *
+ * Parameters:
+ *   entries - cache slots
+ *   have    - 1 for each slot holding a puzzle
+ *   count   - number of slots
+ *
+ * Returns: 1 on success, 0 on I/O error
+ */
+static int write_cache(const daily_puzzle_t *entries, const int *have, int count)
+{
+    char path[64];
+    char text[DAILY_ENTRY_MAX + 2];
+    int ok = 1;
+
+    snprintf(path, sizeof(path), "%s.%ld.tmp", DAILY_CACHE_FILE, (long)getpid());
+
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+        return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!have[i])
+            continue;
+
+        size_t length = format_entry(&entries[i], text);
+        ok &= fwrite(text, 1, length, file) == length;
+    }
+
+    ok &= fclose(file) == 0;
+
+    if (!ok || rename(path, DAILY_CACHE_FILE) != 0)
+    {
+        remove(path);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Get the daily puzzle of a date from the cache or by generating it
+ *
+ * Parameters:
+ *   date       - date as YYYYMMDD
+ *   difficulty - level
+ *   puzzle     - receives the puzzle
+ *
+ * Returns: 1 if it came from the cache, 0 if it was generated
+ */
+int daily_get(long date, difficulty_t difficulty, daily_puzzle_t *puzzle)
+{
+    int have = 0;
+
+    puzzle->date = date;
+    puzzle->difficulty = difficulty;
+
+    if (read_cache(puzzle, &have, 1))
+        return 1;
+
+    daily_generate(date, difficulty, puzzle, NULL);
+    return 0;
+}
+
+/**
+ * Worker: generate the missing cache entries, one at a time
+ *
+ * Parameters:
+ *   arg - daily_cache_t of the filler
+ *
+ * Returns: NULL
+ */
+static void *daily_worker(void *arg)
+{
+    daily_cache_t *cache = arg;
+    daily_puzzle_t *entries = malloc(DAILY_SLOTS * sizeof(*entries));
+    int have[DAILY_SLOTS] = {0};
+    long today = daily_today();
+
+    if (entries == NULL)
+        return NULL; // The cache is only a shortcut; go without it
+
+    // The game may be playing a jigsaw or killer puzzle meanwhile
+    use_thread_topology(get_topology(VARIANT_CLASSIC));
+
+    for (int i = 0; i < DAILY_SLOTS; i++)
+    {
+        entries[i].date = daily_add_days(today, i / DAILY_LEVELS);
+        entries[i].difficulty = (difficulty_t)(i % DAILY_LEVELS);
+    }
+
+    read_cache(entries, have, DAILY_SLOTS);
+
+    for (int i = 0; i < DAILY_SLOTS && !cache->stop; i++)
+    {
+        if (have[i])
+            continue;
+
+        if (!daily_generate(entries[i].date, entries[i].difficulty, &entries[i], &cache->stop))
+            break;
+
+        have[i] = 1;
+
+        if (!write_cache(entries, have, DAILY_SLOTS))
+            break; // Read-only directory: nothing can be kept
+
+        // Leave the CPU to the player between entries
+        for (int slice = 0; slice < DAILY_IDLE_MS / 10 && !cache->stop; slice++)
+        {
+            struct timespec pause = {0, 10 * 1000000L};
+            nanosleep(&pause, NULL);
+        }
+    }
+
+    free(entries);
+    return NULL;
+}
+
+/**
+ * Start filling the cache for today and the coming days
+ *
+ * Parameters:
+ *   cache - filler state to initialize
+ *
+ * Returns: 1 if the thread started, 0 otherwise
+ */
+int daily_cache_start(daily_cache_t *cache)
+{
+    memset(cache, 0, sizeof(*cache));
+
+    if (pthread_create(&cache->thread, NULL, daily_worker, cache) != 0)
+        return 0;
+
+    cache->started = 1;
+    return 1;
+}
+
+/**
+ * Stop the cache filler and join its thread
+ *
+ * Parameters:
+ *   cache - filler state
+ */
+void daily_cache_stop(daily_cache_t *cache)
+{
+    if (!cache->started)
+        return;
+
+    cache->stop = 1; // Also cancels the generator at its next uniqueness check
+    pthread_join(cache->thread, NULL);
+    cache->started = 0;
+}
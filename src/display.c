@@ -5,10 +5,12 @@
  * It manages colors, grid rendering, UI panels, and visual feedback for the player.
  * 
  * Key Features:
- * - Colored grid with distinct 3x3 box and cell borders
+ * - Colored grid with distinct box (or jigsaw region) and cell borders
+ * - Yellow shading for variant units (X diagonals, Windoku windows)
  * - Red highlighting for invalid moves and conflicting areas
  * - Real-time timer and move counter display
  * - Help panel with controls
+ * - Scrolling viewport onto the five-grid Samurai layout
  * - Modular design for easy maintenance
  */
 
@@ -18,6 +20,7 @@
 #include "../include/generator.h"
 #include "../include/solver.h"
 #include "../include/display.h"
+#include "../include/topology.h"
 #include <ncurses.h>
 
 // Color pair constants for consistent color management
@@ -56,6 +59,7 @@ void init_colors(void)
         init_pair(7, COLOR_BLUE, COLOR_BLACK);                    // 3x3 box borders - blue
         init_pair(8, COLOR_GREEN, COLOR_BLACK);                   // UI text - green
         init_pair(9, COLOR_CYAN, COLOR_BLACK);                    // Header text - cyan
+        init_pair(10, COLOR_YELLOW, COLOR_BLACK);                 // Variant unit cells, killer cages - yellow
     }
 }
 
@@ -98,7 +102,8 @@ void draw_title_info(game_state_t *game)
 
     // Display current difficulty level
     const char *difficulty_names[] = {"easy", "medium", "hard", "expert"};
-    mvprintw(5, 50, "Level: %s", difficulty_names[game->difficulty]);
+    mvprintw(5, 50, "Level: %s  %s", difficulty_names[game->difficulty],
+             get_topology(game->variant)->name);
 
     // Display elapsed time if game has started
     if (game->start_time > 0)
@@ -112,6 +117,21 @@ void draw_title_info(game_state_t *game)
     // Display move counter
     mvprintw(7, 50, "Moves: %d", game->moves);
 
+    // Display clue count achieved by the generator
+    int clues = 0;
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            clues += game->given[row][col];
+        }
+    }
+    mvprintw(8, 50, "Clues: %d", clues);
+
+    // Depth of nested what-if branches, if any are open
+    if (game->journal.depth > 0)
+        printw("  Branch: %d", game->journal.depth);
+
     attroff(COLOR_PAIR(9));
 }
 
@@ -133,72 +153,166 @@ void draw_help_panel(void)
     mvprintw(16, 52, "h - Get hint");        // NEW: Hint command
     mvprintw(17, 52, "n - New puzzle");
     mvprintw(18, 52, "s - Solve puzzle");
-    mvprintw(19, 52, "r - Redraw");
-    mvprintw(20, 52, "q - Quit");
+    mvprintw(19, 52, "a - Animate solve (+/- speed)");
+    mvprintw(20, 52, "v - Change variant");
+    mvprintw(21, 52, "r - Redraw  d - Daily puzzle");
+    mvprintw(22, 52, "q - Quit");
+    mvprintw(23, 52, "b/u/k - Branch, undo, keep");
+    mvprintw(25, 52, "e - Edit  f - Check  p - Save");
 
     attroff(COLOR_PAIR(9));
 }
 
+/**
+ * Region of a cell, or -1 outside the grid
+ * 
+ * @param topology Unit tables of the current puzzle
+ * @param row Row (may be -1 or 9)
+ * @param col Column (may be -1 or 9)
+ * @return Box or jigsaw region 0-8, -1 if off the grid
+ */
+static int region_at(const topology_t *topology, int row, int col)
+{
+    if (row < 0 || row >= GRID_SIZE || col < 0 || col >= GRID_SIZE)
+        return -1;
+
+    return region_of(topology, row * 9 + col);
+}
+
+/**
+ * Check if the horizontal segment above a cell separates two regions
+ * 
+ * @param topology Unit tables of the current puzzle
+ * @param line Horizontal grid line (0-9)
+ * @param col Column of the segment
+ * @return 1 if the segment is a region border
+ */
+static int is_thick_horizontal(const topology_t *topology, int line, int col)
+{
+    return region_at(topology, line - 1, col) != region_at(topology, line, col);
+}
+
+/**
+ * Check if the vertical segment left of a cell separates two regions
+ * 
+ * @param topology Unit tables of the current puzzle
+ * @param row Row of the segment
+ * @param line Vertical grid line (0-9)
+ * @return 1 if the segment is a region border
+ */
+static int is_thick_vertical(const topology_t *topology, int row, int line)
+{
+    return region_at(topology, row, line - 1) != region_at(topology, row, line);
+}
+
+/**
+ * Check if the horizontal segment above a cell separates two killer cages
+ * The outer frame is never a cage border, so it keeps the region color
+ * 
+ * @param topology Unit tables of the current puzzle
+ * @param line Horizontal grid line (0-9)
+ * @param col Column of the segment
+ * @return 1 if the segment is a cage border
+ */
+static int is_cage_horizontal(const topology_t *topology, int line, int col)
+{
+    if (topology->cage_count == 0 || line <= 0 || line >= GRID_SIZE || col < 0 || col >= GRID_SIZE)
+        return 0;
+
+    return topology->cage_of[(line - 1) * 9 + col] != topology->cage_of[line * 9 + col];
+}
+
+/**
+ * Check if the vertical segment left of a cell separates two killer cages
+ * 
+ * @param topology Unit tables of the current puzzle
+ * @param row Row of the segment
+ * @param line Vertical grid line (0-9)
+ * @return 1 if the segment is a cage border
+ */
+static int is_cage_vertical(const topology_t *topology, int row, int line)
+{
+    if (topology->cage_count == 0 || line <= 0 || line >= GRID_SIZE || row < 0 || row >= GRID_SIZE)
+        return 0;
+
+    return topology->cage_of[row * 9 + line - 1] != topology->cage_of[row * 9 + line];
+}
+
+/**
+ * Print each killer cage's sum on the top border of its first cell
+ * 
+ * @param topology Unit tables of the current puzzle
+ */
+static void draw_cage_sums(const topology_t *topology)
+{
+    attrset(COLOR_PAIR(10) | A_BOLD);
+
+    for (int c = 0; c < topology->cage_count; c++)
+    {
+        // Cells are listed in row-major order, so the first is top-left
+        int cell = topology->cages[c].cells[0];
+        int y = GRID_START_Y + (cell / 9) * (CELL_HEIGHT + 1);
+        int x = GRID_START_X + (cell % 9) * (CELL_WIDTH + 1) + 1;
+
+        mvprintw(y, x, "%d", topology->cages[c].sum);
+    }
+}
+
 /**
  * Draw the complete Sudoku grid with borders and numbers
  * Handles both the visual grid structure and number placement
+ * Region borders come from the topology's box (or jigsaw region) map;
+ * killer cage borders are drawn over them in yellow with the cage sums
  * 
  * @param game Pointer to the current game state
  */
 void draw_grid(game_state_t *game)
 {
+    const topology_t *topology = current_topology();
+
     // Draw all horizontal lines (top to bottom)
     for (int row = 0; row <= GRID_SIZE; row++)
     {
         int y = GRID_START_Y + row * (CELL_HEIGHT + 1);
-        int is_thick = (row % 3 == 0);  // Every 3rd line is thick (3x3 box boundary)
 
         move(y, GRID_START_X);
 
         // Draw horizontal line segments and intersections
-        for (int col = 0; col < GRID_SIZE; col++)
+        for (int col = 0; col <= GRID_SIZE; col++)
         {
-            // Choose intersection character and color based on position
+            // An intersection is blue if any segment meeting there is a region border
+            int thick_joint = is_thick_horizontal(topology, row, col - 1) ||
+                              is_thick_horizontal(topology, row, col) ||
+                              is_thick_vertical(topology, row - 1, col) ||
+                              is_thick_vertical(topology, row, col);
+            int cage_joint = is_cage_horizontal(topology, row, col - 1) ||
+                             is_cage_horizontal(topology, row, col) ||
+                             is_cage_vertical(topology, row - 1, col) ||
+                             is_cage_vertical(topology, row, col);
+
+            if (cage_joint)
+                attrset(COLOR_PAIR(10)); // Yellow for cage boundaries
+            else if (thick_joint)
+                attrset(COLOR_PAIR(7)); // Blue for region boundaries
+            else
+                attrset(COLOR_PAIR(6)); // White for cell boundaries
+
+            // Choose appropriate corner/junction character
             if (col == 0)
-            {
-                // Left edge of the grid
-                if (is_thick)
-                    attrset(COLOR_PAIR(7)); // Blue for 3x3 boundaries
-                else
-                    attrset(COLOR_PAIR(6)); // White for cell boundaries
-
-                // Choose appropriate corner/junction character
-                if (row == 0)
-                    addch(ACS_ULCORNER);        // Top-left corner
-                else if (row == GRID_SIZE)
-                    addch(ACS_LLCORNER);        // Bottom-left corner
-                else
-                    addch(ACS_LTEE);            // Left T-junction
-            }
+                addch(row == 0 ? ACS_ULCORNER : row == GRID_SIZE ? ACS_LLCORNER : ACS_LTEE);
+            else if (col == GRID_SIZE)
+                addch(row == 0 ? ACS_URCORNER : row == GRID_SIZE ? ACS_LRCORNER : ACS_RTEE);
             else
-            {
-                // Internal intersections
-                bool thick_h = is_thick;        // Horizontal line is thick
-                bool thick_v = (col % 3 == 0);  // Vertical line is thick
-
-                // Use blue if either line is thick (3x3 boundary)
-                if (thick_h || thick_v)
-                    attrset(COLOR_PAIR(7)); // Blue for any 3x3 boundary
-                else
-                    attrset(COLOR_PAIR(6)); // White for cell boundaries
-
-                // Choose appropriate junction character
-                if (row == 0)
-                    addch(ACS_TTEE);            // Top T-junction
-                else if (row == GRID_SIZE)
-                    addch(ACS_BTEE);            // Bottom T-junction
-                else
-                    addch(ACS_PLUS);            // Cross intersection
-            }
+                addch(row == 0 ? ACS_TTEE : row == GRID_SIZE ? ACS_BTEE : ACS_PLUS);
+
+            if (col == GRID_SIZE)
+                break; // Right edge has no segment after it
 
             // Draw horizontal line segment with appropriate color
-            if (is_thick)
-                attrset(COLOR_PAIR(7)); // Blue for 3x3 horizontal boundaries
+            if (is_cage_horizontal(topology, row, col))
+                attrset(COLOR_PAIR(10)); // Yellow for cage boundaries
+            else if (is_thick_horizontal(topology, row, col))
+                attrset(COLOR_PAIR(7)); // Blue for region boundaries
             else
                 attrset(COLOR_PAIR(6)); // White for cell boundaries
 
@@ -206,20 +320,6 @@ void draw_grid(game_state_t *game)
             for (int i = 0; i < CELL_WIDTH; i++)
                 addch(ACS_HLINE);
         }
-
-        // Draw right edge of the grid
-        if (is_thick)
-            attrset(COLOR_PAIR(7)); // Blue for 3x3 boundaries
-        else
-            attrset(COLOR_PAIR(6)); // White for cell boundaries
-
-        // Choose appropriate corner/junction character for right edge
-        if (row == 0)
-            addch(ACS_URCORNER);        // Top-right corner
-        else if (row == GRID_SIZE)
-            addch(ACS_LRCORNER);        // Bottom-right corner
-        else
-            addch(ACS_RTEE);            // Right T-junction
     }
 
     // Draw all vertical lines
@@ -230,9 +330,12 @@ void draw_grid(game_state_t *game)
         {
             int x = GRID_START_X + col * (CELL_WIDTH + 1);
 
-            // Use blue for 3x3 box boundaries, white for cell boundaries
-            if (col % 3 == 0)
-                attrset(COLOR_PAIR(7)); // Blue for 3x3 vertical boundaries
+            // Use yellow for cage boundaries, blue for region boundaries,
+            // white for cell boundaries
+            if (is_cage_vertical(topology, row, col))
+                attrset(COLOR_PAIR(10)); // Yellow for cage boundaries
+            else if (is_thick_vertical(topology, row, col))
+                attrset(COLOR_PAIR(7)); // Blue for region boundaries
             else
                 attrset(COLOR_PAIR(6)); // White for cell boundaries
 
@@ -240,6 +343,8 @@ void draw_grid(game_state_t *game)
         }
     }
 
+    draw_cage_sums(topology);
+
     // Draw all numbers and handle highlighting
     for (int row = 0; row < GRID_SIZE; row++)
     {
@@ -265,8 +370,8 @@ void draw_grid(game_state_t *game)
 
 /**
  * Check if a cell should be highlighted due to conflicts
- * Determines if the current cell is in the same row, column, or 3x3 box
- * as a cell with an invalid placement
+ * Determines if the current cell shares a unit (row, column, 3x3 box or
+ * variant unit) with the cursor in which the cursor's value repeats
  * 
  * @param game Pointer to the current game state
  * @param check_row Row of the cell to check
@@ -275,64 +380,44 @@ void draw_grid(game_state_t *game)
  */
 int should_highlight_cell(game_state_t *game, int check_row, int check_col)
 {
+    const topology_t *topology = current_topology();
+    const int *cells = &game->grid[0][0];
+
     // Get the value at current cursor position
-    int cursor_row = game->cursor_row;
-    int cursor_col = game->cursor_col;
-    int cursor_value = game->grid[cursor_row][cursor_col];
-    
-    // Only highlight if cursor cell has a value and it's invalid
-    if (cursor_value != 0 && !is_valid_cell_placement(game, cursor_row, cursor_col, cursor_value))
+    int cursor_cell = game->cursor_row * 9 + game->cursor_col;
+    int check_cell = check_row * 9 + check_col;
+    int cursor_value = cells[cursor_cell];
+
+    // Only highlight if cursor cell has a value
+    if (cursor_value == 0)
+        return 0;
+
+    // Walk the units of the checked cell that also contain the cursor
+    for (int k = 0; k < topology->cell_unit_count[check_cell]; k++)
     {
-        // Check for row conflict
-        for (int col = 0; col < GRID_SIZE; col++) {
-            if (col != cursor_col && game->grid[cursor_row][col] == cursor_value) {
-                // Row conflict found - highlight the entire row
-                if (check_row == cursor_row)
-                    return 1;
-                break;
-            }
-        }
-        
-        // Check for column conflict  
-        for (int row = 0; row < GRID_SIZE; row++) {
-            if (row != cursor_row && game->grid[row][cursor_col] == cursor_value) {
-                // Column conflict found - highlight the entire column
-                if (check_col == cursor_col)
-                    return 1;
-                break;
-            }
-        }
-        
-        // Check for 3x3 box conflict
-        int box_start_row = (cursor_row / 3) * 3;
-        int box_start_col = (cursor_col / 3) * 3;
-        
-        int box_conflict = 0;
-        for (int r = box_start_row; r < box_start_row + 3 && !box_conflict; r++) {
-            for (int c = box_start_col; c < box_start_col + 3; c++) {
-                if ((r != cursor_row || c != cursor_col) && game->grid[r][c] == cursor_value) {
-                    box_conflict = 1;
-                    break;
-                }
-            }
-        }
-        
-        if (box_conflict) {
-            // Box conflict found - highlight the 3x3 box
-            int check_box_row = (check_row / 3) * 3;
-            int check_box_col = (check_col / 3) * 3;
-            
-            if (box_start_row == check_box_row && box_start_col == check_box_col)
-                return 1;
+        const uint8_t *unit = topology->units[topology->cell_units[check_cell][k]];
+        int has_cursor = 0, has_duplicate = 0;
+
+        for (int i = 0; i < GRID_SIZE; i++)
+        {
+            if (unit[i] == cursor_cell)
+                has_cursor = 1;
+            else if (cells[unit[i]] == cursor_value)
+                has_duplicate = 1;
         }
+
+        // Conflict in this unit - highlight the entire unit
+        if (has_cursor && has_duplicate)
+            return 1;
     }
-    
+
     return 0;
 }
 
 /**
  * Check if a cell's current value violates Sudoku rules
- * Validates against row, column, and 3x3 box constraints
+ * Validates against every unit of the cell via its peer list and, in
+ * Killer Sudoku, against its cage sum
  * 
  * @param game Pointer to the current game state
  * @param row Row of the cell to check
@@ -342,33 +427,18 @@ int should_highlight_cell(game_state_t *game, int check_row, int check_col)
  */
 int is_valid_cell_placement(game_state_t *game, int row, int col, int value)
 {
-    // Check for duplicates in the same row
-    for (int c = 0; c < GRID_SIZE; c++)
-    {
-        if (c != col && game->grid[row][c] == value)
-            return 0; // Found duplicate in row
-    }
+    const topology_t *topology = current_topology();
+    const int *cells = &game->grid[0][0];
+    int cell = row * 9 + col;
 
-    // Check for duplicates in the same column
-    for (int r = 0; r < GRID_SIZE; r++)
+    for (int i = 0; i < topology->peer_count[cell]; i++)
     {
-        if (r != row && game->grid[r][col] == value)
-            return 0; // Found duplicate in column
+        if (cells[topology->peers[cell][i]] == value)
+            return 0; // Found duplicate in a shared unit
     }
 
-    // Check for duplicates in the same 3x3 box
-    int box_start_row = (row / 3) * 3;  // Top-left corner of the 3x3 box
-    int box_start_col = (col / 3) * 3;
-
-    for (int r = box_start_row; r < box_start_row + 3; r++)
-    {
-        for (int c = box_start_col; c < box_start_col + 3; c++)
-        {
-            // Skip the cell we're checking
-            if ((r != row || c != col) && game->grid[r][c] == value)
-                return 0; // Found duplicate in 3x3 box
-        }
-    }
+    if (topology->cage_count > 0 && !cage_sum_allows(topology, cells, cell, value))
+        return 0; // Overshoots or misses its cage sum
 
     return 1; // No violations found - valid placement
 }
@@ -405,6 +475,11 @@ void draw_cell(int row, int col, int value, int is_given, int is_cursor, game_st
         // Highlight cells in same row/column/box as cursor (if cursor is invalid)
         attron(COLOR_PAIR(COLOR_INVALID));
     }
+    else if (in_extra_unit(current_topology(), row * 9 + col))
+    {
+        // Cells on a diagonal or in a window carry the variant's extra rule
+        attron(COLOR_PAIR(10));
+    }
     else if (is_given)
     {
         // Puzzle clues use given color (white)
@@ -428,7 +503,7 @@ void draw_cell(int row, int col, int value, int is_given, int is_cursor, game_st
 
     // Turn off all color attributes to reset for next cell
     attroff(COLOR_PAIR(COLOR_CURSOR) | COLOR_PAIR(COLOR_GIVEN) | 
-            COLOR_PAIR(COLOR_NORMAL) | COLOR_PAIR(COLOR_INVALID));
+            COLOR_PAIR(COLOR_NORMAL) | COLOR_PAIR(COLOR_INVALID) | COLOR_PAIR(10));
 }
 
 /**
@@ -530,6 +605,99 @@ void format_time(int seconds, char *buffer, size_t buffer_size)
         snprintf(buffer, buffer_size, "%d seconds", secs);
 }
 
+/**
+ * Display live statistics for an animated solve
+ * Shows nodes searched, nodes per second and the per-frame budget
+ * 
+ * @param anim Animation state to report
+ */
+void draw_animation_status(const animation_t *anim)
+{
+    attron(COLOR_PAIR(9));
+    mvprintw(24, 2, "Searching: %10llu nodes  %9.0f nodes/s  %5llu/frame",
+             (unsigned long long)anim->search.nodes, anim->rate,
+             (unsigned long long)anim->nodes_per_frame);
+    attroff(COLOR_PAIR(9));
+    refresh();
+}
+
+/**
+ * Show whether the entries so far can still lead to a solution
+ * Drawn above the information panel; blank while checking is off
+ *
+ * @param status Newest answer of the move checker
+ */
+void draw_feedback_indicator(feedback_status_t status)
+{
+    switch (status)
+    {
+        case FEEDBACK_PENDING:
+            attron(COLOR_PAIR(9));
+            mvprintw(3, 50, "%-24s", "Check: ...");
+            attroff(COLOR_PAIR(9));
+            break;
+        case FEEDBACK_SOLVABLE:
+            attron(COLOR_PAIR(COLOR_COMPLETE));
+            mvprintw(3, 50, "%-24s", "Check: still solvable");
+            attroff(COLOR_PAIR(COLOR_COMPLETE));
+            break;
+        case FEEDBACK_CONTRADICTED:
+            attron(COLOR_PAIR(COLOR_INVALID));
+            mvprintw(3, 50, "%-24s", "Check: wrong entry");
+            attroff(COLOR_PAIR(COLOR_INVALID));
+            break;
+        case FEEDBACK_UNKNOWN:
+            attron(COLOR_PAIR(9));
+            mvprintw(3, 50, "%-24s", "Check: undecided");
+            attroff(COLOR_PAIR(9));
+            break;
+        default:
+            mvprintw(3, 50, "%-24s", "");
+            break;
+    }
+
+    refresh();
+}
+
+/**
+ * Show the live solution count of the clues being edited
+ * Drawn above the information panel, where the move check goes in play
+ *
+ * @param result Newest answer of the editor's counter
+ */
+void draw_editor_status(const editor_result_t *result)
+{
+    const char *rating_names[] = {"easy", "medium", "hard", "expert"};
+    char text[48];
+    int pair = 9;
+
+    switch (result->status)
+    {
+        case EDITOR_NO_SOLUTION:
+            snprintf(text, sizeof(text), "Editor: 0 solutions");
+            pair = COLOR_INVALID;
+            break;
+        case EDITOR_UNIQUE:
+            snprintf(text, sizeof(text), "Editor: 1 solution, %s", rating_names[result->rating]);
+            pair = COLOR_COMPLETE;
+            break;
+        case EDITOR_MULTIPLE:
+            snprintf(text, sizeof(text), "Editor: 2+ solutions");
+            break;
+        case EDITOR_UNDECIDED:
+            snprintf(text, sizeof(text), "Editor: undecided (budget)");
+            break;
+        default:
+            snprintf(text, sizeof(text), "Editor: counting...");
+            break;
+    }
+
+    attron(COLOR_PAIR(pair));
+    mvprintw(3, 50, "%-34s", text);
+    attroff(COLOR_PAIR(pair));
+    refresh();
+}
+
 /**
  * Display a status message to the player
  * Shows temporary messages like error notifications or hints
@@ -553,4 +721,211 @@ void draw_status_message(const char *message)
 void redraw_screen(game_state_t *game)
 {
     draw_game(game);
-}
\ No newline at end of file
+}
+// Samurai layout drawn into an off-screen pad and shown through a viewport
+#define SAMURAI_PAD_HEIGHT (SAMURAI_SIZE * (CELL_HEIGHT + 1) + 1)
+#define SAMURAI_PAD_WIDTH (SAMURAI_SIZE * (CELL_WIDTH + 1) + 1)
+#define SAMURAI_VIEW_TOP 2  // Screen rows above the viewport (info and help lines)
+
+static WINDOW *samurai_pad = NULL;
+static int view_row = 0, view_col = 0;  // Pad position at the viewport's top-left
+
+/**
+ * Check whether a layout square holds a cell
+ *
+ * @param layout Samurai tables
+ * @param row Layout row (may be out of range)
+ * @param col Layout column (may be out of range)
+ * @return 1 if the square is a cell, 0 for holes and squares off the layout
+ */
+static int samurai_square(const samurai_layout_t *layout, int row, int col)
+{
+    return row >= 0 && row < SAMURAI_SIZE && col >= 0 && col < SAMURAI_SIZE &&
+           layout->index[row][col] >= 0;
+}
+
+/**
+ * Line-drawing character for a joint given the segments meeting there
+ *
+ * @param up Segment above
+ * @param down Segment below
+ * @param left Segment to the left
+ * @param right Segment to the right
+ * @return ACS character, or a space when no segment meets
+ */
+static chtype samurai_joint(int up, int down, int left, int right)
+{
+    switch (up << 3 | down << 2 | left << 1 | right)
+    {
+        case 0x1:
+        case 0x2:
+        case 0x3:
+            return ACS_HLINE;
+        case 0x4:
+        case 0x8:
+        case 0xC:
+            return ACS_VLINE;
+        case 0x5:
+            return ACS_ULCORNER;
+        case 0x6:
+            return ACS_URCORNER;
+        case 0x9:
+            return ACS_LLCORNER;
+        case 0xA:
+            return ACS_LRCORNER;
+        case 0x7:
+            return ACS_TTEE;
+        case 0xB:
+            return ACS_BTEE;
+        case 0xD:
+            return ACS_LTEE;
+        case 0xE:
+            return ACS_RTEE;
+        case 0xF:
+            return ACS_PLUS;
+        default:
+            return ' ';
+    }
+}
+
+/**
+ * Draw the borders of the Samurai layout into the pad
+ * Box borders are blue, cell borders white; holes stay blank
+ *
+ * @param layout Samurai tables
+ */
+static void draw_samurai_borders(const samurai_layout_t *layout)
+{
+    for (int line = 0; line <= SAMURAI_SIZE; line++)
+    {
+        for (int col = 0; col <= SAMURAI_SIZE; col++)
+        {
+            int up = samurai_square(layout, line - 1, col - 1) || samurai_square(layout, line - 1, col);
+            int down = samurai_square(layout, line, col - 1) || samurai_square(layout, line, col);
+            int left = samurai_square(layout, line - 1, col - 1) || samurai_square(layout, line, col - 1);
+            int right = samurai_square(layout, line - 1, col) || samurai_square(layout, line, col);
+            int y = line * (CELL_HEIGHT + 1), x = col * (CELL_WIDTH + 1);
+
+            // Holes are whole boxes, so every hole edge is also a box border
+            wattrset(samurai_pad, COLOR_PAIR(line % 3 == 0 || col % 3 == 0 ? 7 : 6));
+            mvwaddch(samurai_pad, y, x, samurai_joint(up, down, left, right));
+
+            if (col < SAMURAI_SIZE && right)
+            {
+                wattrset(samurai_pad, COLOR_PAIR(line % 3 == 0 ? 7 : 6));
+                for (int i = 1; i <= CELL_WIDTH; i++)
+                    mvwaddch(samurai_pad, y, x + i, ACS_HLINE);
+            }
+
+            if (line < SAMURAI_SIZE && down)
+            {
+                wattrset(samurai_pad, COLOR_PAIR(col % 3 == 0 ? 7 : 6));
+                mvwaddch(samurai_pad, y + 1, x, ACS_VLINE);
+            }
+        }
+    }
+}
+
+/**
+ * Scroll the viewport just enough to keep the cursor cell in view
+ *
+ * @param layout Samurai tables
+ * @param cursor Cell under the cursor
+ * @param height Viewport rows
+ * @param width Viewport columns
+ */
+static void follow_samurai_cursor(const samurai_layout_t *layout, int cursor, int height, int width)
+{
+    // Keep the cell and its surrounding borders visible
+    int top = layout->row[cursor] * (CELL_HEIGHT + 1);
+    int left = layout->col[cursor] * (CELL_WIDTH + 1);
+    int bottom = top + CELL_HEIGHT + 1, right = left + CELL_WIDTH + 1;
+
+    if (top < view_row)
+        view_row = top;
+    if (bottom >= view_row + height)
+        view_row = bottom - height + 1;
+    if (left < view_col)
+        view_col = left;
+    if (right >= view_col + width)
+        view_col = right - width + 1;
+
+    // Never scroll past the layout when the screen could show more of it
+    if (view_row > SAMURAI_PAD_HEIGHT - height)
+        view_row = SAMURAI_PAD_HEIGHT - height > 0 ? SAMURAI_PAD_HEIGHT - height : 0;
+    if (view_col > SAMURAI_PAD_WIDTH - width)
+        view_col = SAMURAI_PAD_WIDTH - width > 0 ? SAMURAI_PAD_WIDTH - width : 0;
+}
+
+/**
+ * Draw a Samurai game: an info line, a help line and a scrolling viewport
+ * onto the whole layout, which is larger than a standard terminal
+ *
+ * @param game Samurai state
+ */
+void draw_samurai(const samurai_game_t *game)
+{
+    const samurai_layout_t *layout = samurai_layout();
+    const char *difficulty_names[] = {"easy", "medium", "hard", "expert"};
+    int elapsed = get_samurai_elapsed_time(game);
+
+    if (samurai_pad == NULL && (samurai_pad = newpad(SAMURAI_PAD_HEIGHT, SAMURAI_PAD_WIDTH)) == NULL)
+        return;
+
+    erase();
+    attron(COLOR_PAIR(9));
+    mvprintw(0, 0, "Nudoku  Samurai  Level: %s  Time: %02d:%02d  Moves: %d  Clues: %d",
+             difficulty_names[game->difficulty], elapsed / 60, elapsed % 60, game->moves,
+             game->clues);
+    mvprintw(1, 0, "Arrows move  1-9 enter  x delete  n new  s solve  v variant  q quit");
+    attroff(COLOR_PAIR(9));
+
+    werase(samurai_pad);
+    draw_samurai_borders(layout);
+
+    for (int cell = 0; cell < SAMURAI_CELLS; cell++)
+    {
+        int value = game->grid[cell];
+        int y = layout->row[cell] * (CELL_HEIGHT + 1) + 1;
+        int x = layout->col[cell] * (CELL_WIDTH + 1) + 1;
+
+        if (cell == game->cursor)
+            wattrset(samurai_pad, COLOR_PAIR(COLOR_CURSOR));
+        else if (value && !game->given[cell] && !samurai_valid_placement(game->grid, cell, value))
+            wattrset(samurai_pad, COLOR_PAIR(COLOR_INVALID));
+        else if (game->given[cell])
+            wattrset(samurai_pad, COLOR_PAIR(COLOR_GIVEN) | A_BOLD);
+        else
+            wattrset(samurai_pad, COLOR_PAIR(COLOR_NORMAL));
+
+        mvwprintw(samurai_pad, y, x, value ? " %d " : "   ", value);
+    }
+
+    wattrset(samurai_pad, COLOR_PAIR(0));
+
+    // The last screen line is kept for status messages
+    int height = LINES - SAMURAI_VIEW_TOP - 1;
+
+    if (height < 1)
+        height = 1;
+
+    follow_samurai_cursor(layout, game->cursor, height, COLS);
+
+    wnoutrefresh(stdscr);
+    pnoutrefresh(samurai_pad, view_row, view_col, SAMURAI_VIEW_TOP, 0,
+                 SAMURAI_VIEW_TOP + height - 1, COLS - 1);
+    doupdate();
+}
+
+/**
+ * Show a status message below the Samurai viewport
+ *
+ * @param message Text message to display
+ */
+void draw_samurai_message(const char *message)
+{
+    attron(COLOR_PAIR(8));
+    mvprintw(LINES - 1, 0, "%-*s", COLS - 1, message);
+    attroff(COLOR_PAIR(8));
+    refresh();
+}
@@ -0,0 +1,121 @@
+#include "../include/sudoku.h"
+#include "../include/editor.h"
+#include "../include/search.h"
+#include "../include/solver.h"
+
+/**
+ * Count the solutions of a grid up to two under the editor's budget
+ *
+ * Parameters:
+ *   search - search state to use
+ *   grid   - clues (0 = empty)
+ *   cancel - flag set when newer clues arrive
+ *   result - receives status, nodes and the first solution
+ *
+ * Returns: 1 if finished, 0 if cancelled
+ */
+static int count_clues(search_t *search, int grid[9][9], const volatile int *cancel,
+                       editor_result_t *result)
+{
+    switch (search_count_to_two(search, grid, EDITOR_COUNT_NODES, cancel, result->solution))
+    {
+        case SEARCH_COUNT_CANCELLED:
+            return 0;
+        case SEARCH_COUNT_INVALID:
+        case SEARCH_COUNT_NONE:
+            result->status = EDITOR_NO_SOLUTION;
+            break;
+        case SEARCH_COUNT_UNIQUE:
+            result->status = EDITOR_UNIQUE;
+            break;
+        case SEARCH_COUNT_MULTIPLE:
+            result->status = EDITOR_MULTIPLE;
+            break;
+        default:
+            result->status = EDITOR_UNDECIDED;
+            break;
+    }
+
+    result->nodes = search->nodes;
+    return 1;
+}
+
+/**
+ * Count and rate one set of posted clues (runs on the worker thread)
+ *
+ * Parameters:
+ *   search - search state owned by the worker
+ *   board  - private copy of the posted clues
+ *   cancel - flag set when newer clues arrive
+ *   answer - receives the editor_result_t
+ *
+ * Returns: 1 if answered, 0 if cancelled
+ */
+static int check_clues(search_t *search, background_board_t *board,
+                       const volatile int *cancel, void *answer)
+{
+    editor_result_t *result = answer;
+
+    for (int cell = 0; cell < 81; cell++)
+        result->clues += board->grid[cell / 9][cell % 9] != 0;
+
+    if (!count_clues(search, board->grid, cancel, result))
+        return 0;
+
+    if (result->status == EDITOR_UNIQUE)
+        result->rating = rate_puzzle(board->grid, NULL);
+
+    return 1;
+}
+
+/**
+ * Start the counting thread
+ *
+ * Parameters:
+ *   editor - counter to initialize
+ *
+ * Returns: 1 on success, 0 if memory or the thread could not be obtained
+ */
+int editor_start(editor_t *editor)
+{
+    return background_start(&editor->worker, check_clues, sizeof(editor_result_t));
+}
+
+/**
+ * Cancel any count in progress and join the counting thread
+ *
+ * Parameters:
+ *   editor - started counter
+ */
+void editor_stop(editor_t *editor)
+{
+    background_stop(&editor->worker);
+}
+
+/**
+ * Post the clues for counting and return at once
+ *
+ * Parameters:
+ *   editor - started counter
+ *   grid   - clues (0 = empty)
+ */
+void editor_post(editor_t *editor, int grid[9][9])
+{
+    background_post(&editor->worker, grid, NULL);
+}
+
+/**
+ * Read the answer for the newest posted clues without waiting
+ *
+ * Parameters:
+ *   editor - started counter
+ *   result - receives the answer
+ */
+void editor_result(editor_t *editor, editor_result_t *result)
+{
+    if (!background_answer(&editor->worker, result))
+    {
+        memset(result, 0, sizeof(*result));
+        result->status = EDITOR_CHECKING;
+    }
+}
@@ -0,0 +1,133 @@
+#include "../include/sudoku.h"
+#include "../include/feedback.h"
+#include "../include/search.h"
+
+/**
+ * Check a board against its stored solution
+ *
+ * Parameters:
+ *   grid     - player's board
+ *   solution - stored solution
+ *
+ * Returns: FEEDBACK_SOLVABLE or FEEDBACK_CONTRADICTED
+ */
+static feedback_status_t compare_with_solution(int grid[9][9], int solution[9][9])
+{
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            if (grid[row][col] != 0 && grid[row][col] != solution[row][col])
+                return FEEDBACK_CONTRADICTED;
+        }
+    }
+
+    return FEEDBACK_SOLVABLE;
+}
+
+/**
+ * Search for any solution that keeps every entry of a board
+ *
+ * Parameters:
+ *   search - search state to use
+ *   grid   - player's board
+ *   cancel - flag set when a newer board arrives
+ *
+ * Returns: answer, or FEEDBACK_PENDING if cancelled
+ */
+static feedback_status_t search_for_completion(search_t *search, int grid[9][9],
+                                               const volatile int *cancel)
+{
+    if (!search_init(search, grid))
+        return FEEDBACK_CONTRADICTED; // Entries already clash
+
+    switch (search_run(search, FEEDBACK_SEARCH_NODES, cancel))
+    {
+        case SEARCH_FOUND:
+            return FEEDBACK_SOLVABLE;
+        case SEARCH_EXHAUSTED:
+            return FEEDBACK_CONTRADICTED;
+        case SEARCH_CANCELLED:
+            return FEEDBACK_PENDING;
+        default:
+            return FEEDBACK_UNKNOWN;
+    }
+}
+
+/**
+ * Check one posted board (runs on the worker thread)
+ *
+ * Parameters:
+ *   search - search state owned by the worker
+ *   board  - private copy of the posted board
+ *   cancel - flag set when a newer board arrives
+ *   answer - receives the feedback_status_t
+ *
+ * Returns: 1 if answered, 0 if cancelled
+ */
+static int check_board(search_t *search, background_board_t *board,
+                       const volatile int *cancel, void *answer)
+{
+    feedback_status_t *status = answer;
+
+    if (board->has_solution)
+        *status = compare_with_solution(board->grid, board->solution);
+    else
+        *status = search_for_completion(search, board->grid, cancel);
+
+    return *status != FEEDBACK_PENDING;
+}
+
+/**
+ * Start the checker thread
+ *
+ * Parameters:
+ *   feedback - checker to initialize
+ *
+ * Returns: 1 on success, 0 if memory or the thread could not be obtained
+ */
+int feedback_start(feedback_t *feedback)
+{
+    return background_start(&feedback->worker, check_board, sizeof(feedback_status_t));
+}
+
+/**
+ * Cancel any check in progress and join the checker thread
+ *
+ * Parameters:
+ *   feedback - started checker
+ */
+void feedback_stop(feedback_t *feedback)
+{
+    background_stop(&feedback->worker);
+}
+
+/**
+ * Post the current board for checking and return at once
+ *
+ * Parameters:
+ *   feedback - started checker
+ *   game     - game whose board is checked
+ */
+void feedback_post(feedback_t *feedback, game_state_t *game)
+{
+    background_post(&feedback->worker, game->grid, game->has_solution ? game->solution : NULL);
+}
+
+/**
+ * Read the answer for the newest posted board without waiting
+ *
+ * Parameters:
+ *   feedback - started checker
+ *
+ * Returns: answer, or FEEDBACK_PENDING if not checked yet
+ */
+feedback_status_t feedback_status(feedback_t *feedback)
+{
+    feedback_status_t status;
+
+    if (!background_answer(&feedback->worker, &status))
+        status = FEEDBACK_PENDING;
+
+    return status;
+}
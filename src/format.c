@@ -0,0 +1,682 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/format.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// JSON members recognized in a puzzle object (bits of parser->seen)
+#define FIELD_GIVENS 0
+#define FIELD_VALUES 1
+#define FIELD_MARKS 2
+
+static const char *format_names[FORMAT_COUNT] = {"line", "sdk", "ss", "json"};
+
+/**
+ * Test whether a byte is a cell of a text grid or JSON cell string
+ *
+ * Parameters:
+ *   c - byte to test
+ *
+ * Returns: 1 for '0'-'9' and '.', 0 otherwise
+ */
+static inline int is_cell(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+/**
+ * Test whether a byte starts a comment or header line
+ *
+ * Parameters:
+ *   c - first byte of the line
+ *
+ * Returns: 1 if the line is skipped, 0 otherwise
+ */
+static inline int starts_comment(char c)
+{
+    return c == '#' || c == '!' || c == '"' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * Start assembling a new puzzle
+ *
+ * Parameters:
+ *   parser - parser state
+ */
+static void begin_puzzle(format_parser_t *parser)
+{
+    parser->cells = 0;
+    parser->line_cells = 0;
+    parser->lines = 0;
+    parser->bars = 0;
+    parser->seen = 0;
+    memset(&parser->record, 0, sizeof(parser->record));
+}
+
+/**
+ * Drop the puzzle being assembled as malformed
+ *
+ * Parameters:
+ *   parser - parser state
+ */
+static void drop_puzzle(format_parser_t *parser)
+{
+    parser->skipped++;
+    begin_puzzle(parser);
+}
+
+/**
+ * Hand the assembled puzzle to the caller and start the next one
+ *
+ * Parameters:
+ *   parser - parser state
+ *   format - format the puzzle was read in
+ *   record - receives the puzzle
+ */
+static void emit_puzzle(format_parser_t *parser, puzzle_format_t format, puzzle_record_t *record)
+{
+    parser->record.format = format;
+    *record = parser->record;
+    parser->puzzles++;
+    begin_puzzle(parser);
+}
+
+/**
+ * Name the format of a completed text grid
+ *
+ * Parameters:
+ *   parser - parser holding the grid
+ *
+ * Returns: FORMAT_LINE, FORMAT_SS or FORMAT_SDK
+ */
+static puzzle_format_t text_format(const format_parser_t *parser)
+{
+    if (parser->lines <= 1)
+        return FORMAT_LINE; // All 81 cells on one line
+    return parser->bars ? FORMAT_SS : FORMAT_SDK;
+}
+
+/**
+ * Store a cell of a text grid or JSON string
+ *
+ * Parameters:
+ *   cells - givens or values of the record
+ *   index - cell index 0-80
+ *   c     - cell byte ('.' and '0' leave the cell empty)
+ */
+static inline void store_cell(int cells[9][9], int index, char c)
+{
+    cells[index / 9][index % 9] = c == '.' ? 0 : c - '0';
+}
+
+/**
+ * Prepare a parser for a new stream
+ *
+ * Parameters:
+ *   parser - parser to reset
+ */
+void format_parser_init(format_parser_t *parser)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->state = FS_LINE_START;
+}
+
+/**
+ * Feed bytes to the parser until a puzzle completes or the bytes run out
+ * Every byte is looked at once; nothing is copied or allocated
+ *
+ * Parameters:
+ *   parser - parser state
+ *   data   - next bytes of the stream
+ *   length - number of bytes
+ *   used   - receives the bytes consumed
+ *   record - receives the puzzle when one completes
+ *
+ * Returns: 1 if a puzzle completed, 0 if all bytes were consumed without one
+ */
+int format_feed(format_parser_t *parser, const char *data, size_t length, size_t *used,
+                puzzle_record_t *record)
+{
+    size_t pos = 0;
+
+    while (pos < length)
+    {
+        char c = data[pos++];
+
+        switch (parser->state)
+        {
+            case FS_LINE_START:
+                if (c == '\n')
+                {
+                    // A blank line inside a grid cuts it short
+                    if (parser->cells > 0)
+                        drop_puzzle(parser);
+                }
+                else if (c == ' ' || c == '\t' || c == '\r' || c == '[' || c == ']' || c == ',')
+                {
+                    // Leading blanks, or the array around JSON objects
+                }
+                else if (c == '{')
+                {
+                    if (parser->cells > 0)
+                        drop_puzzle(parser); // Grid cut short by an object
+                    parser->state = FS_JSON_OBJECT;
+                }
+                else if (starts_comment(c))
+                {
+                    parser->state = FS_SKIP_LINE;
+                }
+                else
+                {
+                    parser->state = FS_TEXT;
+                    pos--; // Read the byte again as part of the grid
+                }
+                break;
+
+            case FS_TEXT:
+                if (is_cell(c))
+                {
+                    if (parser->line_cells == 0)
+                        parser->lines++;
+
+                    // Take the whole run of cells in one go: most bytes of a
+                    // corpus are cells, so this loop is the parser's hot path
+                    int start = parser->cells;
+
+                    store_cell(parser->record.givens, parser->cells++, c);
+
+                    while (parser->cells < 81 && pos < length && is_cell(data[pos]))
+                        store_cell(parser->record.givens, parser->cells++, data[pos++]);
+
+                    parser->line_cells += parser->cells - start;
+
+                    if (parser->cells == 81)
+                        parser->state = FS_PENDING;
+                }
+                else if (c == '\n')
+                {
+                    // Grid lines hold nine cells; separator lines hold none
+                    if (parser->line_cells != 0 && parser->line_cells != 9)
+                        drop_puzzle(parser);
+
+                    parser->line_cells = 0;
+                    parser->state = FS_LINE_START;
+                }
+                else if (c == '|')
+                {
+                    parser->bars = 1;
+                }
+                break;
+
+            case FS_PENDING:
+                if (is_cell(c))
+                {
+                    drop_puzzle(parser); // More cells than a puzzle holds
+                    parser->state = FS_SKIP_LINE;
+                    break;
+                }
+
+                // A grid spread over lines must end on a full line
+                if (parser->lines > 1 && parser->line_cells != 9)
+                {
+                    drop_puzzle(parser);
+                    parser->state = c == '\n' ? FS_LINE_START : FS_SKIP_LINE;
+                    break;
+                }
+
+                emit_puzzle(parser, text_format(parser), record);
+                parser->state = c == '\n' ? FS_LINE_START : FS_SKIP_LINE;
+                *used = pos;
+                return 1;
+
+            case FS_SKIP_LINE:
+                if (c == '\n')
+                {
+                    parser->line_cells = 0;
+                    parser->state = FS_LINE_START;
+                }
+                break;
+
+            case FS_JSON_OBJECT:
+                if (c == '"')
+                {
+                    parser->key_length = 0;
+                    parser->state = FS_JSON_KEY;
+                }
+                else if (c == '}')
+                {
+                    parser->state = FS_LINE_START;
+
+                    if (!(parser->seen & (1 << FIELD_GIVENS)))
+                    {
+                        drop_puzzle(parser); // Nothing to play
+                        break;
+                    }
+
+                    emit_puzzle(parser, FORMAT_JSON, record);
+                    *used = pos;
+                    return 1;
+                }
+                else if (c != ',' && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+                {
+                    parser->depth = 1;
+                    parser->state = FS_JSON_BAD;
+                    pos--; // Drop the object from this byte on
+                }
+                break;
+
+            case FS_JSON_KEY:
+                if (c == '"')
+                    parser->state = FS_JSON_COLON;
+                else if (parser->key_length < FORMAT_KEY_MAX - 1)
+                    parser->key[parser->key_length++] = c;
+                break;
+
+            case FS_JSON_COLON:
+                if (c == ':')
+                {
+                    parser->key[parser->key_length] = '\0';
+                    parser->state = FS_JSON_VALUE;
+                }
+                else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+                {
+                    parser->depth = 1;
+                    parser->state = FS_JSON_BAD;
+                    pos--; // Drop the object from this byte on
+                }
+                break;
+
+            case FS_JSON_VALUE:
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+                    break;
+
+                parser->index = 0;
+
+                if (c == '"' && strcmp(parser->key, "givens") == 0)
+                {
+                    parser->field = FIELD_GIVENS;
+                    parser->state = FS_JSON_CELLS;
+                }
+                else if (c == '"' && strcmp(parser->key, "values") == 0)
+                {
+                    parser->field = FIELD_VALUES;
+                    parser->state = FS_JSON_CELLS;
+                }
+                else if (c == '[' && strcmp(parser->key, "marks") == 0)
+                {
+                    parser->field = FIELD_MARKS;
+                    parser->state = FS_JSON_MARKS;
+                }
+                else
+                {
+                    parser->depth = 0;
+                    parser->state = FS_JSON_SKIP;
+                    pos--; // Skip the value from its first byte
+                }
+                break;
+
+            case FS_JSON_CELLS:
+                if (c == '"' && parser->index == 81)
+                {
+                    parser->seen |= 1 << parser->field;
+                    parser->state = FS_JSON_OBJECT;
+                }
+                else if (is_cell(c) && parser->index < 81)
+                {
+                    store_cell(parser->field == FIELD_GIVENS ? parser->record.givens
+                                                             : parser->record.values,
+                               parser->index++, c);
+                }
+                else
+                {
+                    parser->depth = 1;
+                    parser->escaped = 0;
+                    parser->state = c == '"' ? FS_JSON_BAD : FS_JSON_BAD_STRING;
+                }
+                break;
+
+            case FS_JSON_MARKS:
+                if (c == '"' && parser->index < 81)
+                {
+                    parser->state = FS_JSON_MARK;
+                }
+                else if (c == ']' && (parser->index == 81 || parser->index == 0))
+                {
+                    parser->seen |= 1 << FIELD_MARKS;
+                    parser->state = FS_JSON_OBJECT;
+                }
+                else if (c != ',' && c != ' ' && c != '\t' && c != '\r' && c != '\n')
+                {
+                    parser->depth = 2;
+                    parser->state = FS_JSON_BAD;
+                    pos--; // Drop the object from this byte on
+                }
+                break;
+
+            case FS_JSON_MARK:
+                if (c == '"')
+                {
+                    parser->index++;
+                    parser->state = FS_JSON_MARKS;
+                }
+                else if (c >= '1' && c <= '9')
+                {
+                    parser->record.marks[parser->index] |= (uint16_t)(1 << (c - '1'));
+                }
+                else
+                {
+                    parser->depth = 2;
+                    parser->escaped = 0;
+                    parser->state = FS_JSON_BAD_STRING;
+                }
+                break;
+
+            case FS_JSON_SKIP:
+                if (c == '"')
+                {
+                    parser->escaped = 0;
+                    parser->state = FS_JSON_SKIP_STRING;
+                }
+                else if (c == '{' || c == '[')
+                {
+                    parser->depth++;
+                }
+                else if (c == '}' || c == ']')
+                {
+                    if (parser->depth == 0)
+                    {
+                        parser->state = FS_JSON_OBJECT;
+                        pos--; // The object itself ends here
+                    }
+                    else if (--parser->depth == 0)
+                    {
+                        parser->state = FS_JSON_OBJECT;
+                    }
+                }
+                else if (c == ',' && parser->depth == 0)
+                {
+                    parser->state = FS_JSON_OBJECT;
+                }
+                break;
+
+            case FS_JSON_SKIP_STRING:
+                if (parser->escaped)
+                    parser->escaped = 0;
+                else if (c == '\\')
+                    parser->escaped = 1;
+                else if (c == '"')
+                    parser->state = parser->depth == 0 ? FS_JSON_OBJECT : FS_JSON_SKIP;
+                break;
+
+            case FS_JSON_BAD:
+                if (c == '"')
+                {
+                    parser->escaped = 0;
+                    parser->state = FS_JSON_BAD_STRING;
+                }
+                else if (c == '{' || c == '[')
+                {
+                    parser->depth++;
+                }
+                else if ((c == '}' || c == ']') && --parser->depth == 0)
+                {
+                    drop_puzzle(parser);
+                    parser->state = FS_LINE_START;
+                }
+                break;
+
+            case FS_JSON_BAD_STRING:
+                if (parser->escaped)
+                    parser->escaped = 0;
+                else if (c == '\\')
+                    parser->escaped = 1;
+                else if (c == '"')
+                    parser->state = FS_JSON_BAD;
+                break;
+        }
+    }
+
+    *used = pos;
+    return 0;
+}
+
+/**
+ * Finish the stream: return a puzzle still waiting for its final byte
+ *
+ * Parameters:
+ *   parser - parser state
+ *   record - receives the puzzle
+ *
+ * Returns: 1 if a puzzle completed, 0 otherwise
+ */
+int format_finish(format_parser_t *parser, puzzle_record_t *record)
+{
+    int done = 0;
+
+    if (parser->state == FS_PENDING)
+    {
+        emit_puzzle(parser, text_format(parser), record);
+        done = 1;
+    }
+    else if (parser->cells > 0 || (parser->state != FS_LINE_START && parser->state != FS_TEXT &&
+                                   parser->state != FS_SKIP_LINE))
+    {
+        drop_puzzle(parser); // Grid or object cut off by the end of input
+    }
+
+    parser->state = FS_LINE_START;
+    return done;
+}
+
+/**
+ * Write the 81 cells of a grid as digits and dots
+ *
+ * Parameters:
+ *   cells - grid to write
+ *   out   - receives 81 bytes
+ *
+ * Returns: bytes written
+ */
+static size_t put_cells(const int cells[9][9], char *out)
+{
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int value = cells[cell / 9][cell % 9];
+        out[cell] = value ? (char)('0' + value) : '.';
+    }
+
+    return 81;
+}
+
+/**
+ * Write a puzzle as a JSON object on one line
+ *
+ * Parameters:
+ *   record - puzzle to write
+ *   out    - output buffer
+ *
+ * Returns: bytes written
+ */
+static size_t put_json(const puzzle_record_t *record, char *out)
+{
+    size_t length = 0;
+    int has_values = 0, has_marks = 0;
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        has_values |= record->values[cell / 9][cell % 9];
+        has_marks |= record->marks[cell];
+    }
+
+    memcpy(out, "{\"givens\":\"", 11);
+    length += 11;
+    length += put_cells(record->givens, out + length);
+    out[length++] = '"';
+
+    if (has_values)
+    {
+        memcpy(out + length, ",\"values\":\"", 11);
+        length += 11;
+        length += put_cells(record->values, out + length);
+        out[length++] = '"';
+    }
+
+    if (has_marks)
+    {
+        memcpy(out + length, ",\"marks\":[", 10);
+        length += 10;
+
+        for (int cell = 0; cell < 81; cell++)
+        {
+            if (cell > 0)
+                out[length++] = ',';
+            out[length++] = '"';
+
+            for (int digit = 1; digit <= 9; digit++)
+            {
+                if (record->marks[cell] & (1 << (digit - 1)))
+                    out[length++] = (char)('0' + digit);
+            }
+
+            out[length++] = '"';
+        }
+
+        out[length++] = ']';
+    }
+
+    out[length++] = '}';
+    out[length++] = '\n';
+    return length;
+}
+
+/**
+ * Write a puzzle in a format
+ *
+ * Parameters:
+ *   record - puzzle to write
+ *   format - output format
+ *   out    - buffer of at least FORMAT_RECORD_MAX bytes
+ *
+ * Returns: bytes written
+ */
+size_t format_puzzle(const puzzle_record_t *record, puzzle_format_t format, char *out)
+{
+    size_t length = 0;
+    char cells[81];
+
+    if (format == FORMAT_JSON)
+        return put_json(record, out);
+
+    put_cells(record->givens, cells);
+
+    switch (format)
+    {
+        case FORMAT_SDK:
+            for (int row = 0; row < 9; row++)
+            {
+                memcpy(out + length, cells + row * 9, 9);
+                length += 9;
+                out[length++] = '\n';
+            }
+            out[length++] = '\n'; // Blank line between puzzles
+            break;
+
+        case FORMAT_SS:
+            for (int row = 0; row < 9; row++)
+            {
+                if (row == 3 || row == 6)
+                {
+                    memcpy(out + length, "-----------\n", 12);
+                    length += 12;
+                }
+
+                for (int col = 0; col < 9; col++)
+                {
+                    if (col == 3 || col == 6)
+                        out[length++] = '|';
+                    out[length++] = cells[row * 9 + col];
+                }
+
+                out[length++] = '\n';
+            }
+            out[length++] = '\n';
+            break;
+
+        default:
+            memcpy(out, cells, 81);
+            length = 81;
+            out[length++] = '\n';
+            break;
+    }
+
+    return length;
+}
+
+/**
+ * Parse a format name
+ *
+ * Parameters:
+ *   name   - "line", "sdk", "ss" or "json"
+ *   format - receives the parsed format
+ *
+ * Returns: 1 if recognized, 0 otherwise
+ */
+int parse_format(const char *name, puzzle_format_t *format)
+{
+    for (int i = 0; i < FORMAT_COUNT; i++)
+    {
+        if (strcmp(name, format_names[i]) == 0)
+        {
+            *format = (puzzle_format_t)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Read the first puzzle of a file
+ *
+ * Parameters:
+ *   path   - file path, or "-" for standard input
+ *   record - receives the puzzle
+ *
+ * Returns: 1 if a puzzle was read, 0 on I/O error or when none was found
+ */
+int read_puzzle_file(const char *path, puzzle_record_t *record)
+{
+    int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    char buffer[4096];
+    format_parser_t parser;
+    int found = 0;
+
+    if (fd < 0)
+        return 0; // Cannot open file
+
+    format_parser_init(&parser);
+
+    while (!found)
+    {
+        ssize_t got = read(fd, buffer, sizeof(buffer));
+        size_t used;
+
+        if (got < 0 && errno == EINTR)
+            continue; // Interrupted - retry
+
+        if (got <= 0)
+        {
+            found = format_finish(&parser, record); // End of input (or read error)
+            break;
+        }
+
+        found = format_feed(&parser, buffer, (size_t)got, &used, record);
+    }
+
+    if (fd != STDIN_FILENO)
+        close(fd);
+
+    return found;
+}
@@ -4,6 +4,11 @@
 #include "../include/generator.h"
 #include "../include/solver.h"
 #include "../include/display.h"  // Add this line
+#include "../include/topology.h"
+#include "../include/branch.h"
+#include "../include/format.h"
+#include "../include/daily.h"
+#include "../include/pool.h"
 #include <time.h>
 
 /*
@@ -31,10 +36,12 @@
 void init_game(game_state_t *game, difficulty_t difficulty)
 {
     game->difficulty = difficulty; // Store difficulty setting
+    game->variant = VARIANT_CLASSIC; // Plain rows, columns and boxes
     game->is_paused = 0;           // Game starts unpaused
     game->start_time = 0;          // Timer not started yet
     game->show_marks = 0;          // Start in number entry mode
     game->completion_time = 0;     // No completion time yet
+    init_branches(game);           // No what-if branches yet
 
     new_puzzle(game); // Generate initial puzzle
 }
@@ -74,8 +81,46 @@ void check_solution(game_state_t *game)
  */
 void new_puzzle(game_state_t *game)
 {
-    // Generate new puzzle with current difficulty setting
-    generate_puzzle(game->grid, game->solution, game->given, game->difficulty);
+    // Rule checks, hints and the generator all follow the active variant;
+    // every jigsaw puzzle gets a fresh region layout
+    if (game->variant == VARIANT_JIGSAW)
+    {
+        uint8_t regions[81];
+
+        generate_regions(regions, NULL);
+        set_current_regions(regions);
+    }
+    else
+    {
+        set_current_variant(game->variant);
+    }
+
+    // Killer puzzles have no givens: the difficulty sets the cage sizes and
+    // the generator installs the cages it cuts
+    if (game->variant == VARIANT_KILLER)
+    {
+        cage_layout_t cages;
+
+        generate_killer_puzzle(game->grid, game->solution, game->given, game->difficulty, NULL,
+                               &cages);
+    }
+    else if (game->variant == VARIANT_CLASSIC &&
+             pool_take(game->difficulty, game->grid, game->solution))
+    {
+        // Ready-made puzzle from the shared pool (see sudoku --daemon)
+        for (int row = 0; row < GRID_SIZE; row++)
+        {
+            for (int col = 0; col < GRID_SIZE; col++)
+                game->given[row][col] = game->grid[row][col] != 0;
+        }
+    }
+    else
+    {
+        // Generate new puzzle with current difficulty setting
+        generate_puzzle(game->grid, game->solution, game->given, game->difficulty);
+    }
+
+    game->has_solution = 1; // Generated puzzles always carry their solution
 
     // Reset cursor to top-left corner
     game->cursor_row = 0;
@@ -85,6 +130,7 @@ void new_puzzle(game_state_t *game)
     game->moves = 0;
     game->is_completed = 0;
     game->completion_time = 0; // Clear any previous completion time
+    clear_branches(game);      // Branches belong to the old puzzle
 
     // Clear all pencil marks for fresh start
     for (int row = 0; row < GRID_SIZE; row++)
@@ -99,6 +145,250 @@ void new_puzzle(game_state_t *game)
     }
 }
 
+/**
+ * Switch to the next variant and start a new puzzle under its rules
+ * Cycles classic -> X-Sudoku -> Windoku -> Jigsaw -> Killer -> Samurai -> classic
+ * The Samurai layout is played from its own state (samurai_game_t), so the
+ * 9x9 puzzle is left alone for it
+ *
+ * Parameters:
+ *   game - pointer to game state structure
+ */
+void change_variant(game_state_t *game)
+{
+    game->variant = (variant_t)((game->variant + 1) % VARIANT_COUNT);
+
+    if (game->variant != VARIANT_SAMURAI)
+        new_puzzle(game);
+}
+
+/**
+ * Turn the current puzzle into editable clues
+ *
+ * Parameters:
+ *   game - pointer to game state structure
+ */
+void start_editing(game_state_t *game)
+{
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            if (!game->given[row][col])
+                game->grid[row][col] = 0; // Player entries are not clues
+
+            game->given[row][col] = 0;
+            memset(game->marks[row][col], 0, sizeof(game->marks[row][col]));
+        }
+    }
+
+    clear_branches(game);
+    game->show_marks = 0;
+    game->is_completed = 0;
+    game->completion_time = 0;
+}
+
+/**
+ * Start playing the clues left by the editor
+ *
+ * Parameters:
+ *   game     - pointer to game state structure
+ *   solution - the unique solution of the clues
+ */
+void play_edited_puzzle(game_state_t *game, int solution[9][9])
+{
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            game->given[row][col] = game->grid[row][col] != 0;
+            game->solution[row][col] = solution[row][col];
+        }
+    }
+
+    game->has_solution = 1;
+    game->moves = 0;
+    game->is_completed = 0;
+    game->completion_time = 0;
+    start_timer(game);
+}
+
+/**
+ * Keep the first solution found while loading a puzzle
+ *
+ * Parameters:
+ *   solution  - solution found by the enumerator
+ *   user_data - solution array of the game
+ *
+ * Returns: 1 to look for a second solution
+ */
+static int keep_first_solution(int solution[9][9], void *user_data)
+{
+    int (*first)[9] = user_data;
+
+    if (first[0][0] == 0)
+        memcpy(first, solution, sizeof(int[9][9]));
+
+    return 1;
+}
+
+/**
+ * Reset progress for a puzzle that was just put on the board
+ *
+ * Parameters:
+ *   game - pointer to game state structure
+ */
+static void begin_loaded_puzzle(game_state_t *game)
+{
+    game->cursor_row = 0;
+    game->cursor_col = 0;
+    game->moves = 0;
+    game->show_marks = 0;
+    game->is_completed = 0;
+    game->completion_time = 0;
+    clear_branches(game);
+    start_timer(game);
+}
+
+/**
+ * Load the first puzzle of a file as a classic puzzle
+ * Clues become givens; player values and marks saved in JSON are restored.
+ * The solution is computed here, counting up to two to learn whether it is
+ * unique
+ *
+ * Parameters:
+ *   game - pointer to game state structure
+ *   path - puzzle file, or "-" for stdin
+ *
+ * Returns: solutions found (1 = unique, 2 = several), 0 if none,
+ *          -1 if the file holds no readable puzzle
+ */
+int load_puzzle(game_state_t *game, const char *path)
+{
+    puzzle_record_t record;
+    int solution[9][9];
+
+    if (!read_puzzle_file(path, &record))
+        return -1;
+
+    // Files carry classic clues only
+    set_current_variant(VARIANT_CLASSIC);
+    memset(solution, 0, sizeof(solution));
+
+    long count = enumerate_solutions(record.givens, 2, keep_first_solution, solution, NULL);
+
+    if (count == 0)
+        return 0; // Leave the current puzzle alone
+
+    game->variant = VARIANT_CLASSIC;
+
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            int given = record.givens[row][col];
+            uint16_t marks = record.marks[row * 9 + col];
+
+            game->given[row][col] = given != 0;
+            game->grid[row][col] = given ? given : record.values[row][col];
+            game->solution[row][col] = solution[row][col];
+
+            for (int mark = 0; mark < GRID_SIZE; mark++)
+                game->marks[row][col][mark] = (marks >> mark) & 1;
+        }
+    }
+
+    // With several solutions the first one found is only a stand-in
+    game->has_solution = count == 1;
+    begin_loaded_puzzle(game);
+
+    return (int)count;
+}
+
+/**
+ * Start the daily puzzle of a date under classic rules
+ *
+ * Parameters:
+ *   game - pointer to game state structure
+ *   date - date as YYYYMMDD
+ *
+ * Returns: 1 if the puzzle came from the daily cache, 0 if it was generated
+ */
+int new_daily_puzzle(game_state_t *game, long date)
+{
+    daily_puzzle_t puzzle;
+
+    game->variant = VARIANT_CLASSIC;
+    set_current_variant(VARIANT_CLASSIC);
+
+    int cached = daily_get(date, game->difficulty, &puzzle);
+
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            game->grid[row][col] = puzzle.grid[row][col];
+            game->given[row][col] = puzzle.grid[row][col] != 0;
+            game->solution[row][col] = puzzle.solution[row][col];
+            memset(game->marks[row][col], 0, sizeof(game->marks[row][col]));
+        }
+    }
+
+    game->has_solution = 1;
+    begin_loaded_puzzle(game);
+
+    return cached;
+}
+
+/**
+ * Save the current puzzle with the player's entries and marks
+ *
+ * Parameters:
+ *   game   - pointer to game state structure
+ *   path   - file to write (replaced if it exists)
+ *   format - file format; only JSON keeps entries and marks
+ *
+ * Returns: 1 on success, 0 for non-classic rules or on I/O error
+ */
+int save_puzzle(const game_state_t *game, const char *path, puzzle_format_t format)
+{
+    puzzle_record_t record;
+    char text[FORMAT_RECORD_MAX];
+
+    // The formats have no place for regions or cages
+    if (game->variant != VARIANT_CLASSIC)
+        return 0;
+
+    memset(&record, 0, sizeof(record));
+
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            if (game->given[row][col])
+                record.givens[row][col] = game->grid[row][col];
+            else
+                record.values[row][col] = game->grid[row][col];
+
+            for (int mark = 0; mark < GRID_SIZE; mark++)
+            {
+                if (game->marks[row][col][mark])
+                    record.marks[row * 9 + col] |= (uint16_t)(1 << mark);
+            }
+        }
+    }
+
+    FILE *file = fopen(path, "w");
+
+    if (file == NULL)
+        return 0;
+
+    size_t length = format_puzzle(&record, format, text);
+    int written = fwrite(text, 1, length, file) == length;
+
+    return fclose(file) == 0 && written;
+}
+
 /**
  * Auto-solve the current puzzle by copying solution to grid
  * Fills in all empty cells with correct numbers
@@ -113,7 +403,11 @@ void solve_puzzle(game_state_t *game)
     {
         for (int col = 0; col < GRID_SIZE; col++)
         {
-            game->grid[row][col] = game->solution[row][col];
+            if (game->grid[row][col] != game->solution[row][col])
+            {
+                record_cell(game, row, col);
+                game->grid[row][col] = game->solution[row][col];
+            }
         }
     }
 
@@ -140,6 +434,7 @@ void delete_number(game_state_t *game)
         }
 
         // Clear the number from current cell
+        record_cell(game, game->cursor_row, game->cursor_col);
         game->grid[game->cursor_row][game->cursor_col] = 0;
 
         // Clear all pencil marks for this cell
@@ -253,6 +548,7 @@ void reset_game(game_state_t *game)
     game->cursor_col = 0;
     game->moves = 0;        // Clear move counter
     game->is_completed = 0; // Mark as incomplete
+    clear_branches(game);   // Nothing left to roll back to
 }
 
 // ============================================================================
@@ -342,6 +638,125 @@ int get_elapsed_time(game_state_t *game)
     }
 }
 
+/**
+ * Generate a new Samurai puzzle and reset the game state
+ *
+ * Parameters:
+ *   game       - Samurai state to reset
+ *   difficulty - level selecting the clue count
+ */
+void new_samurai_puzzle(samurai_game_t *game, difficulty_t difficulty)
+{
+    game->difficulty = difficulty;
+    game->clues = samurai_generate(game->grid, game->solution, difficulty, NULL);
+
+    for (int cell = 0; cell < SAMURAI_CELLS; cell++)
+        game->given[cell] = game->grid[cell] != 0;
+
+    game->cursor = 0;
+    game->moves = 0;
+    game->start_time = time(NULL);
+    game->completion_time = 0;
+}
+
+/**
+ * Move the cursor one cell in a direction, jumping over holes
+ *
+ * Parameters:
+ *   game - Samurai state
+ *   drow - row step (-1, 0 or 1)
+ *   dcol - column step (-1, 0 or 1)
+ */
+void move_samurai_cursor(samurai_game_t *game, int drow, int dcol)
+{
+    const samurai_layout_t *layout = samurai_layout();
+    int row = layout->row[game->cursor] + drow;
+    int col = layout->col[game->cursor] + dcol;
+
+    // Holes are whole boxes, so the next cell is at most a box away
+    while (row >= 0 && row < SAMURAI_SIZE && col >= 0 && col < SAMURAI_SIZE)
+    {
+        if (layout->index[row][col] >= 0)
+        {
+            game->cursor = layout->index[row][col];
+            return;
+        }
+
+        row += drow;
+        col += dcol;
+    }
+}
+
+/**
+ * Enter a number at the cursor unless the cell is a clue
+ *
+ * Parameters:
+ *   game - Samurai state
+ *   num  - number to enter (1-9)
+ */
+void enter_samurai_number(samurai_game_t *game, int num)
+{
+    if (game->given[game->cursor] || game->completion_time != 0)
+        return;
+
+    game->grid[game->cursor] = num;
+    game->moves++;
+}
+
+/**
+ * Clear the cursor cell unless it is a clue
+ *
+ * Parameters:
+ *   game - Samurai state
+ */
+void delete_samurai_number(samurai_game_t *game)
+{
+    if (game->given[game->cursor] || game->grid[game->cursor] == 0)
+        return;
+
+    game->grid[game->cursor] = 0;
+    game->moves++;
+}
+
+/**
+ * Reveal the complete solution
+ *
+ * Parameters:
+ *   game - Samurai state
+ */
+void solve_samurai_puzzle(samurai_game_t *game)
+{
+    memcpy(game->grid, game->solution, sizeof(game->grid));
+}
+
+/**
+ * Check whether every cell matches the solution
+ *
+ * Parameters:
+ *   game - Samurai state
+ *
+ * Returns: 1 if complete and correct, 0 otherwise
+ */
+int is_samurai_complete(const samurai_game_t *game)
+{
+    return memcmp(game->grid, game->solution, sizeof(game->grid)) == 0;
+}
+
+/**
+ * Elapsed time of a Samurai game, frozen once completed
+ *
+ * Parameters:
+ *   game - Samurai state
+ *
+ * Returns: elapsed time in seconds
+ */
+int get_samurai_elapsed_time(const samurai_game_t *game)
+{
+    time_t end = game->completion_time ? game->completion_time : time(NULL);
+
+    return (int)(end - game->start_time);
+}
+
 /**
  * Hint System Implementation for Sudoku Game
  * Add these functions to your game.c file
@@ -433,7 +848,8 @@ int find_naked_single(game_state_t *game, int *hint_row, int *hint_col, int *hin
 
 /**
  * Find hidden singles - numbers that can only go in one cell within a region
- * Checks rows, columns, and 3x3 boxes for numbers with only one valid position
+ * Checks every unit of the active variant (rows, columns, 3x3 boxes, then
+ * diagonals or windows) for numbers with only one valid position
  *
  * @param game Pointer to game state
  * @param hint_row Pointer to store hint row position
@@ -443,50 +859,28 @@ int find_naked_single(game_state_t *game, int *hint_row, int *hint_col, int *hin
  */
 int find_hidden_single(game_state_t *game, int *hint_row, int *hint_col, int *hint_value)
 {
+    const topology_t *topology = current_topology();
+
     // Check each number (1-9)
     for (int num = 1; num <= GRID_SIZE; num++)
     {
-
-        // Check rows for hidden singles
-        for (int row = 0; row < GRID_SIZE; row++)
+        // Check each unit in topology order: rows, columns, boxes, extras
+        for (int unit = 0; unit < topology->unit_count; unit++)
         {
-            int possible_cols[GRID_SIZE];
+            int possible_cell = -1;
             int possible_count = 0;
 
-            // Find all possible positions for this number in this row
-            for (int col = 0; col < GRID_SIZE; col++)
+            // Find all possible positions for this number in this unit
+            for (int i = 0; i < GRID_SIZE && possible_count < 2; i++)
             {
-                if (game->grid[row][col] == 0 &&
-                    is_valid_placement(game->grid, row, col, num))
-                {
-                    possible_cols[possible_count] = col;
-                    possible_count++;
-                }
-            }
-
-            // If only one position possible, it's a hidden single
-            if (possible_count == 1)
-            {
-                *hint_row = row;
-                *hint_col = possible_cols[0];
-                *hint_value = num;
-                return 1;
-            }
-        }
-
-        // Check columns for hidden singles
-        for (int col = 0; col < GRID_SIZE; col++)
-        {
-            int possible_rows[GRID_SIZE];
-            int possible_count = 0;
+                int cell = topology->units[unit][i];
+                int row = cell / 9;
+                int col = cell % 9;
 
-            // Find all possible positions for this number in this column
-            for (int row = 0; row < GRID_SIZE; row++)
-            {
                 if (game->grid[row][col] == 0 &&
                     is_valid_placement(game->grid, row, col, num))
                 {
-                    possible_rows[possible_count] = row;
+                    possible_cell = cell;
                     possible_count++;
                 }
             }
@@ -494,49 +888,12 @@ int find_hidden_single(game_state_t *game, int *hint_row, int *hint_col, int *hi
             // If only one position possible, it's a hidden single
             if (possible_count == 1)
             {
-                *hint_row = possible_rows[0];
-                *hint_col = col;
+                *hint_row = possible_cell / 9;
+                *hint_col = possible_cell % 9;
                 *hint_value = num;
                 return 1;
             }
         }
-
-        // Check 3x3 boxes for hidden singles
-        for (int box_row = 0; box_row < 3; box_row++)
-        {
-            for (int box_col = 0; box_col < 3; box_col++)
-            {
-                int possible_positions[9][2]; // Store [row, col] pairs
-                int possible_count = 0;
-
-                int start_row = box_row * 3;
-                int start_col = box_col * 3;
-
-                // Find all possible positions for this number in this 3x3 box
-                for (int r = start_row; r < start_row + 3; r++)
-                {
-                    for (int c = start_col; c < start_col + 3; c++)
-                    {
-                        if (game->grid[r][c] == 0 &&
-                            is_valid_placement(game->grid, r, c, num))
-                        {
-                            possible_positions[possible_count][0] = r;
-                            possible_positions[possible_count][1] = c;
-                            possible_count++;
-                        }
-                    }
-                }
-
-                // If only one position possible, it's a hidden single
-                if (possible_count == 1)
-                {
-                    *hint_row = possible_positions[0][0];
-                    *hint_col = possible_positions[0][1];
-                    *hint_value = num;
-                    return 1;
-                }
-            }
-        }
     }
 
     return 0; // No hidden singles found
@@ -1,8 +1,14 @@
 #include "../include/sudoku.h"
 #include "../include/generator.h"
 #include "../include/solver.h"
+#include "../include/unavoidable.h"
+#include "../include/topology.h"
+#include "../include/search.h"
+#include "../include/killer.h"
 #include <time.h>
 
+#define HITTING_SET_NODES 2000  // Search budget per check of a sparse clue pattern
+
 /**
  * Swap two integer values using pointers
  * Utility function for array shuffling
@@ -39,6 +45,66 @@ void shuffle_array(int *array, int num)
     }
 }
 
+/**
+ * Shuffle an array using Fisher-Yates with a seeded generator
+ * Reproducible counterpart of shuffle_array()
+ * 
+ * Parameters:
+ *   array - array to shuffle
+ *   num   - number of elements in array
+ *   rng   - generator state
+ */
+void shuffle_array_seeded(int *array, int num, rng_t *rng)
+{
+    for (int i = num - 1; i > 0; i--)
+    {
+        int j = rng_below(rng, i + 1);
+
+        swap(&array[i], &array[j]);
+    }
+}
+
+/**
+ * Fill an empty grid under variant rules
+ * Row-order backtracking stalls on diagonals, windows and jigsaw regions, so
+ * a few random digits are scattered first and the bitmask search completes
+ * the grid under a node budget, restarting with new digits when it stalls
+ *
+ * Parameters:
+ *   grid - 9x9 array that receives the complete grid
+ *   rng  - seeded generator, or NULL to use rand()
+ *
+ * Returns: 1 once a grid is found
+ */
+static int fill_variant_grid(int grid[9][9], rng_t *rng)
+{
+    search_t search;
+
+    for (;;)
+    {
+        memset(grid, 0, sizeof(int[9][9]));
+
+        for (int placed = 0; placed < VARIANT_FILL_SEEDS; )
+        {
+            int cell = rng ? rng_below(rng, 81) : rand() % 81;
+            int value = 1 + (rng ? rng_below(rng, 9) : rand() % 9);
+
+            if (grid[cell / 9][cell % 9] == 0 && is_valid_placement(grid, cell / 9, cell % 9, value))
+            {
+                grid[cell / 9][cell % 9] = value;
+                placed++;
+            }
+        }
+
+        if (search_init(&search, grid) &&
+            search_run(&search, VARIANT_FILL_NODES, NULL) == SEARCH_FOUND)
+        {
+            search_get_grid(&search, grid);
+            return 1;
+        }
+    }
+}
+
 /**
  * Generate a complete, valid Sudoku grid using randomized backtracking
  * Creates a fully solved 9x9 grid that satisfies all Sudoku rules
@@ -57,6 +123,9 @@ int generate_complete_grid(int grid[9][9])
     int numbers[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
     shuffle_array(numbers, 9);
 
+    if (current_topology()->variant != VARIANT_CLASSIC)
+        return fill_variant_grid(grid, NULL);
+
     // Base case: if no empty cells found, grid is complete
     if (!find_empty_cell(grid, &row, &col))
     {
@@ -84,6 +153,74 @@ int generate_complete_grid(int grid[9][9])
     return 0; // No valid number worked - backtrack further
 }
 
+/**
+ * Fill an empty grid with a complete solution using a seeded generator
+ * Same algorithm as generate_complete_grid() with reproducible shuffles
+ * 
+ * Parameters:
+ *   grid - 9x9 array to fill (empty cells are 0)
+ *   rng  - generator state
+ * 
+ * Returns: 1 if successful generation, 0 if failed
+ */
+int generate_complete_grid_seeded(int grid[9][9], rng_t *rng)
+{
+    int row = 0, col = 0;
+    int numbers[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    if (current_topology()->variant != VARIANT_CLASSIC)
+        return fill_variant_grid(grid, rng);
+
+    if (!find_empty_cell(grid, &row, &col))
+    {
+        return 1; // Grid is fully generated
+    }
+
+    shuffle_array_seeded(numbers, 9, rng);
+
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        int guess = numbers[i];
+
+        if (is_valid_placement(grid, row, col, guess))
+        {
+            grid[row][col] = guess;
+
+            if (generate_complete_grid_seeded(grid, rng))
+                return 1;
+
+            grid[row][col] = 0; // Backtrack
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Generate a complete solution grid that depends only on a seed
+ * Always fills under the classic rules: seeded records store no variant, so
+ * the same seed must give the same grid whatever --variant is active
+ * 
+ * Parameters:
+ *   solution - 9x9 array that receives the complete grid
+ *   seed     - 64-bit seed
+ * 
+ * Returns: 1 if successful generation, 0 if failed
+ */
+int generate_solution_from_seed(int solution[9][9], uint64_t seed)
+{
+    rng_t rng;
+    const topology_t *previous = use_thread_topology(get_topology(VARIANT_CLASSIC));
+
+    rng_seed(&rng, seed);
+    memset(solution, 0, sizeof(int[9][9]));
+
+    int generated = generate_complete_grid_seeded(solution, &rng);
+
+    use_thread_topology(previous);
+    return generated;
+}
+
 /**
  * Determine number of cells to remove based on difficulty level
  * More removed cells = harder puzzle (fewer clues to work with)
@@ -111,104 +248,630 @@ int get_cells_to_remove(difficulty_t difficulty)
 }
 
 /**
- * Generate a complete Sudoku puzzle with specified difficulty
- * Creates puzzle grid, solution grid, and given array
- * Ensures puzzle has exactly one unique solution
+ * Pick a random index in [0, bound) from the seeded generator or rand()
  * 
  * Parameters:
- *   grid       - 9x9 array for the puzzle (with cells removed)
- *   solution   - 9x9 array storing the complete solution
- *   given      - 9x9 array marking which cells are original clues
- *   difficulty - desired puzzle difficulty level
+ *   rng   - seeded generator, or NULL to use rand()
+ *   bound - exclusive upper bound
  * 
- * Returns: 1 if successful generation, 0 if failed
+ * Returns: random integer from 0 to bound - 1
  */
-int generate_puzzle(int grid[9][9], int solution[9][9], int given[9][9], difficulty_t difficulty)
+static int random_below(rng_t *rng, int bound)
 {
-    srand(time(NULL)); // Seed random number generator with current time
+    return rng ? rng_below(rng, bound) : rand() % bound;
+}
 
-    // Initialize counters for cell removal process
-    int removed_count = 0;
-    int cells_to_remove = get_cells_to_remove(difficulty);
+/**
+ * Generate a random jigsaw region layout
+ * Starts from the boxes and repeatedly hands a cell to a neighbouring
+ * region, taking back a random cell of that region on the border, so every
+ * region keeps nine cells; a trade that would split a region is undone.
+ * Some layouts admit no grid at all, so each finished walk is accepted only
+ * once a search finds it solvable
+ *
+ * Parameters:
+ *   regions - receives the region (0-8) of each cell
+ *   rng     - seeded generator, or NULL to use rand()
+ *
+ * Returns: number of trades made on the accepted layout
+ */
+int generate_regions(uint8_t regions[81], rng_t *rng)
+{
+    topology_t layout;
+    search_t search;
+    int empty[9][9] = {{0}};
+    int trades;
+    search_count_t result;
+
+    do
+    {
+        trades = 0;
+
+        for (int cell = 0; cell < 81; cell++)
+            regions[cell] = (uint8_t)((cell / 27) * 3 + (cell % 9) / 3);
+
+        for (int step = 0; step < REGION_SHUFFLE_STEPS; step++)
+        {
+            int a = random_below(rng, 81);
+            int row = a / 9, col = a % 9;
+            int neighbours[4] = {row > 0 ? a - 9 : -1, row < 8 ? a + 9 : -1,
+                                 col > 0 ? a - 1 : -1, col < 8 ? a + 1 : -1};
+            int next = neighbours[random_below(rng, 4)];
+
+            if (next < 0 || regions[next] == regions[a])
+                continue;
+
+            int from = regions[a], to = regions[next];
+            int border[81], border_count = 0;
+
+            regions[a] = (uint8_t)to;
+
+            // Cells of the other region that touch this one and could come back
+            for (int cell = 0; cell < 81; cell++)
+            {
+                int r = cell / 9, c = cell % 9;
+
+                if (regions[cell] != to || cell == a)
+                    continue;
+
+                if ((r > 0 && regions[cell - 9] == from) || (r < 8 && regions[cell + 9] == from) ||
+                    (c > 0 && regions[cell - 1] == from) || (c < 8 && regions[cell + 1] == from))
+                    border[border_count++] = cell;
+            }
+
+            if (border_count == 0)
+            {
+                regions[a] = (uint8_t)from;
+                continue;
+            }
+
+            int b = border[random_below(rng, border_count)];
+
+            regions[b] = (uint8_t)from;
+
+            if (region_connected(regions, from) && region_connected(regions, to))
+            {
+                trades++;
+            }
+            else
+            {
+                regions[a] = (uint8_t)from; // Undo: a region would split
+                regions[b] = (uint8_t)to;
+            }
+        }
+
+        build_region_topology(&layout, regions);
+
+        const topology_t *previous = use_thread_topology(&layout);
 
-    // Set up attempt limiting to prevent infinite loops
-    int attempts = 0;
-    int max_attempts = cells_to_remove * 10; // Allow reasonable retry limit
+        result = search_count_to_two(&search, empty, REGION_CHECK_NODES, NULL, NULL);
+        use_thread_topology(previous);
+    } while (result != SEARCH_COUNT_UNIQUE && result != SEARCH_COUNT_MULTIPLE);
+
+    return trades;
+}
 
-    // Step 1: Clear the grid to start with empty puzzle
-    for (int row = 0; row < 9; row++)
+/**
+ * Generate a Killer Sudoku with no givens
+ * Cuts a new grid into random cages, then, while another solution exists,
+ * splits the largest cage holding a cell where the two solutions differ.
+ * Smaller cages only remove solutions, so the loop ends on a unique layout.
+ * Searches on loose early layouts have a heavy tail, so each check gets a
+ * node budget and an undecided check splits the largest cage instead
+ *
+ * Parameters:
+ *   grid       - 9x9 array for the puzzle (all empty)
+ *   solution   - 9x9 array storing the complete solution
+ *   given      - 9x9 array marking original clues (all 0)
+ *   difficulty - level selecting the cage sizes
+ *   rng        - seeded generator, or NULL to use rand()
+ *   layout     - receives the cages, also installed with set_current_cages()
+ *
+ * Returns: number of cage splits needed for uniqueness
+ */
+int generate_killer_puzzle(int grid[9][9], int solution[9][9], int given[9][9],
+                           difficulty_t difficulty, rng_t *rng, cage_layout_t *layout)
+{
+    topology_t killer;
+    int other[9][9];
+    int splits = 0;
+
+    // The solution is an ordinary grid; cages are cut from it afterwards
+    use_thread_topology(get_topology(VARIANT_CLASSIC));
+    memset(solution, 0, sizeof(int[9][9]));
+
+    if (rng)
+        generate_complete_grid_seeded(solution, rng);
+    else
+        generate_complete_grid(solution);
+
+    generate_cages(solution, difficulty, rng, layout);
+    memset(grid, 0, sizeof(int[9][9]));
+    memset(given, 0, sizeof(int[9][9]));
+
+    for (;;)
     {
-        for (int col = 0; col < 9; col++)
+        build_cage_topology(&killer, layout);
+        use_thread_topology(&killer);
+
+        int found = find_other_solution_limited(grid, solution, other, KILLER_SEARCH_NODES);
+
+        if (found == 0)
+            break;
+
+        int split = -1, split_size = 1;
+
+        // Split where the solutions differ, or the largest cage if undecided
+        for (int cell = 0; cell < 81; cell++)
         {
-            grid[row][col] = 0; // Initialize all cells to empty
+            int size = killer.cages[killer.cage_of[cell]].size;
+
+            if ((found < 0 || other[cell / 9][cell % 9] != solution[cell / 9][cell % 9]) &&
+                size > split_size)
+            {
+                split = cell;
+                split_size = size;
+            }
         }
+
+        // Cannot happen: a one-cell cage fixes its digit
+        if (split < 0 || !split_cage(layout, split, solution))
+            break;
+
+        splits++;
     }
 
-    // Step 2: Generate a complete, valid Sudoku solution
-    generate_complete_grid(grid);
+    use_thread_topology(NULL);
+    set_current_cages(layout);
 
-    // Step 3: Store the complete solution in solution array
-    // This preserves the full solution for reference (e.g., when player requests hint)
-    for (int row = 0; row < GRID_SIZE; row++)
+    return splits;
+}
+
+/**
+ * Map a cell through one of the eight symmetries of the square
+ * 
+ * Parameters:
+ *   transform - 0 identity, 1-3 quarter turns, 4-7 reflections
+ *   cell      - cell index (row * 9 + col)
+ * 
+ * Returns: index of the image cell
+ */
+static int transform_cell(int transform, int cell)
+{
+    int row = cell / 9;
+    int col = cell % 9;
+
+    switch (transform)
     {
-        for (int col = 0; col < GRID_SIZE; col++)
+        case 1: return col * 9 + (8 - row);             // Quarter turn clockwise
+        case 2: return (8 - row) * 9 + (8 - col);       // Half turn
+        case 3: return (8 - col) * 9 + row;             // Quarter turn counter-clockwise
+        case 4: return row * 9 + (8 - col);             // Left-right mirror
+        case 5: return (8 - row) * 9 + col;             // Top-bottom mirror
+        case 6: return col * 9 + row;                   // Main diagonal
+        case 7: return (8 - col) * 9 + (8 - row);       // Anti-diagonal
+        default: return cell;
+    }
+}
+
+/**
+ * Collect the cells that must be removed together with a cell
+ * 
+ * Parameters:
+ *   cell     - cell index (row * 9 + col)
+ *   symmetry - clue symmetry to preserve
+ *   orbit    - receives the distinct cells of the group (including cell)
+ * 
+ * Returns: number of cells in the group
+ */
+static int symmetry_orbit(int cell, symmetry_t symmetry, int orbit[8])
+{
+    // Transforms forming each symmetry group (identity always first)
+    static const int groups[][8] = {
+        {0},                            // SYMMETRY_NONE
+        {0, 2},                         // SYMMETRY_ROTATIONAL
+        {0, 6},                         // SYMMETRY_DIAGONAL
+        {0, 4},                         // SYMMETRY_MIRROR
+        {0, 1, 2, 3, 4, 5, 6, 7}        // SYMMETRY_DIHEDRAL
+    };
+    static const int group_sizes[] = {1, 2, 2, 2, 8};
+    int size = 0;
+
+    for (int t = 0; t < group_sizes[symmetry]; t++)
+    {
+        int image = transform_cell(groups[symmetry][t], cell);
+        int seen = 0;
+
+        // Cells on an axis map onto themselves; keep each cell once
+        for (int k = 0; k < size; k++)
         {
-            solution[row][col] = grid[row][col];
+            seen |= (orbit[k] == image);
         }
+
+        if (!seen)
+            orbit[size++] = image;
+    }
+
+    return size;
+}
+
+/**
+ * Run one removal pass over a shuffled permutation of the cells
+ * 
+ * Parameters:
+ *   grid            - unique puzzle (often the complete grid) on entry,
+ *                     puzzle with fewer clues on return
+ *   solution        - 9x9 complete solution
+ *   options         - symmetry and random source
+ *   sets            - unavoidable sets of the solution
+ *   cells_to_remove - stop after this many removals
+ *   give_up_below   - abandon the pass once fewer removals remain possible
+ *   tests           - incremented per uniqueness check
+ * 
+ * Returns: number of cells removed
+ */
+static int remove_clues(int grid[9][9], int solution[9][9], const generator_options_t *options,
+                        const unavoidable_sets_t *sets, int cells_to_remove, int give_up_below,
+                        int *tests)
+{
+    cellmask_t clues = cellmask_from_grid(grid);
+    int order[81];
+    int removed_count = 0;
+    int untested = cellmask_count(&clues); // Filled cells not yet visited
+
+    for (int i = 0; i < 81; i++)
+    {
+        order[i] = i;
+    }
+
+    for (int i = 80; i > 0; i--)
+    {
+        swap(&order[i], &order[random_below(options->rng, i + 1)]);
     }
 
-    // Step 4: Intelligently remove cells while maintaining puzzle uniqueness
-    while (removed_count < cells_to_remove && attempts < max_attempts)
+    for (int i = 0; i < 81 && removed_count < cells_to_remove; i++)
     {
-        // Pick a random cell to potentially remove
-        int row = rand() % 9;
-        int col = rand() % 9;
+        int orbit[8];
+        int size = symmetry_orbit(order[i], options->symmetry, orbit);
+
+        if (options->cancel != NULL && *options->cancel)
+            break; // Every removal so far was checked, so the puzzle is still unique
+
+        // Already removed as the partner of an earlier cell
+        if (grid[order[i] / 9][order[i] % 9] == 0)
+            continue;
+
+        untested -= size;
 
-        // Skip cells that have already been removed (are zero)
-        if (grid[row][col] == 0)
+        // Removing the whole group would overshoot the target
+        if (removed_count + size > cells_to_remove)
+            continue;
+
+        cellmask_t remaining = clues;
+
+        for (int k = 0; k < size; k++)
         {
-            attempts++;
-            continue; // Try a different cell
+            grid[orbit[k] / 9][orbit[k] % 9] = 0;
+            remaining.bits[orbit[k] >> 6] &= ~(1ULL << (orbit[k] & 63));
         }
 
-        // Store the original value before removal attempt
-        int original_value = grid[row][col];
+        // Emptying an unavoidable set can never stay unique: skip the search
+        int unique = unavoidable_missed(sets, &remaining) < 0;
 
-        // Temporarily remove the cell (set to zero)
-        grid[row][col] = 0;
+        if (unique)
+        {
+            (*tests)++;
+            unique = is_unique_without_cells(grid, solution, orbit, size);
+        }
 
-        // Test if puzzle still has a unique solution after removal
-        if (has_unique_solution(grid))
+        if (unique)
         {
-            // Removal successful - puzzle still has unique solution
-            removed_count++; // Keep it removed
+            removed_count += size; // Keep the group removed
+            clues = remaining;
         }
         else
         {
-            // Removal failed - would create multiple solutions
-            grid[row][col] = original_value; // Put the number back
+            for (int k = 0; k < size; k++)
+            {
+                grid[orbit[k] / 9][orbit[k] % 9] = solution[orbit[k] / 9][orbit[k] % 9];
+            }
         }
 
-        // Increment attempt counter regardless of success/failure
-        attempts++;
+        // Even removing every untested cell would fall short: stop early
+        if (removed_count + untested < give_up_below)
+            break;
     }
 
-    // Step 5: Create the given array to track which cells are clues
-    // This helps distinguish between original clues and player-filled cells
-    for (int row = 0; row < GRID_SIZE; row++)
+    return removed_count;
+}
+
+/**
+ * Choose a unique clue pattern as a hitting set of the unavoidable sets
+ * Adds the cell hitting the most still-empty sets until every set holds a
+ * clue; only then is uniqueness searched, and a second solution found by
+ * the search becomes a new set for the next round
+ * 
+ * Parameters:
+ *   grid     - receives the unique puzzle
+ *   solution - 9x9 complete solution
+ *   options  - random source and cancel flag
+ *   sets     - unavoidable sets of the solution (grows with learned sets)
+ *   tests    - incremented per uniqueness check
+ * 
+ * Returns: number of clues chosen
+ */
+static int select_clues(int grid[9][9], int solution[9][9], const generator_options_t *options,
+                        unavoidable_sets_t *sets, int *tests)
+{
+    cellmask_t clues = {{0, 0}};
+    int other[9][9];
+    int clue_count = 0;
+
+    memset(grid, 0, sizeof(int[9][9]));
+
+    for (;;)
     {
-        for (int col = 0; col < GRID_SIZE; col++)
+        int counts[81] = {0};
+        int missed = 0;
+        int chosen = -1;
+
+        if (options->cancel != NULL && *options->cancel)
         {
-            if (grid[row][col] != 0)
+            memcpy(grid, solution, sizeof(int[9][9])); // Trivially unique
+            return 81;
+        }
+
+        for (int i = 0; i < sets->count; i++)
+        {
+            if (cellmask_intersects(&sets->sets[i], &clues))
+                continue;
+
+            missed++;
+
+            for (int word = 0; word < 2; word++)
             {
-                given[row][col] = 1; // This cell is a given clue (unchangeable)
+                for (uint64_t bits = sets->sets[i].bits[word]; bits; bits &= bits - 1)
+                {
+                    counts[word * 64 + __builtin_ctzll(bits)]++;
+                }
             }
+        }
+
+        if (missed == 0)
+        {
+            (*tests)++;
+
+            int found = find_other_solution_limited(grid, solution, other, HITTING_SET_NODES);
+
+            if (found == 0)
+                return clue_count; // Unique
+
+            if (found < 0)
+            {
+                // Too sparse to decide cheaply: one more random clue narrows it
+                do
+                {
+                    chosen = random_below(options->rng, 81);
+                } while (cellmask_test(&clues, chosen));
+
+                cellmask_set(&clues, chosen);
+                grid[chosen / 9][chosen % 9] = solution[chosen / 9][chosen % 9];
+                clue_count++;
+                continue;
+            }
+
+            // The clues agree with both grids, so the difference is a set
+            // that no clue hits yet
+            cellmask_t diff = {{0, 0}};
+            int diff_cells[81];
+            int diff_count = 0;
+
+            for (int cell = 0; cell < 81; cell++)
+            {
+                if (other[cell / 9][cell % 9] != solution[cell / 9][cell % 9])
+                {
+                    cellmask_set(&diff, cell);
+                    diff_cells[diff_count++] = cell;
+                }
+            }
+
+            int before = sets->count;
+
+            unavoidable_add(sets, &diff);
+
+            // Collection full (or diff not minimal): hit the difference directly
+            if (sets->count <= before && unavoidable_missed(sets, &clues) < 0)
+                chosen = diff_cells[random_below(options->rng, diff_count)];
             else
+                continue;
+        }
+        else
+        {
+            // Greedy choice: the cell in the most missed sets, ties broken at random
+            int best = 0, ties = 0;
+
+            for (int cell = 0; cell < 81; cell++)
             {
-                given[row][col] = 0; // This cell is empty for player to fill
+                if (counts[cell] > best)
+                {
+                    best = counts[cell];
+                    chosen = cell;
+                    ties = 1;
+                }
+                else if (counts[cell] == best && best > 0 && random_below(options->rng, ++ties) == 0)
+                {
+                    chosen = cell;
+                }
             }
         }
+
+        cellmask_set(&clues, chosen);
+        grid[chosen / 9][chosen % 9] = solution[chosen / 9][chosen % 9];
+        clue_count++;
     }
+}
 
-    return 1; // Success - puzzle generation complete
-}
\ No newline at end of file
+/**
+ * Add random clues from the solution until a clue count is reached
+ * Adding clues never breaks uniqueness
+ * 
+ * Parameters:
+ *   grid     - unique puzzle
+ *   solution - 9x9 complete solution
+ *   options  - random source
+ *   clues    - current clue count
+ *   target   - desired clue count
+ */
+static void pad_clues(int grid[9][9], int solution[9][9], const generator_options_t *options,
+                      int clues, int target)
+{
+    while (clues < target)
+    {
+        int cell = random_below(options->rng, 81);
+
+        if (grid[cell / 9][cell % 9] == 0)
+        {
+            grid[cell / 9][cell % 9] = solution[cell / 9][cell % 9];
+            clues++;
+        }
+    }
+}
+
+/**
+ * Generate a complete Sudoku puzzle with specified difficulty
+ * Creates puzzle grid, solution grid, and given array
+ * Ensures puzzle has exactly one unique solution
+ * 
+ * Parameters:
+ *   grid       - 9x9 array for the puzzle (with cells removed)
+ *   solution   - 9x9 array storing the complete solution
+ *   given      - 9x9 array marking which cells are original clues
+ *   difficulty - desired puzzle difficulty level
+ * 
+ * Returns: 1 if successful generation, 0 if failed
+ */
+int generate_puzzle(int grid[9][9], int solution[9][9], int given[9][9], difficulty_t difficulty)
+{
+    static int seeded = 0;
+    generator_options_t options = {difficulty, 0, SYMMETRY_NONE, NULL, 0, 0, NULL,
+                                   GENERATOR_REMOVAL};
+
+    // Seed once: reseeding every call repeats puzzles generated within one second
+    if (!seeded)
+    {
+        srand(time(NULL));
+        seeded = 1;
+    }
+
+    generate_puzzle_ex(grid, solution, given, &options, NULL);
+
+    return 1; // A unique puzzle is always produced, even if short of the target
+}
+
+/**
+ * Generate a puzzle with explicit options and report what was achieved
+ * Removes cells in the order of a shuffled permutation, so every cell (or
+ * symmetric group) is tested at most once per pass; passes that miss the
+ * target are retried and the puzzle with the fewest clues is kept
+ * 
+ * Parameters:
+ *   grid     - 9x9 array for the puzzle
+ *   solution - 9x9 array storing the complete solution
+ *   given    - 9x9 array marking original clues
+ *   options  - difficulty, clue target, symmetry, attempts, random source
+ *              and cancel flag
+ *   report   - receives achieved clue count and test count (may be NULL)
+ * 
+ * Returns: 1 if the clue target was reached (or beaten in minimal mode),
+ *          0 if the puzzle has more clues
+ */
+int generate_puzzle_ex(int grid[9][9], int solution[9][9], int given[9][9],
+                       const generator_options_t *options, generator_report_t *report)
+{
+    int cells_to_remove = options->target_clues > 0 ? 81 - options->target_clues
+                                                    : get_cells_to_remove(options->difficulty);
+    int target = cells_to_remove;
+    int attempts = options->attempts > 0 ? options->attempts : GENERATOR_ATTEMPTS;
+    int best_removed = -1;
+    int tests = 0;
+    int attempt = 0;
+    int work[9][9], work_solution[9][9];
+    unavoidable_sets_t sets;
+    int hitting = options->method == GENERATOR_HITTING_SET && options->symmetry == SYMMETRY_NONE;
+
+    // Minimal mode ignores the target and tries every cell: a clue kept once
+    // stays necessary as more clues go, so the pass ends on a minimal puzzle
+    if (options->minimal)
+        cells_to_remove = 81;
+
+    while (attempt < attempts && best_removed < target)
+    {
+        // Cancellation still lets the first pass produce a puzzle
+        if (attempt > 0 && options->cancel != NULL && *options->cancel)
+            break;
+
+        // Odd attempts reshuffle the removal order on the same grid, which
+        // costs nothing; even attempts start over with a new complete grid
+        if (attempt % 2 == 0)
+        {
+            memset(work_solution, 0, sizeof(work_solution));
+
+            if (options->rng)
+                generate_complete_grid_seeded(work_solution, options->rng);
+            else
+                generate_complete_grid(work_solution);
+
+            // Digit-pair sets are cheap and catch most doomed removals
+            find_unavoidable_sets(work_solution, 2, UNAVOIDABLE_MAX_SIZE, &sets);
+        }
+
+        memcpy(work, work_solution, sizeof(work));
+        attempt++;
+
+        // Only the final pass must finish; earlier ones stop once hopeless.
+        // Minimal passes always finish, or the kept puzzle might not be minimal
+        int give_up_below = (attempt < attempts && !options->minimal) ? target : 0;
+        int removed = 0;
+
+        // Hitting sets start from a sparse unique pattern instead of the full grid
+        if (hitting)
+        {
+            removed = 81 - select_clues(work, work_solution, options, &sets, &tests);
+
+            if (removed > target && !options->minimal)
+            {
+                pad_clues(work, work_solution, options, 81 - removed, 81 - target);
+                removed = target;
+            }
+        }
+
+        removed += remove_clues(work, work_solution, options, &sets, cells_to_remove - removed,
+                                give_up_below - removed, &tests);
+
+        if (removed > best_removed)
+        {
+            best_removed = removed;
+            memcpy(grid, work, sizeof(work));
+            memcpy(solution, work_solution, sizeof(work_solution));
+        }
+    }
+
+    // Create the given array to track which cells are clues
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int col = 0; col < GRID_SIZE; col++)
+        {
+            given[row][col] = (grid[row][col] != 0);
+        }
+    }
+
+    if (report != NULL)
+    {
+        report->clues = 81 - best_removed;
+        report->target_clues = 81 - target;
+        report->tests = tests;
+        report->attempts = attempt;
+    }
+
+    return best_removed >= target;
+}
@@ -3,6 +3,7 @@
 #include "../include/input.h"
 #include "../include/game.h"
 #include "../include/solver.h"
+#include "../include/branch.h"
 #include <ncurses.h>  // Use the curses.h from ncurses directory  // Use the curses.h from ncursesw directory  // Not ncurses.h
 
 /**
@@ -151,6 +152,7 @@ int process_number_input(game_state_t *game, int num)
     if (can_enter_number(game, game->cursor_row, game->cursor_col))
     {
         // Always place the number (even if invalid)
+        record_cell(game, game->cursor_row, game->cursor_col);
         game->grid[game->cursor_row][game->cursor_col] = num;
         
         // Optionally show a status message for invalid moves
@@ -182,6 +184,7 @@ void handle_mark_input(game_state_t *game, int num)
     {
         // Toggle mark: if 0 becomes 1, if 1 becomes 0
         // num-1 converts 1-9 to 0-8 array index
+        record_cell(game, game->cursor_row, game->cursor_col);
         game->marks[game->cursor_row][game->cursor_col][num - 1] = 
             !game->marks[game->cursor_row][game->cursor_col][num - 1];
     }
@@ -0,0 +1,373 @@
+#include "../include/sudoku.h"
+#include "../include/killer.h"
+#include <pthread.h>
+
+static combination_table_t table;
+static pthread_once_t table_built = PTHREAD_ONCE_INIT;
+
+/**
+ * Sum of the digits in a 9-bit mask
+ *
+ * Parameters:
+ *   mask - digit set (bit n-1 = digit n)
+ *
+ * Returns: digit total (0-45)
+ */
+static int mask_sum(unsigned mask)
+{
+    int sum = 0;
+
+    for (int digit = 1; digit <= 9; digit++)
+    {
+        if (mask & (1u << (digit - 1)))
+            sum += digit;
+    }
+
+    return sum;
+}
+
+/**
+ * Bucket all 512 digit sets by size and sum (counting sort)
+ */
+static void build_combination_table(void)
+{
+    uint16_t count[GRID_SIZE + 1][KILLER_MAX_SUM + 1] = {{0}};
+    int next = 0;
+
+    for (unsigned mask = 0; mask < KILLER_DIGIT_SETS; mask++)
+        count[__builtin_popcount(mask)][mask_sum(mask)]++;
+
+    // start[size][sum + 1] of one bucket is the start of the next bucket
+    for (int size = 0; size <= GRID_SIZE; size++)
+    {
+        for (int sum = 0; sum <= KILLER_MAX_SUM; sum++)
+        {
+            table.start[size][sum] = (uint16_t)next;
+            next += count[size][sum];
+        }
+
+        table.start[size][KILLER_MAX_SUM + 1] = (uint16_t)next;
+    }
+
+    for (int size = 0; size <= GRID_SIZE; size++)
+    {
+        for (int sum = 0; sum <= KILLER_MAX_SUM; sum++)
+            count[size][sum] = table.start[size][sum];
+    }
+
+    for (unsigned mask = 0; mask < KILLER_DIGIT_SETS; mask++)
+        table.masks[count[__builtin_popcount(mask)][mask_sum(mask)]++] = (uint16_t)mask;
+}
+
+/**
+ * Get the digit-set tables
+ *
+ * Returns: read-only tables
+ */
+const combination_table_t *combination_table(void)
+{
+    pthread_once(&table_built, build_combination_table);
+
+    return &table;
+}
+
+/**
+ * Pick a random index in [0, bound) from the seeded generator or rand()
+ *
+ * Parameters:
+ *   rng   - seeded generator, or NULL to use rand()
+ *   bound - exclusive upper bound
+ *
+ * Returns: random integer from 0 to bound - 1
+ */
+static int random_below(rng_t *rng, int bound)
+{
+    return rng ? rng_below(rng, bound) : rand() % bound;
+}
+
+/**
+ * Largest cage grown for a difficulty level
+ *
+ * Parameters:
+ *   difficulty - puzzle level
+ *
+ * Returns: cage size limit (2-6)
+ */
+static int max_cage_size(difficulty_t difficulty)
+{
+    switch (difficulty)
+    {
+        case EASY:
+            return 3;
+        case MEDIUM:
+            return 4;
+        case HARD:
+            return 5;
+        case EXPERT:
+            return 6;
+        default:
+            return 3;
+    }
+}
+
+/**
+ * Collect the orthogonal neighbours of a cell
+ *
+ * Parameters:
+ *   cell       - cell index
+ *   neighbours - receives up to 4 cell indices
+ *
+ * Returns: number of neighbours
+ */
+static int cell_neighbours(int cell, int neighbours[4])
+{
+    int row = cell / 9, col = cell % 9;
+    int count = 0;
+
+    if (row > 0)
+        neighbours[count++] = cell - 9;
+    if (row < 8)
+        neighbours[count++] = cell + 9;
+    if (col > 0)
+        neighbours[count++] = cell - 1;
+    if (col < 8)
+        neighbours[count++] = cell + 1;
+
+    return count;
+}
+
+/**
+ * Turn a cage number per cell into a layout with sums from the solution
+ * Cage numbers may have gaps; cages are renumbered in order of first cell
+ *
+ * Parameters:
+ *   cage_of  - cage number (below 2 * 81) of each cell
+ *   solution - complete 9x9 grid
+ *   layout   - receives the cages
+ */
+static void build_layout(const int cage_of[81], int solution[9][9], cage_layout_t *layout)
+{
+    int number[2 * 81];
+
+    memset(layout, 0, sizeof(*layout));
+
+    for (int i = 0; i < 2 * 81; i++)
+        number[i] = -1;
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int id = cage_of[cell];
+
+        if (number[id] < 0)
+            number[id] = layout->count++;
+
+        cage_t *cage = &layout->cages[number[id]];
+
+        cage->cells[cage->size++] = (uint8_t)cell;
+        cage->sum = (uint8_t)(cage->sum + solution[cell / 9][cell % 9]);
+    }
+}
+
+/**
+ * Cut a solution grid into random cages
+ *
+ * Parameters:
+ *   solution   - complete 9x9 grid
+ *   difficulty - level selecting the cage sizes
+ *   rng        - seeded generator, or NULL to use rand()
+ *   layout     - receives the cages
+ *
+ * Returns: number of cages
+ */
+int generate_cages(int solution[9][9], difficulty_t difficulty, rng_t *rng, cage_layout_t *layout)
+{
+    const int *digits = &solution[0][0];
+    int cage_of[81], order[81], size[81];
+    uint16_t used[81];
+    int limit = max_cage_size(difficulty);
+    int cages = 0;
+
+    for (int i = 0; i < 81; i++)
+    {
+        cage_of[i] = -1;
+        order[i] = i;
+    }
+
+    for (int i = 80; i > 0; i--)
+    {
+        int j = random_below(rng, i + 1);
+        int temp = order[i];
+
+        order[i] = order[j];
+        order[j] = temp;
+    }
+
+    // Grow each cage from a random free cell towards a random target size
+    for (int i = 0; i < 81; i++)
+    {
+        int seed = order[i];
+
+        if (cage_of[seed] >= 0)
+            continue;
+
+        int id = cages++;
+        int target = 2 + random_below(rng, limit - 1);
+        int members[GRID_SIZE];
+
+        cage_of[seed] = id;
+        members[0] = seed;
+        size[id] = 1;
+        used[id] = (uint16_t)(1u << (digits[seed] - 1));
+
+        while (size[id] < target)
+        {
+            int frontier[4 * GRID_SIZE];
+            int count = 0;
+
+            for (int m = 0; m < size[id]; m++)
+            {
+                int neighbours[4];
+                int n = cell_neighbours(members[m], neighbours);
+
+                for (int k = 0; k < n; k++)
+                {
+                    int next = neighbours[k];
+
+                    if (cage_of[next] < 0 && !(used[id] & (1u << (digits[next] - 1))))
+                        frontier[count++] = next;
+                }
+            }
+
+            if (count == 0)
+                break; // Boxed in by other cages or repeated digits
+
+            int next = frontier[random_below(rng, count)];
+
+            cage_of[next] = id;
+            members[size[id]++] = next;
+            used[id] |= (uint16_t)(1u << (digits[next] - 1));
+        }
+    }
+
+    // A one-cell cage gives its digit away, so fold it into a neighbour
+    for (int cell = 0; cell < 81; cell++)
+    {
+        int id = cage_of[cell];
+        int neighbours[4];
+        int n = cell_neighbours(cell, neighbours);
+        int best = -1;
+
+        if (size[id] != 1)
+            continue;
+
+        for (int k = 0; k < n; k++)
+        {
+            int other = cage_of[neighbours[k]];
+
+            if (size[other] < GRID_SIZE && !(used[other] & (1u << (digits[cell] - 1))) &&
+                (best < 0 || size[other] < size[best]))
+                best = other;
+        }
+
+        if (best >= 0)
+        {
+            cage_of[cell] = best;
+            size[best]++;
+            used[best] |= (uint16_t)(1u << (digits[cell] - 1));
+            size[id] = 0;
+        }
+    }
+
+    build_layout(cage_of, solution, layout);
+
+    return layout->count;
+}
+
+/**
+ * Split the cage holding a cell into smaller connected cages
+ *
+ * Parameters:
+ *   layout   - cage layout to modify
+ *   cell     - cell whose cage is split
+ *   solution - complete 9x9 grid the layout was built from
+ *
+ * Returns: 1 if the cage was split, 0 if it had a single cell
+ */
+int split_cage(cage_layout_t *layout, int cell, int solution[9][9])
+{
+    int cage_of[81];
+    int next_id = layout->count;
+    int target = -1;
+
+    for (int c = 0; c < layout->count; c++)
+    {
+        for (int i = 0; i < layout->cages[c].size; i++)
+        {
+            cage_of[layout->cages[c].cells[i]] = c;
+
+            if (layout->cages[c].cells[i] == cell)
+                target = c;
+        }
+    }
+
+    if (target < 0 || layout->cages[target].size < 2)
+        return 0;
+
+    const cage_t *cage = &layout->cages[target];
+    int half = cage->size / 2;
+    int queue[GRID_SIZE];
+    int head = 0, tail = 0;
+
+    // Breadth-first from the cell: the first half of the cage becomes one part
+    queue[tail++] = cell;
+    cage_of[cell] = next_id;
+
+    while (head < tail && tail < half)
+    {
+        int neighbours[4];
+        int n = cell_neighbours(queue[head++], neighbours);
+
+        for (int k = 0; k < n && tail < half; k++)
+        {
+            if (cage_of[neighbours[k]] == target)
+            {
+                cage_of[neighbours[k]] = next_id;
+                queue[tail++] = neighbours[k];
+            }
+        }
+    }
+
+    next_id++;
+
+    // Every connected piece of the rest becomes a cage of its own
+    for (int i = 0; i < cage->size; i++)
+    {
+        if (cage_of[cage->cells[i]] != target)
+            continue;
+
+        head = tail = 0;
+        queue[tail++] = cage->cells[i];
+        cage_of[cage->cells[i]] = next_id;
+
+        while (head < tail)
+        {
+            int neighbours[4];
+            int n = cell_neighbours(queue[head++], neighbours);
+
+            for (int k = 0; k < n; k++)
+            {
+                if (cage_of[neighbours[k]] == target)
+                {
+                    cage_of[neighbours[k]] = next_id;
+                    queue[tail++] = neighbours[k];
+                }
+            }
+        }
+
+        next_id++;
+    }
+
+    build_layout(cage_of, solution, layout);
+
+    return 1;
+}
@@ -17,17 +17,260 @@
 #include "../include/input.h"
 #include "../include/game.h"
 #include "../include/generator.h"
+#include "../include/batch.h"
+#include "../include/animate.h"
+#include "../include/topology.h"
+#include "../include/branch.h"
+#include "../include/feedback.h"
+#include "../include/editor.h"
+#include "../include/daily.h"
 #include <ncurses.h>
 
+/**
+ * Play Samurai puzzles until the player changes variant or quits
+ * The five-grid layout has its own state and screen, so it runs its own
+ * input loop on top of the main one
+ *
+ * @param difficulty Level of the generated puzzles
+ * @return 1 to continue with the next variant, 0 to quit the program
+ */
+static int play_samurai(difficulty_t difficulty)
+{
+    samurai_game_t *game = malloc(sizeof(*game));
+    int last_time = -1;
+    int result = -1;
+
+    if (game == NULL)
+        return 1;
+
+    new_samurai_puzzle(game, difficulty);
+    draw_samurai(game);
+
+    while (result < 0)
+    {
+        int ch = getch();
+
+        switch (ch)
+        {
+        case ERR:
+            // Timeout - redraw only when the displayed time changes
+            if (get_samurai_elapsed_time(game) == last_time)
+                continue;
+            break;
+        case KEY_UP:
+            move_samurai_cursor(game, -1, 0);
+            break;
+        case KEY_DOWN:
+            move_samurai_cursor(game, 1, 0);
+            break;
+        case KEY_LEFT:
+            move_samurai_cursor(game, 0, -1);
+            break;
+        case KEY_RIGHT:
+            move_samurai_cursor(game, 0, 1);
+            break;
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            enter_samurai_number(game, ch - '0');
+            break;
+        case 'x':
+            delete_samurai_number(game);
+            break;
+        case 'n':
+            new_samurai_puzzle(game, difficulty);
+            break;
+        case 's':
+            solve_samurai_puzzle(game);
+            break;
+        case 'v':
+            result = 1;
+            continue;
+        case 'q':
+        case 27: // ESC key
+            result = 0;
+            continue;
+        default:
+            break; // 'r' and unknown keys just redraw
+        }
+
+        last_time = get_samurai_elapsed_time(game);
+        draw_samurai(game);
+
+        if (game->completion_time == 0 && is_samurai_complete(game))
+            game->completion_time = time(NULL);
+
+        if (game->completion_time != 0)
+        {
+            char message[80];
+            char time_str[32];
+
+            format_time(get_samurai_elapsed_time(game), time_str, sizeof(time_str));
+            snprintf(message, sizeof(message), "Samurai completed in %s with %d moves!", time_str,
+                     game->moves);
+            draw_samurai_message(message);
+        }
+    }
+
+    free(game);
+    return result;
+}
+
+/**
+ * Edit the clues of the current puzzle with a live solution count
+ * Every edit posts the clues to a background counter, so typing never
+ * waits; the count and rating appear on the next timer tick
+ *
+ * @param game Game whose puzzle is edited
+ * @return 1 to continue playing, 0 to quit the program
+ */
+static int edit_puzzle(game_state_t *game)
+{
+    game_state_t *saved = malloc(sizeof(*saved));
+    editor_t editor;
+    editor_result_t result;
+    int status = -1;
+
+    if (saved == NULL || !editor_start(&editor))
+    {
+        free(saved);
+        draw_status_message("Editor unavailable");
+        return 1;
+    }
+
+    *saved = *game; // ESC puts the puzzle back as it was
+    start_editing(game);
+    editor_post(&editor, game->grid);
+
+    draw_game(game);
+    draw_status_message("Editor: 1-9 clue, x clear, w wipe, e play, ESC cancel");
+
+    while (status < 0)
+    {
+        int ch = getch();
+        int edited = 0;
+
+        switch (ch)
+        {
+        case ERR:
+            break;
+        case KEY_UP:
+            move_cursor_up(game);
+            break;
+        case KEY_DOWN:
+            move_cursor_down(game);
+            break;
+        case KEY_LEFT:
+            move_cursor_left(game);
+            break;
+        case KEY_RIGHT:
+            move_cursor_right(game);
+            break;
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            game->grid[game->cursor_row][game->cursor_col] = ch - '0';
+            edited = 1;
+            break;
+        case 'x':
+        case '0':
+        case ' ':
+            game->grid[game->cursor_row][game->cursor_col] = 0;
+            edited = 1;
+            break;
+        case 'w':
+            memset(game->grid, 0, sizeof(game->grid));
+            edited = 1;
+            break;
+        case 'e':
+            editor_result(&editor, &result);
+
+            if (result.status == EDITOR_UNIQUE)
+            {
+                play_edited_puzzle(game, result.solution);
+                status = 1;
+                continue;
+            }
+
+            draw_status_message("The puzzle needs exactly one solution to play");
+            break;
+        case 27: // ESC key
+            *game = *saved;
+            status = 1;
+            continue;
+        case 'q':
+            status = 0;
+            continue;
+        default:
+            break;
+        }
+
+        if (edited)
+            editor_post(&editor, game->grid); // Cancels the count of the old clues
+
+        if (ch != ERR)
+            draw_grid(game);
+
+        editor_result(&editor, &result);
+        draw_editor_status(&result);
+    }
+
+    editor_stop(&editor);
+    free(saved);
+    return status;
+}
+
 /**
  * Main program entry point
  * Initializes the game environment, runs the main game loop, and handles cleanup
+ * Any command-line arguments select a batch tool instead of the game
  *
+ * @param argc Argument count
+ * @param argv Argument vector
  * @return 0 on successful program completion
  */
-int main(void)
+int main(int argc, char *argv[])
 {
     game_state_t game;
+    animation_t anim;
+    feedback_t feedback;        // Background "still solvable" check
+    daily_cache_t daily;        // Background fill of the daily puzzle cache
+    int checking = 0;           // Flag: 1 = check the board after each move
+
+    // Build the rule tables before any worker thread can ask for them
+    set_current_variant(VARIANT_CLASSIC);
+
+    // Batch tools run without the terminal UI
+    if (argc > 1 && !(argc == 3 && strcmp(argv[1], "--play") == 0))
+        return batch_main(argc, argv);
+
+    init_game(&game, MEDIUM);
+
+    // Load before the screen takes over, so errors can go to stderr
+    if (argc == 3)
+    {
+        int found = load_puzzle(&game, argv[2]);
+
+        if (found <= 0)
+        {
+            fprintf(stderr, found < 0 ? "No puzzle found in %s\n" : "The puzzle in %s has no solution\n",
+                    argv[2]);
+            free_branches(&game);
+            return 1;
+        }
+    }
 
     initscr();
     raw();
@@ -36,8 +279,12 @@ int main(void)
     curs_set(0);
     timeout(250); // 250ms timeout for smooth timer updates
 
+    memset(&anim, 0, sizeof(anim));
+    memset(&feedback, 0, sizeof(feedback));
+    memset(&daily, 0, sizeof(daily));
+    anim.nodes_per_frame = 1; // Slowest speed: every placement is visible
+
     init_colors();
-    init_game(&game, MEDIUM);
     start_timer(&game);
 
     draw_game(&game); // Initial draw
@@ -49,6 +296,29 @@ int main(void)
     {
         int ch = getch();
 
+        if (ch == ERR && anim.active)
+        {
+            // Animation frame: advance the search by one bounded slice
+            if (step_animation(&anim, &game))
+            {
+                draw_grid(&game);
+                draw_animation_status(&anim);
+            }
+            else
+            {
+                timeout(250);
+                draw_game(&game);
+                draw_animation_status(&anim);
+
+                if (checking)
+                    feedback_post(&feedback, &game);
+
+                // A solved grid is announced by the completion check below
+                if (!game.is_completed)
+                    draw_status_message("Search found no solution");
+            }
+        }
+
         if (ch == ERR)
         {
             // Timeout - update timer if it changed
@@ -61,6 +331,42 @@ int main(void)
                 refresh();
                 last_time = current_time;
             }
+
+            // The answer arrives from the checker thread; never wait for it
+            if (checking && !anim.active)
+                draw_feedback_indicator(feedback_status(&feedback));
+
+            // First idle moment: prepare the coming daily puzzles
+            if (!daily.started && !daily.stop && !anim.active && !daily_cache_start(&daily))
+                daily.stop = 1; // No thread: the daily puzzle is generated on demand
+        }
+        else if (anim.active)
+        {
+            // Only animation controls are live while the search is running
+            switch (ch)
+            {
+            case '+':
+            case '=':
+                change_animation_speed(&anim, 1);
+                draw_animation_status(&anim);
+                break;
+            case '-':
+                change_animation_speed(&anim, 0);
+                draw_animation_status(&anim);
+                break;
+            case 'q':
+                continue_game = 0;
+                // fall through
+            case 'a':
+            case 27: // ESC key
+                cancel_animation(&anim, &game);
+                timeout(250);
+                draw_game(&game);
+                draw_status_message("Animation cancelled");
+                break;
+            default:
+                break;
+            }
         }
         else
         {
@@ -106,6 +412,19 @@ int main(void)
                 break;
             case 'n':
                 new_puzzle(&game);
+                start_timer(&game);
+                draw_game(&game);
+                break;
+            case 'v':
+                change_variant(&game);
+
+                // Samurai runs on its own screen until the next 'v' moves on
+                if (game.variant == VARIANT_SAMURAI)
+                {
+                    continue_game = play_samurai(game.difficulty);
+                    change_variant(&game);
+                }
+
                 start_timer(&game);
                 draw_game(&game);
                 break;
@@ -125,6 +444,79 @@ int main(void)
                 draw_game(&game);
                 break;
 
+            // What-if branches: try a guess, then roll it back or keep it
+            case 'b':
+            {
+                int depth = open_branch(&game);
+                char message[64];
+
+                if (depth > 0)
+                    snprintf(message, sizeof(message), "Branch %d opened (u = undo, k = keep)", depth);
+                else
+                    snprintf(message, sizeof(message), "Out of memory - branch not opened");
+
+                draw_game(&game);
+                draw_status_message(message);
+            }
+            break;
+            case 'u':
+            {
+                int discarded = discard_branch(&game);
+
+                draw_game(&game);
+                draw_status_message(discarded ? "Branch discarded" : "No branch open");
+            }
+            break;
+            case 'k':
+            {
+                int kept = merge_branch(&game);
+
+                draw_game(&game);
+                draw_status_message(kept ? "Branch kept" : "No branch open");
+            }
+            break;
+            case 'e':
+                continue_game = edit_puzzle(&game);
+                draw_game(&game);
+                break;
+            case 'd':
+            {
+                long today = daily_today();
+                char message[64];
+
+                new_daily_puzzle(&game, today);
+                draw_game(&game);
+                snprintf(message, sizeof(message), "Daily puzzle for %04ld-%02ld-%02ld",
+                         today / 10000, today / 100 % 100, today % 100);
+                draw_status_message(message);
+            }
+            break;
+            case 'p':
+                draw_status_message(save_puzzle(&game, SAVE_FILE_NAME, FORMAT_JSON)
+                                        ? "Saved to " SAVE_FILE_NAME
+                                        : "Only classic puzzles can be saved");
+                break;
+            case 'f':
+                if (!checking && !feedback.worker.started && !feedback_start(&feedback))
+                {
+                    draw_status_message("Move checking unavailable");
+                    break;
+                }
+
+                checking = !checking;
+                draw_game(&game);
+                draw_status_message(checking ? "Checking after each move" : "Move checking off");
+
+                if (!checking)
+                    draw_feedback_indicator(FEEDBACK_OFF);
+                break;
+            case 'a':
+                start_animation(&anim, &game);
+                timeout(ANIMATION_FRAME_MS);
+                draw_game(&game);
+                draw_animation_status(&anim);
+                break;
+
             // Hint system
             case 'h':
             {
@@ -157,6 +549,13 @@ int main(void)
             default:
                 break;
             }
+
+            // Post the board after every command; the check runs off the input path
+            if (checking)
+            {
+                feedback_post(&feedback, &game);
+                draw_feedback_indicator(feedback_status(&feedback));
+            }
         }
 
         if (is_game_complete(&game) && game.completion_time == 0)
@@ -167,5 +566,8 @@ int main(void)
     }
 
     endwin();
+    feedback_stop(&feedback);
+    daily_cache_stop(&daily);
+    free_branches(&game);
     return 0;
 }
\ No newline at end of file
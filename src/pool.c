@@ -0,0 +1,523 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/pool.h"
+#include "../include/batch.h"
+#include "../include/generator.h"
+#include "../include/search.h"
+#include "../include/topology.h"
+#include "../include/rng.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define POOL_MASK (POOL_CAPACITY - 1)   // Ring position to slot index
+
+typedef struct
+{
+    pool_t *pool;               // Shared pool being filled
+    uint64_t seed;              // Seed of this thread's random stream
+} pool_worker_t;
+
+static volatile int stop_requested = 0; // Set by SIGINT/SIGTERM to stop the daemon
+
+/**
+ * SIGINT/SIGTERM handler: ask the daemon threads to finish
+ *
+ * Parameters:
+ *   signum - signal number (unused)
+ */
+static void handle_stop(int signum)
+{
+    (void)signum;
+    stop_requested = 1;
+}
+
+/**
+ * Map the pool built by a daemon
+ *
+ * Parameters:
+ *   pool - handle to fill
+ *
+ * Returns: 1 if an initialized pool of this version was mapped, 0 otherwise
+ */
+int pool_open(pool_t *pool)
+{
+    struct stat info;
+    int fd = shm_open(POOL_SHM_NAME, O_RDWR, 0);
+
+    pool->shared = NULL;
+
+    if (fd < 0)
+        return 0; // No daemon has run since boot
+
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(pool_shared_t))
+    {
+        close(fd); // Still being sized by a starting daemon, or not ours
+        return 0;
+    }
+
+    void *map = mmap(NULL, sizeof(pool_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping stays valid without the descriptor
+
+    if (map == MAP_FAILED)
+        return 0;
+
+    pool->shared = map;
+
+    // The magic is published last, so seeing it means the rings are ready
+    if (__atomic_load_n(&pool->shared->magic, __ATOMIC_ACQUIRE) != POOL_MAGIC ||
+        pool->shared->version != POOL_VERSION)
+    {
+        pool_close(pool);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Unmap the pool
+ *
+ * Parameters:
+ *   pool - handle to close
+ */
+void pool_close(pool_t *pool)
+{
+    if (pool->shared != NULL)
+        munmap(pool->shared, sizeof(pool_shared_t));
+
+    pool->shared = NULL;
+}
+
+/**
+ * Add a puzzle to the ring of a difficulty
+ *
+ * Parameters:
+ *   pool       - open pool
+ *   difficulty - ring to add to
+ *   grid       - clues
+ *
+ * Returns: 1 if added, 0 if the ring is full
+ */
+int pool_push(pool_t *pool, difficulty_t difficulty, int grid[9][9])
+{
+    pool_ring_t *ring = &pool->shared->rings[difficulty];
+    uint64_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    pool_slot_t *slot;
+
+    for (;;)
+    {
+        slot = &ring->slots[pos & POOL_MASK];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t lag = (int64_t)(sequence - pos);
+
+        if (lag == 0)
+        {
+            // The slot is free for this position; claim the position
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+                break;
+        }
+        else if (lag < 0)
+        {
+            return 0; // The slot still holds the puzzle of the previous lap: full
+        }
+        else
+        {
+            // Another producer took this position, so the head has moved on;
+            // an unmoved head means the slot's turn was written by someone else
+            uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+            if (head == pos)
+                return 0; // Corrupt slot: report the ring as full
+
+            pos = head;
+        }
+    }
+
+    slot->size = (uint8_t)encode_puzzle(grid, slot->puzzle);
+
+    // Hand the slot to consumers only after the puzzle is in it
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * Take the oldest puzzle from the ring of a difficulty
+ *
+ * Parameters:
+ *   pool       - open pool
+ *   difficulty - ring to take from
+ *   grid       - receives the clues
+ *
+ * Returns: 1 if a puzzle was taken, 0 if the ring is empty
+ */
+int pool_pop(pool_t *pool, difficulty_t difficulty, int grid[9][9])
+{
+    pool_ring_t *ring = &pool->shared->rings[difficulty];
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint8_t puzzle[CODEC_MAX_BYTES];
+    pool_slot_t *slot;
+
+    for (;;)
+    {
+        slot = &ring->slots[pos & POOL_MASK];
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        int64_t lag = (int64_t)(sequence - (pos + 1));
+
+        if (lag == 0)
+        {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+                break;
+        }
+        else if (lag < 0)
+        {
+            return 0; // Nothing published at this position yet: empty
+        }
+        else
+        {
+            // Another consumer took this position, so the tail has moved on;
+            // an unmoved tail means the slot's turn was written by someone else
+            uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+            if (tail == pos)
+                return 0; // Corrupt slot: report the ring as empty
+
+            pos = tail;
+        }
+    }
+
+    size_t size = slot->size < CODEC_MAX_BYTES ? slot->size : CODEC_MAX_BYTES;
+
+    memcpy(puzzle, slot->puzzle, size);
+
+    // Free the slot for the producer one lap later
+    __atomic_store_n(&slot->sequence, pos + POOL_CAPACITY, __ATOMIC_RELEASE);
+
+    if (decode_puzzle(puzzle, size, grid) == 0)
+        memset(grid, 0, sizeof(int[9][9])); // Garbage: pool_take() rejects an empty grid
+
+    return 1;
+}
+
+/**
+ * Count the puzzles waiting in a ring
+ *
+ * Parameters:
+ *   pool       - open pool
+ *   difficulty - ring to count
+ *
+ * Returns: puzzles ready, 0 to POOL_CAPACITY
+ */
+int pool_count(pool_t *pool, difficulty_t difficulty)
+{
+    pool_ring_t *ring = &pool->shared->rings[difficulty];
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    int64_t count = (int64_t)(head - tail);
+
+    // The two loads are not one snapshot; clamp what a race can produce
+    if (count < 0)
+        return 0;
+
+    return count > POOL_CAPACITY ? POOL_CAPACITY : (int)count;
+}
+
+/**
+ * Check a pooled puzzle before it is played and solve it
+ * The segment is writable by every user, so nothing in it is trusted
+ *
+ * Parameters:
+ *   search   - search state to use
+ *   grid     - clues
+ *   solution - receives the solution
+ *
+ * Returns: 1 if the clues have exactly one solution
+ */
+static int pooled_puzzle_valid(search_t *search, int grid[9][9], int solution[9][9])
+{
+    return search_count_to_two(search, grid, POOL_CHECK_NODES, NULL, solution) == SEARCH_COUNT_UNIQUE;
+}
+
+/**
+ * Take a verified classic puzzle from the shared pool, if there is one
+ *
+ * Parameters:
+ *   difficulty - level wanted
+ *   grid       - receives the clues
+ *   solution   - receives the solution
+ *
+ * Returns: 1 if a puzzle was taken, 0 if the caller must generate one
+ */
+int pool_take(difficulty_t difficulty, int grid[9][9], int solution[9][9])
+{
+    pool_t pool;
+    search_t *search;
+    int taken = 0;
+
+    if (!pool_open(&pool))
+        return 0;
+
+    if ((search = malloc(sizeof(*search))) != NULL)
+    {
+        // Skip anything that fails the check rather than fall back at once
+        while (!taken && pool_pop(&pool, difficulty, grid))
+            taken = pooled_puzzle_valid(search, grid, solution);
+    }
+
+    free(search);
+    pool_close(&pool);
+    return taken;
+}
+
+/**
+ * Find the daemon that owns the current segment, for messages
+ * Liveness itself is decided by the daemon lock (lock_daemon())
+ *
+ * Returns: process id of the owner, or 0 if none is running
+ */
+static long running_daemon(void)
+{
+    pool_t pool;
+    long owner = 0;
+
+    if (!pool_open(&pool))
+        return 0;
+
+    // EPERM: alive, but run by another user
+    if (pool.shared->owner > 0 && pool.shared->owner != (int64_t)getpid() &&
+        (kill((pid_t)pool.shared->owner, 0) == 0 || errno == EPERM))
+        owner = (long)pool.shared->owner;
+
+    pool_close(&pool);
+    return owner;
+}
+
+/**
+ * Take the daemon lock: a write lock on a small shared object that is never
+ * unlinked, held for the life of the daemon. The kernel drops it when the
+ * daemon exits or dies, so holding it proves no other daemon is alive
+ *
+ * Returns: descriptor holding the lock, -1 if another daemon holds it,
+ *          -2 on error (reported on stderr)
+ */
+static int lock_daemon(void)
+{
+    struct flock lock;
+    int fd = shm_open(POOL_LOCK_NAME, O_RDWR | O_CREAT, 0666);
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "Cannot open %s: %s\n", POOL_LOCK_NAME, strerror(errno));
+        return -2;
+    }
+
+    fchmod(fd, 0666); // Best effort: lets a daemon of another user lock it later
+
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET; // l_len 0: the whole object
+
+    if (fcntl(fd, F_SETLK, &lock) != 0)
+    {
+        int busy = errno == EACCES || errno == EAGAIN;
+
+        if (!busy)
+            fprintf(stderr, "Cannot lock %s: %s\n", POOL_LOCK_NAME, strerror(errno));
+
+        close(fd);
+        return busy ? -1 : -2;
+    }
+
+    return fd;
+}
+
+/**
+ * Build a fresh, empty segment owned by this process
+ * Call with the daemon lock held. The name is claimed with O_EXCL; a segment
+ * already there belongs to a daemon that is gone (the lock says so), so it is
+ * unlinked and the claim retried. Games that still map the old segment drain
+ * it and move to the new one on their next pool_take()
+ *
+ * Parameters:
+ *   pool - handle to fill
+ *
+ * Returns: 1 on success, 0 on error (reported on stderr)
+ */
+static int create_pool(pool_t *pool)
+{
+    int fd = shm_open(POOL_SHM_NAME, O_RDWR | O_CREAT | O_EXCL, 0666);
+
+    if (fd < 0 && errno == EEXIST)
+    {
+        shm_unlink(POOL_SHM_NAME);
+        fd = shm_open(POOL_SHM_NAME, O_RDWR | O_CREAT | O_EXCL, 0666);
+    }
+
+    if (fd < 0)
+    {
+        fprintf(stderr, "Cannot create %s: %s\n", POOL_SHM_NAME, strerror(errno));
+        return 0;
+    }
+
+    // Every user's game must be able to take puzzles, whatever the umask
+    if (fchmod(fd, 0666) != 0 || ftruncate(fd, sizeof(pool_shared_t)) != 0)
+    {
+        fprintf(stderr, "Cannot size %s: %s\n", POOL_SHM_NAME, strerror(errno));
+        close(fd);
+        shm_unlink(POOL_SHM_NAME);
+        return 0;
+    }
+
+    void *map = mmap(NULL, sizeof(pool_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "Cannot map %s: %s\n", POOL_SHM_NAME, strerror(errno));
+        shm_unlink(POOL_SHM_NAME);
+        return 0;
+    }
+
+    pool->shared = map;
+
+    // ftruncate zero-fills; only the slot turns need setting
+    for (int level = 0; level < POOL_LEVELS; level++)
+    {
+        for (int i = 0; i < POOL_CAPACITY; i++)
+            pool->shared->rings[level].slots[i].sequence = (uint64_t)i;
+    }
+
+    pool->shared->version = POOL_VERSION;
+    pool->shared->owner = (int64_t)getpid();
+    __atomic_store_n(&pool->shared->magic, POOL_MAGIC, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * Worker: generate puzzles for the emptiest ring until stopped
+ *
+ * Parameters:
+ *   arg - pool_worker_t of this thread
+ *
+ * Returns: NULL
+ */
+static void *pool_worker(void *arg)
+{
+    pool_worker_t *worker = arg;
+    generator_options_t options = {EASY, 0, SYMMETRY_NONE, NULL, 0, 0, &stop_requested,
+                                   GENERATOR_REMOVAL};
+    int grid[9][9], solution[9][9], given[9][9];
+    rng_t rng;
+
+    rng_seed(&rng, worker->seed);
+    options.rng = &rng;
+    use_thread_topology(get_topology(VARIANT_CLASSIC));
+
+    while (!stop_requested)
+    {
+        int level = -1, lowest = POOL_CAPACITY;
+
+        for (int i = 0; i < POOL_LEVELS; i++)
+        {
+            int count = pool_count(worker->pool, (difficulty_t)i);
+
+            if (count < lowest)
+            {
+                lowest = count;
+                level = i;
+            }
+        }
+
+        if (level < 0)
+        {
+            // Every ring is full: wait for games to take some
+            for (int slice = 0; slice < POOL_IDLE_MS / 10 && !stop_requested; slice++)
+            {
+                struct timespec pause = {0, 10 * 1000000L};
+                nanosleep(&pause, NULL);
+            }
+            continue;
+        }
+
+        options.difficulty = (difficulty_t)level;
+        generate_puzzle_ex(grid, solution, given, &options, NULL);
+
+        // Another thread may have filled the ring meanwhile; the puzzle is then dropped
+        if (!stop_requested)
+            pool_push(worker->pool, (difficulty_t)level, grid);
+    }
+
+    use_thread_topology(NULL);
+    return NULL;
+}
+
+/**
+ * Run the generator daemon until SIGINT or SIGTERM
+ *
+ * Parameters:
+ *   threads - generator threads (0 = one per online CPU)
+ *
+ * Returns: 0 after a signal, 1 on error
+ */
+int pool_daemon(int threads)
+{
+    int thread_count = batch_thread_count(threads);
+    pthread_t handles[BATCH_MAX_THREADS];
+    pool_worker_t workers[BATCH_MAX_THREADS];
+    struct sigaction action;
+    pool_t pool;
+    rng_t seeder;
+    int lock = lock_daemon();
+
+    if (lock == -1)
+    {
+        long owner = running_daemon();
+
+        if (owner != 0)
+            fprintf(stderr, "A pool daemon is already running (pid %ld)\n", owner);
+        else
+            fprintf(stderr, "A pool daemon is already starting\n");
+        return 1;
+    }
+
+    if (lock < 0 || !create_pool(&pool))
+    {
+        if (lock >= 0)
+            close(lock);
+        return 1;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    rng_seed(&seeder, (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32));
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        workers[i].pool = &pool;
+        workers[i].seed = rng_next(&seeder); // Independent stream per thread
+        pthread_create(&handles[i], NULL, pool_worker, &workers[i]);
+    }
+
+    fprintf(stderr, "pool %s: %d puzzles per level, %d thread(s); stop with Ctrl-C\n",
+            POOL_SHM_NAME, POOL_CAPACITY, thread_count);
+
+    for (int i = 0; i < thread_count; i++)
+        pthread_join(handles[i], NULL);
+
+    fprintf(stderr, "pool stopped: %d/%d/%d/%d puzzles left\n", pool_count(&pool, EASY),
+            pool_count(&pool, MEDIUM), pool_count(&pool, HARD), pool_count(&pool, EXPERT));
+
+    pool_close(&pool); // The segment stays so games can drain it
+    close(lock);       // Releases the daemon lock
+    return 0;
+}
@@ -0,0 +1,511 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/reader.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Convert one puzzle character to a cell value
+ *
+ * Parameters:
+ *   ch - character from the puzzle line
+ *
+ * Returns: 0-9 for a valid cell ('.' maps to 0), -1 for anything else
+ */
+static int cell_value(char ch)
+{
+    if (ch == '.')
+        return 0;
+
+    if (ch >= '0' && ch <= '9')
+        return ch - '0';
+
+    return -1; // Not a puzzle character
+}
+
+/**
+ * Scalar cell conversion used for the SIMD tail and non-SSE2 targets
+ *
+ * Parameters:
+ *   text  - first character to convert
+ *   cells - destination cell values
+ *   count - number of cells to convert
+ *
+ * Returns: 1 if every character was valid, 0 otherwise
+ */
+static int parse_cells_scalar(const char *text, int *cells, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        int value = cell_value(text[i]);
+
+        if (value < 0)
+            return 0; // Invalid character
+
+        cells[i] = value;
+    }
+
+    return 1;
+}
+
+#ifdef __SSE2__
+/**
+ * SSE2 cell conversion: 16 characters per step
+ * Maps '.' to '0', subtracts '0' and rejects anything outside 0-9, then widens
+ * the bytes straight into the int grid
+ *
+ * Parameters:
+ *   text  - start of the 81 puzzle characters
+ *   cells - destination cell values (81 ints)
+ *
+ * Returns: 1 if every character was valid, 0 otherwise
+ */
+static int parse_cells_sse2(const char *text, int *cells)
+{
+    const __m128i dot = _mm_set1_epi8('.');
+    const __m128i zero_char = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (int i = 0; i + 16 <= PUZZLE_LINE_LENGTH; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i *)(text + i));
+
+        // Replace '.' by '0' so both spellings of an empty cell decode to 0
+        __m128i is_dot = _mm_cmpeq_epi8(chars, dot);
+        chars = _mm_or_si128(_mm_andnot_si128(is_dot, chars), _mm_and_si128(is_dot, zero_char));
+
+        // Characters below '0' wrap around to large unsigned values
+        __m128i digits = _mm_sub_epi8(chars, zero_char);
+        __m128i in_range = _mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits);
+
+        if (_mm_movemask_epi8(in_range) != 0xFFFF)
+            return 0; // Some character is not a digit or '.'
+
+        // Widen 16 bytes -> 16 ints
+        __m128i low = _mm_unpacklo_epi8(digits, zero);
+        __m128i high = _mm_unpackhi_epi8(digits, zero);
+
+        _mm_storeu_si128((__m128i *)(cells + i), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128((__m128i *)(cells + i + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128((__m128i *)(cells + i + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128((__m128i *)(cells + i + 12), _mm_unpackhi_epi16(high, zero));
+    }
+
+    // 81 = 5 * 16 + 1: convert the final cell with the scalar path
+    return parse_cells_scalar(text + 80, cells + 80, 1);
+}
+#endif
+
+/**
+ * Parse one puzzle line (without newline) into a grid
+ * Accepts 81 cells optionally followed by whitespace, '#' or ';' and a comment
+ *
+ * Parameters:
+ *   line   - start of the line
+ *   length - number of bytes in the line
+ *   grid   - 9x9 grid that receives the puzzle
+ *
+ * Returns: 1 if the line holds a puzzle, 0 if malformed
+ */
+int parse_puzzle_line(const char *line, size_t length, int grid[9][9])
+{
+    if (length < PUZZLE_LINE_LENGTH)
+        return 0; // Too short to be a puzzle
+
+    if (length > PUZZLE_LINE_LENGTH)
+    {
+        char next = line[PUZZLE_LINE_LENGTH];
+
+        // Anything glued to the 81st cell means this is not a puzzle row
+        if (next != ' ' && next != '\t' && next != '#' && next != ';')
+            return 0;
+    }
+
+#ifdef __SSE2__
+    return parse_cells_sse2(line, &grid[0][0]);
+#else
+    return parse_cells_scalar(line, &grid[0][0], PUZZLE_LINE_LENGTH);
+#endif
+}
+
+/**
+ * Parse the jigsaw region map that may follow the puzzle on a line
+ *
+ * Parameters:
+ *   line    - start of the puzzle line
+ *   length  - number of bytes in the line
+ *   regions - receives the region (0-8) of each cell
+ *
+ * Returns: 1 if the line carries a region map, 0 otherwise
+ */
+int parse_region_map(const char *line, size_t length, uint8_t regions[81])
+{
+    size_t pos = PUZZLE_LINE_LENGTH;
+
+    while (pos < length && (line[pos] == ' ' || line[pos] == '\t'))
+        pos++;
+
+    if (pos == PUZZLE_LINE_LENGTH || length - pos < PUZZLE_LINE_LENGTH)
+        return 0; // No separate second field
+
+    if (length - pos > PUZZLE_LINE_LENGTH)
+    {
+        char next = line[pos + PUZZLE_LINE_LENGTH];
+
+        if (next != ' ' && next != '\t' && next != '#' && next != ';')
+            return 0; // Longer field: a comment, not a map
+    }
+
+    for (int i = 0; i < PUZZLE_LINE_LENGTH; i++)
+    {
+        char ch = line[pos + i];
+
+        if (ch < '1' || ch > '9')
+            return 0;
+
+        regions[i] = (uint8_t)(ch - '1');
+    }
+
+    return 1;
+}
+
+/**
+ * Parse the killer cage list that may follow the puzzle on a line
+ *
+ * Parameters:
+ *   line   - start of the puzzle line
+ *   length - number of bytes in the line
+ *   cages  - receives the cages
+ *
+ * Returns: 1 if the line carries a cage list, 0 otherwise
+ */
+int parse_cage_list(const char *line, size_t length, cage_layout_t *cages)
+{
+    size_t pos = PUZZLE_LINE_LENGTH;
+
+    while (pos < length && (line[pos] == ' ' || line[pos] == '\t'))
+        pos++;
+
+    if (pos == PUZZLE_LINE_LENGTH || pos == length)
+        return 0; // No separate second field
+
+    cages->count = 0;
+
+    for (;;)
+    {
+        int sum = 0, digits = 0;
+
+        if (cages->count == TOPOLOGY_MAX_CAGES)
+            return 0;
+
+        cage_t *cage = &cages->cages[cages->count++];
+
+        while (pos < length && line[pos] >= '0' && line[pos] <= '9' && digits < 2)
+        {
+            sum = sum * 10 + (line[pos++] - '0');
+            digits++;
+        }
+
+        if (digits == 0 || pos == length || line[pos++] != '@')
+            return 0; // Not "<sum>@": a comment or a region map, not cages
+
+        cage->sum = (uint8_t)sum;
+        cage->size = 0;
+
+        // Cells as 1-based row and column digit pairs
+        while (pos + 1 < length && line[pos] >= '1' && line[pos] <= '9' &&
+               line[pos + 1] >= '1' && line[pos + 1] <= '9')
+        {
+            if (cage->size == GRID_SIZE)
+                return 0;
+
+            cage->cells[cage->size++] = (uint8_t)((line[pos] - '1') * 9 + (line[pos + 1] - '1'));
+            pos += 2;
+        }
+
+        if (cage->size == 0)
+            return 0;
+
+        if (pos == length || line[pos] == ' ' || line[pos] == '\t' || line[pos] == '#' ||
+            line[pos] == ';')
+            return 1;
+
+        if (line[pos++] != ',')
+            return 0;
+    }
+}
+
+/**
+ * Refill the streaming buffer
+ * Moves the unconsumed tail to the front and reads as much as fits
+ *
+ * Parameters:
+ *   reader - streaming reader
+ *
+ * Returns: 1 if new bytes were read or the buffer was compacted, 0 at end of input
+ */
+static int reader_fill(reader_t *reader)
+{
+    size_t tail = reader->size - reader->pos;
+
+    // A line longer than the whole buffer can never be a puzzle: drop it
+    if (tail == READER_STREAM_BUFFER)
+    {
+        reader->buffer_offset += tail;
+        reader->size = 0;
+        reader->pos = 0;
+        reader->overlong = 1;
+        tail = 0;
+    }
+
+    // Keep the partial line at the front of the buffer
+    if (reader->pos > 0)
+    {
+        memmove(reader->buffer, reader->buffer + reader->pos, tail);
+        reader->buffer_offset += reader->pos;
+        reader->size = tail;
+        reader->pos = 0;
+    }
+
+    while (reader->size < READER_STREAM_BUFFER)
+    {
+        ssize_t got = read(reader->fd, reader->buffer + reader->size,
+                           READER_STREAM_BUFFER - reader->size);
+
+        if (got < 0 && errno == EINTR)
+            continue; // Interrupted - retry
+
+        if (got <= 0)
+        {
+            reader->eof = 1; // End of input (or read error)
+            break;
+        }
+
+        reader->size += (size_t)got;
+
+        // One read per refill is enough unless we have not seen a full line yet
+        if (memchr(reader->buffer + tail, '\n', reader->size - tail))
+            break;
+    }
+
+    return reader->size > 0 || !reader->eof;
+}
+
+/**
+ * Open a puzzle source for reading
+ * Maps regular files, streams stdin and anything unmappable
+ *
+ * Parameters:
+ *   reader - reader state to initialize
+ *   path   - file path, or "-" for stdin
+ *
+ * Returns: 1 if opened, 0 on error
+ */
+int reader_open(reader_t *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    if (strcmp(path, "-") == 0)
+    {
+        reader->fd = STDIN_FILENO;
+    }
+    else
+    {
+        reader->fd = open(path, O_RDONLY);
+
+        if (reader->fd < 0)
+            return 0; // Cannot open file
+    }
+
+    struct stat info;
+
+    if (reader->fd != STDIN_FILENO && fstat(reader->fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        if (info.st_size == 0)
+        {
+            reader->mapped = 1; // Empty file: nothing to map, nothing to read
+            reader->eof = 1;
+            return 1;
+        }
+
+        void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, reader->fd, 0);
+
+        if (map != MAP_FAILED)
+        {
+            posix_madvise(map, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+            reader->mapped = 1;
+            reader->eof = 1;
+            reader->data = map;
+            reader->size = (size_t)info.st_size;
+            return 1;
+        }
+    }
+
+    // Streaming fallback: one large buffer reused for the whole input
+    reader->buffer = malloc(READER_STREAM_BUFFER);
+
+    if (reader->buffer == NULL)
+    {
+        reader_close(reader);
+        return 0;
+    }
+
+    reader->data = reader->buffer;
+    return 1;
+}
+
+/**
+ * Parse the next puzzle line into a grid
+ * Skips blank lines, '#' comments and malformed lines
+ *
+ * Parameters:
+ *   reader - open reader
+ *   grid   - 9x9 grid that receives the puzzle
+ *
+ * Returns: 1 if a puzzle was read, 0 at end of input
+ */
+int reader_next(reader_t *reader, int grid[9][9])
+{
+    for (;;)
+    {
+        const char *start = reader->data + reader->pos;
+        size_t available = reader->size - reader->pos;
+        const char *newline = available ? memchr(start, '\n', available) : NULL;
+        size_t length;
+
+        if (newline != NULL)
+        {
+            length = (size_t)(newline - start);
+        }
+        else if (!reader->eof)
+        {
+            if (!reader_fill(reader))
+                return 0; // Nothing left to read
+
+            continue; // Rescan the refilled buffer
+        }
+        else if (available > 0)
+        {
+            length = available; // Last line without a trailing newline
+        }
+        else
+        {
+            return 0; // End of input
+        }
+
+        reader->line_offset = reader->buffer_offset + reader->pos;
+        reader->line++;
+        reader->pos += length + (newline != NULL);
+
+        if (reader->overlong)
+        {
+            // Remainder of a line that did not fit in the buffer
+            reader->overlong = 0;
+            reader->skipped++;
+            continue;
+        }
+
+        if (length > 0 && start[length - 1] == '\r')
+            length--; // Tolerate CRLF line endings
+
+        if (length == 0 || start[0] == '#')
+            continue; // Blank line or comment
+
+        if (parse_puzzle_line(start, length, grid))
+        {
+            reader->has_regions = length > PUZZLE_LINE_LENGTH &&
+                                  parse_region_map(start, length, reader->regions);
+            reader->has_cages = length > PUZZLE_LINE_LENGTH && !reader->has_regions &&
+                                parse_cage_list(start, length, &reader->cages);
+            return 1;
+        }
+
+        reader->skipped++; // Malformed line
+    }
+}
+
+/**
+ * Byte offset just past the last line returned
+ *
+ * Parameters:
+ *   reader - open reader
+ *
+ * Returns: input offset where the next line starts
+ */
+uint64_t reader_offset(const reader_t *reader)
+{
+    return reader->buffer_offset + reader->pos;
+}
+
+/**
+ * Continue reading at a saved offset
+ * Mapped files move the parse position; streams discard bytes up to it
+ *
+ * Parameters:
+ *   reader  - freshly opened reader
+ *   offset  - input offset to resume at
+ *   line    - line number before the offset
+ *   skipped - malformed lines before the offset
+ *
+ * Returns: 1 on success, 0 if the input is shorter than the offset
+ */
+int reader_seek(reader_t *reader, uint64_t offset, long line, long skipped)
+{
+    if (reader->mapped)
+    {
+        if (offset > reader->size)
+            return 0;
+
+        reader->pos = (size_t)offset;
+    }
+    else
+    {
+        while (reader_offset(reader) + (reader->size - reader->pos) < offset)
+        {
+            // Drop the whole buffer and read on
+            reader->pos = reader->size;
+
+            if (reader->eof || !reader_fill(reader))
+                return 0;
+        }
+
+        reader->pos += (size_t)(offset - reader_offset(reader));
+    }
+
+    reader->line = line;
+    reader->skipped = skipped;
+    return 1;
+}
+
+/**
+ * Release the mapping or streaming buffer and close the source
+ *
+ * Parameters:
+ *   reader - reader to close
+ */
+void reader_close(reader_t *reader)
+{
+    if (reader->mapped && reader->size > 0)
+        munmap((void *)reader->data, reader->size);
+
+    free(reader->buffer);
+
+    if (reader->fd > STDIN_FILENO)
+        close(reader->fd);
+
+    reader->data = NULL;
+    reader->buffer = NULL;
+    reader->size = 0;
+    reader->pos = 0;
+    reader->fd = -1;
+}
@@ -0,0 +1,203 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/restart.h"
+#include "../include/generator.h"
+#include "../include/rng.h"
+#include <pthread.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+
+typedef struct restart_race restart_race_t;
+
+typedef struct
+{
+    restart_race_t *race;       // Shared race state
+    rng_t rng;                  // Thread-private random source
+    int grid[9][9];             // Best puzzle found by this thread
+    int solution[9][9];         // Its solution
+    int given[9][9];            // Its clue mask
+    generator_report_t report;  // Result of the thread's generation
+    int reached;                // Flag: 1 = this thread reached the target
+    double finish_seconds;      // Monotonic time the thread finished
+} restart_slot_t;
+
+struct restart_race
+{
+    const restart_options_t *options;
+    volatile int cancel;        // Set once a thread wins or the budget is spent
+    int finished;               // Threads that have returned
+    pthread_mutex_t lock;       // Guards cancel (for writers) and finished
+    pthread_cond_t done;        // Signalled when a thread wins or finishes
+};
+
+/**
+ * Read the monotonic clock
+ *
+ * Returns: seconds since an arbitrary fixed point
+ */
+static double monotonic_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * Worker: run restarts until the target is reached or the race is cancelled
+ *
+ * Parameters:
+ *   arg - restart_slot_t of this thread
+ *
+ * Returns: NULL
+ */
+static void *restart_worker(void *arg)
+{
+    restart_slot_t *slot = arg;
+    restart_race_t *race = slot->race;
+    const restart_options_t *options = race->options;
+    generator_options_t generator = {EXPERT, options->target_clues, options->symmetry,
+                                     &slot->rng, options->minimal, INT_MAX, &race->cancel,
+                                     options->method};
+
+    // Passes repeat until the target is hit; only cancellation ends them early
+    slot->reached = generate_puzzle_ex(slot->grid, slot->solution, slot->given,
+                                       &generator, &slot->report);
+    slot->finish_seconds = monotonic_seconds();
+
+    pthread_mutex_lock(&race->lock);
+
+    if (slot->reached)
+        race->cancel = 1; // Winner: stop everyone else
+
+    race->finished++;
+    pthread_cond_signal(&race->done);
+    pthread_mutex_unlock(&race->lock);
+
+    return NULL;
+}
+
+/**
+ * Generate a puzzle with a target clue count using parallel restarts
+ *
+ * Parameters:
+ *   grid     - 9x9 array for the puzzle
+ *   solution - 9x9 array storing the complete solution
+ *   given    - 9x9 array marking original clues
+ *   options  - target, symmetry, thread count, time budget and seed
+ *   report   - receives success, clue count, time and work done (may be NULL)
+ *
+ * Returns: 1 if the target was reached, 0 otherwise
+ */
+int generate_target_puzzle(int grid[9][9], int solution[9][9], int given[9][9],
+                           const restart_options_t *options, restart_report_t *report)
+{
+    restart_slot_t slots[RESTART_MAX_THREADS];
+    pthread_t threads[RESTART_MAX_THREADS];
+    restart_race_t race;
+    pthread_condattr_t attr;
+    rng_t seeder;
+    int thread_count = options->threads;
+    double budget = options->budget > 0 ? options->budget : RESTART_DEFAULT_BUDGET;
+
+    if (thread_count <= 0)
+        thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (thread_count < 1)
+        thread_count = 1;
+
+    if (thread_count > RESTART_MAX_THREADS)
+        thread_count = RESTART_MAX_THREADS;
+
+    race.options = options;
+    race.cancel = 0;
+    race.finished = 0;
+    pthread_mutex_init(&race.lock, NULL);
+
+    // Wait against the monotonic clock so wall-clock changes cannot stretch the budget
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&race.done, &attr);
+    pthread_condattr_destroy(&attr);
+
+    rng_seed(&seeder, options->seed);
+
+    double start = monotonic_seconds();
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t)budget;
+    deadline.tv_nsec += (long)((budget - (double)(time_t)budget) * 1e9);
+
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        slots[i].race = &race;
+        rng_seed(&slots[i].rng, rng_next(&seeder)); // Independent stream per thread
+        pthread_create(&threads[i], NULL, restart_worker, &slots[i]);
+    }
+
+    // Sleep until a winner appears, every thread gives up or time runs out
+    pthread_mutex_lock(&race.lock);
+
+    while (!race.cancel && race.finished < thread_count)
+    {
+        if (pthread_cond_timedwait(&race.done, &race.lock, &deadline) == ETIMEDOUT)
+            break;
+    }
+
+    race.cancel = 1;
+    pthread_mutex_unlock(&race.lock);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Earliest winner, or else the thread whose best puzzle has the fewest clues
+    int best = 0;
+    long passes = 0, tests = 0;
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        passes += slots[i].report.attempts;
+        tests += slots[i].report.tests;
+
+        if (slots[i].reached != slots[best].reached)
+        {
+            if (slots[i].reached)
+                best = i;
+        }
+        else if (slots[i].reached ? slots[i].finish_seconds < slots[best].finish_seconds
+                                  : slots[i].report.clues < slots[best].report.clues)
+        {
+            best = i;
+        }
+    }
+
+    memcpy(grid, slots[best].grid, sizeof(slots[best].grid));
+    memcpy(solution, slots[best].solution, sizeof(slots[best].solution));
+    memcpy(given, slots[best].given, sizeof(slots[best].given));
+
+    if (report != NULL)
+    {
+        report->reached = slots[best].reached;
+        report->clues = slots[best].report.clues;
+        report->seconds = (slots[best].reached ? slots[best].finish_seconds : monotonic_seconds()) - start;
+        report->passes = passes;
+        report->tests = tests;
+        report->threads = thread_count;
+    }
+
+    pthread_cond_destroy(&race.done);
+    pthread_mutex_destroy(&race.lock);
+
+    return slots[best].reached;
+}
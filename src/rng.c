@@ -0,0 +1,55 @@
+#include "../include/sudoku.h"
+#include "../include/rng.h"
+
+/**
+ * Seed a generator
+ *
+ * Parameters:
+ *   rng  - generator to seed
+ *   seed - 64-bit seed value
+ */
+void rng_seed(rng_t *rng, uint64_t seed)
+{
+    rng->state = seed;
+}
+
+/**
+ * Produce the next 64-bit random value (SplitMix64)
+ *
+ * Parameters:
+ *   rng - generator state
+ *
+ * Returns: uniformly distributed 64-bit value
+ */
+uint64_t rng_next(rng_t *rng)
+{
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Produce a uniformly distributed integer in [0, bound)
+ * Uses multiply-shift with rejection so small ranges are not biased
+ *
+ * Parameters:
+ *   rng   - generator state
+ *   bound - exclusive upper bound
+ *
+ * Returns: random integer from 0 to bound - 1
+ */
+int rng_below(rng_t *rng, int bound)
+{
+    uint32_t range = (uint32_t)bound;
+    uint32_t threshold = (uint32_t)(-range) % range;
+
+    for (;;)
+    {
+        uint64_t product = (uint64_t)(uint32_t)rng_next(rng) * range;
+
+        if ((uint32_t)product >= threshold)
+            return (int)(product >> 32);
+    }
+}
@@ -0,0 +1,331 @@
+#include "../include/sudoku.h"
+#include "../include/samurai.h"
+#include <pthread.h>
+
+static samurai_layout_t layout;
+static pthread_once_t layout_built = PTHREAD_ONCE_INIT;
+
+// Top-left layout square of each grid: four satellites, then the center
+static const int grid_origins[SAMURAI_GRIDS][2] = {{0, 0}, {0, 12}, {12, 0}, {12, 12}, {6, 6}};
+
+/**
+ * Append a unit of nine layout squares to the tables
+ *
+ * Parameters:
+ *   unit    - unit number
+ *   squares - layout row * SAMURAI_SIZE + column of each cell
+ */
+static void add_unit(int unit, const int squares[GRID_SIZE])
+{
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        int cell = layout.index[squares[i] / SAMURAI_SIZE][squares[i] % SAMURAI_SIZE];
+
+        layout.units[unit][i] = (uint16_t)cell;
+        layout.cell_units[cell][layout.cell_unit_count[cell]++] = (uint8_t)unit;
+    }
+}
+
+/**
+ * Build the cell numbering, units and peers (run once)
+ */
+static void build_layout(void)
+{
+    uint8_t box_seen[SAMURAI_SIZE / 3][SAMURAI_SIZE / 3] = {{0}};
+    int squares[GRID_SIZE];
+    int cells = 0, units = 0;
+
+    memset(layout.index, -1, sizeof(layout.index));
+
+    for (int g = 0; g < SAMURAI_GRIDS; g++)
+    {
+        for (int i = 0; i < 81; i++)
+            layout.index[grid_origins[g][0] + i / 9][grid_origins[g][1] + i % 9] = 0;
+    }
+
+    for (int row = 0; row < SAMURAI_SIZE; row++)
+    {
+        for (int col = 0; col < SAMURAI_SIZE; col++)
+        {
+            if (layout.index[row][col] < 0)
+                continue;
+
+            layout.index[row][col] = (int16_t)cells;
+            layout.row[cells] = (uint8_t)row;
+            layout.col[cells] = (uint8_t)col;
+            cells++;
+        }
+    }
+
+    for (int g = 0; g < SAMURAI_GRIDS; g++)
+    {
+        int top = grid_origins[g][0], left = grid_origins[g][1];
+
+        for (int r = 0; r < GRID_SIZE; r++)
+        {
+            for (int i = 0; i < GRID_SIZE; i++)
+                squares[i] = (top + r) * SAMURAI_SIZE + left + i;
+
+            add_unit(units++, squares);
+        }
+
+        for (int c = 0; c < GRID_SIZE; c++)
+        {
+            for (int i = 0; i < GRID_SIZE; i++)
+                squares[i] = (top + i) * SAMURAI_SIZE + left + c;
+
+            add_unit(units++, squares);
+        }
+
+        // Boxes sit on the layout's 3x3 lattice; a shared box is added once
+        for (int box = 0; box < GRID_SIZE; box++)
+        {
+            int box_top = top + (box / 3) * 3, box_left = left + (box % 3) * 3;
+
+            if (box_seen[box_top / 3][box_left / 3]++)
+                continue;
+
+            for (int i = 0; i < GRID_SIZE; i++)
+                squares[i] = (box_top + i / 3) * SAMURAI_SIZE + box_left + i % 3;
+
+            add_unit(units++, squares);
+        }
+    }
+
+    layout.topology.cell_count = SAMURAI_CELLS;
+    layout.topology.cell_unit_count = layout.cell_unit_count;
+    layout.topology.cell_units = layout.cell_units;
+    layout.topology.cages = NULL;
+
+    // Peers: every other cell of every unit containing the cell, once each
+    for (int cell = 0; cell < SAMURAI_CELLS; cell++)
+    {
+        uint8_t seen[SAMURAI_CELLS] = {0};
+
+        seen[cell] = 1;
+
+        for (int k = 0; k < layout.cell_unit_count[cell]; k++)
+        {
+            const uint16_t *unit = layout.units[layout.cell_units[cell][k]];
+
+            for (int i = 0; i < GRID_SIZE; i++)
+            {
+                if (!seen[unit[i]])
+                {
+                    seen[unit[i]] = 1;
+                    layout.peers[cell][layout.peer_count[cell]++] = unit[i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Get the Samurai tables
+ *
+ * Returns: read-only tables
+ */
+const samurai_layout_t *samurai_layout(void)
+{
+    pthread_once(&layout_built, build_layout);
+
+    return &layout;
+}
+
+/**
+ * Check a digit against every unit of a cell
+ *
+ * Parameters:
+ *   cells - the 369 cells
+ *   cell  - cell index
+ *   num   - digit to check (1-9)
+ *
+ * Returns: 1 if no peer holds the digit, 0 otherwise
+ */
+int samurai_valid_placement(const int cells[SAMURAI_CELLS], int cell, int num)
+{
+    const samurai_layout_t *tables = samurai_layout();
+
+    for (int i = 0; i < tables->peer_count[cell]; i++)
+    {
+        if (cells[tables->peers[cell][i]] == num)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Count solutions up to a limit
+ *
+ * Parameters:
+ *   cells    - the 369 cells
+ *   limit    - stop once this many solutions are found (0 = no limit)
+ *   solution - receives the first solution found (may be NULL)
+ *
+ * Returns: number of solutions found
+ */
+long samurai_count_solutions(const int cells[SAMURAI_CELLS], long limit, int solution[SAMURAI_CELLS])
+{
+    search_t *search = malloc(sizeof(*search));
+    long found = 0;
+
+    if (search == NULL)
+        return 0;
+
+    if (search_init_cells(search, &samurai_layout()->topology, cells))
+    {
+        while ((limit <= 0 || found < limit) && search_run(search, 0, NULL) == SEARCH_FOUND)
+        {
+            if (found++ == 0 && solution != NULL)
+                search_get_cells(search, solution);
+        }
+    }
+
+    free(search);
+    return found;
+}
+
+/**
+ * Pick a random index in [0, bound) from the seeded generator or rand()
+ *
+ * Parameters:
+ *   rng   - seeded generator, or NULL to use rand()
+ *   bound - exclusive upper bound
+ *
+ * Returns: random integer from 0 to bound - 1
+ */
+static int random_below(rng_t *rng, int bound)
+{
+    return rng ? rng_below(rng, bound) : rand() % bound;
+}
+
+/**
+ * Fill all 369 cells with a random valid Samurai grid
+ *
+ * Parameters:
+ *   solution - receives the complete grid
+ *   rng      - seeded generator, or NULL to use rand()
+ */
+void samurai_fill(int solution[SAMURAI_CELLS], rng_t *rng)
+{
+    search_t *search = malloc(sizeof(*search));
+
+    if (search == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    for (;;)
+    {
+        memset(solution, 0, sizeof(int) * SAMURAI_CELLS);
+
+        for (int placed = 0; placed < SAMURAI_FILL_SEEDS; )
+        {
+            int cell = random_below(rng, SAMURAI_CELLS);
+            int value = 1 + random_below(rng, 9);
+
+            if (solution[cell] == 0 && samurai_valid_placement(solution, cell, value))
+            {
+                solution[cell] = value;
+                placed++;
+            }
+        }
+
+        if (search_init_cells(search, &samurai_layout()->topology, solution) &&
+            search_run(search, SAMURAI_FILL_NODES, NULL) == SEARCH_FOUND)
+            break;
+    }
+
+    search_get_cells(search, solution);
+
+    free(search);
+}
+
+/**
+ * Clue target of a Samurai puzzle for a difficulty level
+ * About five classic puzzles' worth of clues, less the shared boxes
+ *
+ * Parameters:
+ *   difficulty - puzzle level
+ *
+ * Returns: clue count to aim for
+ */
+static int samurai_clue_target(difficulty_t difficulty)
+{
+    switch (difficulty)
+    {
+        case EASY:
+            return 160;
+        case MEDIUM:
+            return 140;
+        case HARD:
+            return 125;
+        case EXPERT:
+            return 110;
+        default:
+            return 160;
+    }
+}
+
+/**
+ * Generate a Samurai puzzle with a unique solution
+ *
+ * Parameters:
+ *   puzzle     - receives the puzzle
+ *   solution   - receives the complete solution
+ *   difficulty - level selecting the clue target
+ *   rng        - seeded generator, or NULL to use rand()
+ *
+ * Returns: number of clues in the puzzle
+ */
+int samurai_generate(int puzzle[SAMURAI_CELLS], int solution[SAMURAI_CELLS],
+                     difficulty_t difficulty, rng_t *rng)
+{
+    search_t *search = malloc(sizeof(*search));
+    int order[SAMURAI_CELLS];
+    int clues = SAMURAI_CELLS;
+    int target = samurai_clue_target(difficulty);
+
+    if (search == NULL)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    samurai_fill(solution, rng);
+    memcpy(puzzle, solution, sizeof(int) * SAMURAI_CELLS);
+
+    for (int i = 0; i < SAMURAI_CELLS; i++)
+        order[i] = i;
+
+    for (int i = SAMURAI_CELLS - 1; i > 0; i--)
+    {
+        int j = random_below(rng, i + 1);
+        int temp = order[i];
+
+        order[i] = order[j];
+        order[j] = temp;
+    }
+
+    for (int i = 0; i < SAMURAI_CELLS && clues > target; i++)
+    {
+        int cell = order[i];
+
+        puzzle[cell] = 0;
+
+        // Unique after the removal exactly when the cell cannot take another
+        // digit; an undecided check keeps the clue to stay safe
+        search_init_cells(search, &samurai_layout()->topology, puzzle);
+        search_forbid(search, cell, solution[cell]);
+
+        if (search_run(search, SAMURAI_CHECK_NODES, NULL) == SEARCH_EXHAUSTED)
+            clues--;
+        else
+            puzzle[cell] = solution[cell];
+    }
+
+    free(search);
+    return clues;
+}
@@ -0,0 +1,531 @@
+#include "../include/sudoku.h"
+#include "../include/search.h"
+
+/**
+ * Candidate digits for an empty cell given the current masks
+ * A cell's first three units are always its row, column and box, so the
+ * classic case is three loads; only variant extras and the shared Samurai
+ * boxes take the loop and only killer cells take the cage mask
+ *
+ * Parameters:
+ *   search - search state
+ *   cell   - cell index
+ *
+ * Returns: 9-bit candidate mask
+ */
+static inline uint16_t candidates(const search_t *search, int cell)
+{
+    const uint8_t *units = search->topology.cell_units[cell];
+    uint16_t used = search->unit_used[units[0]] | search->unit_used[units[1]] |
+                    search->unit_used[units[2]] | search->forbidden[cell];
+
+    for (int k = 3; k < search->topology.cell_unit_count[cell]; k++)
+    {
+        used |= search->unit_used[units[k]];
+    }
+
+    uint16_t mask = (uint16_t)(~used & ALL_DIGITS);
+
+    if (search->combinations != NULL && search->topology.cages->cage_of[cell] >= 0)
+        mask &= search->cage_allowed[search->topology.cages->cage_of[cell]];
+
+    return mask;
+}
+
+/**
+ * Add or remove a digit from the unit masks of a cell
+ * In a killer cage the cage's sum, empty count and allowed digits follow
+ *
+ * Parameters:
+ *   search - search state
+ *   cell   - cell index
+ *   bit    - digit bit to toggle
+ */
+static inline void toggle_digit(search_t *search, int cell, uint16_t bit)
+{
+    const uint8_t *units = search->topology.cell_units[cell];
+
+    search->unit_used[units[0]] ^= bit;
+    search->unit_used[units[1]] ^= bit;
+    search->unit_used[units[2]] ^= bit;
+
+    for (int k = 3; k < search->topology.cell_unit_count[cell]; k++)
+    {
+        search->unit_used[units[k]] ^= bit;
+    }
+
+    if (search->combinations == NULL)
+        return;
+
+    int cage = search->topology.cages->cage_of[cell];
+
+    if (cage >= 0)
+    {
+        int value = __builtin_ctz(bit) + 1;
+
+        search->cage_used[cage] ^= bit;
+
+        if (search->cage_used[cage] & bit)
+        {
+            search->cage_sum[cage] = (uint8_t)(search->cage_sum[cage] - value);
+            search->cage_empty[cage]--;
+        }
+        else
+        {
+            search->cage_sum[cage] = (uint8_t)(search->cage_sum[cage] + value);
+            search->cage_empty[cage]++;
+        }
+
+        search->cage_allowed[cage] = cage_combinations(search->combinations, search->cage_empty[cage],
+                                                       search->cage_sum[cage], search->cage_used[cage]);
+    }
+}
+
+/**
+ * Narrow every killer cage to the digit sets its empty cells can still hold
+ * A set survives only if each empty cell can take one of its digits and the
+ * cells together can take all of them; cage_live then holds the union of
+ * the surviving sets, which is usually far smaller than cage_allowed
+ *
+ * Parameters:
+ *   search - search state with cages
+ *
+ * Returns: 0 if some cage has no possible set left, 1 otherwise
+ */
+static int refine_cages(search_t *search)
+{
+    const topology_t *topology = search->topology.cages;
+    const combination_table_t *table = search->combinations;
+
+    for (int c = 0; c < topology->cage_count; c++)
+    {
+        const cage_t *cage = &topology->cages[c];
+        uint16_t masks[GRID_SIZE];
+        int empty = 0;
+        uint16_t live = 0;
+
+        if (search->cage_empty[c] == 0)
+            continue;
+
+        for (int i = 0; i < cage->size; i++)
+        {
+            if (search->values[cage->cells[i]] == 0)
+                masks[empty++] = candidates(search, cage->cells[i]);
+        }
+
+        int size = search->cage_empty[c], sum = search->cage_sum[c];
+
+        for (int k = table->start[size][sum]; k < table->start[size][sum + 1]; k++)
+        {
+            uint16_t set = table->masks[k];
+            uint16_t covered = 0;
+            int i;
+
+            if (set & search->cage_used[c])
+                continue;
+
+            for (i = 0; i < empty && (masks[i] & set); i++)
+                covered |= masks[i] & set;
+
+            if (i == empty && covered == set)
+                live |= set;
+        }
+
+        if (live == 0)
+            return 0;
+
+        search->cage_live[c] = live;
+    }
+
+    return 1;
+}
+
+/**
+ * Describe the cells and units of an 81-cell variant to the engine
+ *
+ * Parameters:
+ *   topology - unit tables of the variant
+ *   layout   - receives the search topology
+ */
+void search_topology_of(const topology_t *topology, search_topology_t *layout)
+{
+    layout->cell_count = SEARCH_CELLS;
+    layout->cell_unit_count = topology->cell_unit_count;
+    layout->cell_units = topology->cell_units;
+    layout->cages = topology->cage_count > 0 ? topology : NULL;
+}
+
+/**
+ * Prepare a search over a puzzle under the active variant
+ *
+ * Parameters:
+ *   search - search state to initialize
+ *   grid   - 9x9 puzzle
+ *
+ * Returns: 1 if ready, 0 if the givens conflict
+ */
+int search_init(search_t *search, int grid[9][9])
+{
+    search_topology_t layout;
+
+    search_topology_of(current_topology(), &layout);
+    return search_init_cells(search, &layout, &grid[0][0]);
+}
+
+/**
+ * Prepare a search over the cells of any layout
+ *
+ * Parameters:
+ *   search - search state to initialize
+ *   layout - cells and units to search
+ *   cells  - one digit per cell (0 = empty)
+ *
+ * Returns: 1 if ready, 0 if the givens conflict
+ */
+int search_init_cells(search_t *search, const search_topology_t *layout, const int *cells)
+{
+    memset(search, 0, sizeof(*search));
+    search->topology = *layout;
+    search->selecting = 1;
+    search->status = SEARCH_RUNNING;
+
+    const topology_t *cages = layout->cages;
+
+    if (cages != NULL)
+        search->combinations = combination_table();
+
+    for (int cage = 0; cages != NULL && cage < cages->cage_count; cage++)
+    {
+        const cage_t *cage_layout = &cages->cages[cage];
+
+        search->cage_sum[cage] = cage_layout->sum;
+        search->cage_empty[cage] = cage_layout->size;
+        search->cage_allowed[cage] = cage_combinations(search->combinations, cage_layout->size,
+                                                       cage_layout->sum, 0);
+    }
+
+    for (int cell = 0; cell < layout->cell_count; cell++)
+    {
+        int value = cells[cell];
+
+        search->values[cell] = (uint8_t)value;
+
+        if (value == 0)
+        {
+            search->empty[search->empty_count++] = (uint16_t)cell;
+            continue;
+        }
+
+        uint16_t bit = (uint16_t)(1u << (value - 1));
+
+        // A given that repeats in one of its units (or breaks its cage) makes
+        // the puzzle unsolvable
+        if (!(candidates(search, cell) & bit))
+        {
+            search->status = SEARCH_EXHAUSTED;
+            return 0;
+        }
+
+        toggle_digit(search, cell, bit);
+    }
+
+    return 1;
+}
+
+/**
+ * Run the search until the next solution, exhaustion, budget or cancellation
+ *
+ * Parameters:
+ *   search    - initialized search state
+ *   max_nodes - maximum digits to place in this call (0 = no limit)
+ *   cancel    - optional cancel flag
+ *
+ * Returns: new search status
+ */
+search_status_t search_run(search_t *search, uint64_t max_nodes, const volatile int *cancel)
+{
+    uint64_t limit = max_nodes ? search->nodes + max_nodes : UINT64_MAX;
+
+    if (search->status == SEARCH_EXHAUSTED)
+        return SEARCH_EXHAUSTED;
+
+    if (search->status == SEARCH_FOUND)
+        search->selecting = 0; // Resume by trying the next digit at the deepest frame
+
+    search->status = SEARCH_RUNNING;
+
+    for (;;)
+    {
+        if (search->selecting)
+        {
+            // Every empty cell is assigned: this is a solution
+            if (search->depth == search->empty_count)
+            {
+                search->status = SEARCH_FOUND;
+                return SEARCH_FOUND;
+            }
+
+            // Choose the unassigned cell with the fewest candidates
+            int best = search->depth;
+            int best_count = 10;
+            uint16_t best_mask = 0;
+            int cages = search->combinations != NULL;
+
+            if (cages && !refine_cages(search))
+                best_count = 0; // A cage cannot be completed: dead end
+
+            for (int i = search->depth; i < search->empty_count && best_count > 0; i++)
+            {
+                int cell = search->empty[i];
+                uint16_t mask = candidates(search, cell);
+
+                if (cages && search->topology.cages->cage_of[cell] >= 0)
+                    mask &= search->cage_live[search->topology.cages->cage_of[cell]];
+
+                int count = __builtin_popcount(mask);
+
+                if (count < best_count)
+                {
+                    best = i;
+                    best_count = count;
+                    best_mask = mask;
+
+                    if (count <= 1)
+                        break; // Cannot do better than a forced or dead cell
+                }
+            }
+
+            search->selecting = 0;
+
+            if (best_count > 0)
+            {
+                uint16_t chosen = search->empty[best];
+
+                search->empty[best] = search->empty[search->depth];
+                search->empty[search->depth] = chosen;
+
+                search_frame_t *frame = &search->stack[search->depth++];
+                frame->cell = chosen;
+                frame->value = 0;
+                frame->remaining = best_mask;
+            }
+            // Zero candidates: dead end, fall through to try the next digit above
+        }
+
+        if (search->depth == 0)
+        {
+            search->status = SEARCH_EXHAUSTED;
+            return SEARCH_EXHAUSTED;
+        }
+
+        search_frame_t *frame = &search->stack[search->depth - 1];
+
+        // Undo the digit tried previously at this depth
+        if (frame->value)
+        {
+            toggle_digit(search, frame->cell, (uint16_t)(1u << (frame->value - 1)));
+            search->values[frame->cell] = 0;
+            frame->value = 0;
+        }
+
+        if (frame->remaining == 0)
+        {
+            search->depth--; // All digits tried - backtrack
+            continue;
+        }
+
+        if (search->nodes >= limit)
+            return SEARCH_RUNNING; // Paused; state is consistent for resuming
+
+        if (cancel != NULL && *cancel)
+        {
+            search->status = SEARCH_CANCELLED;
+            return SEARCH_CANCELLED;
+        }
+
+        // Lowest remaining digit, deferring the preferred-last digit if possible
+        uint16_t pick = frame->remaining;
+
+        if (pick & ~search->last[frame->cell])
+            pick &= (uint16_t)~search->last[frame->cell];
+
+        uint16_t bit = pick & (uint16_t)-pick;
+
+        frame->remaining ^= bit;
+        frame->value = (uint8_t)(__builtin_ctz(bit) + 1);
+        search->values[frame->cell] = frame->value;
+        toggle_digit(search, frame->cell, bit);
+        search->nodes++;
+
+        search->selecting = 1;
+    }
+}
+
+/**
+ * Exclude a digit from an empty cell
+ *
+ * Parameters:
+ *   search - search state
+ *   cell   - cell index
+ *   value  - digit to exclude (1-9)
+ */
+void search_forbid(search_t *search, int cell, int value)
+{
+    search->forbidden[cell] |= (uint16_t)(1u << (value - 1));
+}
+
+/**
+ * Turn a given cell back into an empty cell
+ *
+ * Parameters:
+ *   search - search state (not yet run)
+ *   cell   - cell index of a given cell
+ */
+void search_release(search_t *search, int cell)
+{
+    int value = search->values[cell];
+
+    if (value == 0)
+        return; // Already empty
+
+    toggle_digit(search, cell, (uint16_t)(1u << (value - 1)));
+    search->values[cell] = 0;
+    search->empty[search->empty_count++] = (uint16_t)cell;
+}
+
+/**
+ * Try the digits of a known grid last in every cell
+ *
+ * Parameters:
+ *   search - search state
+ *   known  - 9x9 grid of digits to defer (0 = none)
+ */
+void search_prefer_last(search_t *search, int known[9][9])
+{
+    for (int cell = 0; cell < SEARCH_CELLS; cell++)
+    {
+        int value = known[cell / 9][cell % 9];
+
+        search->last[cell] = value ? (uint16_t)(1u << (value - 1)) : 0;
+    }
+}
+
+/**
+ * Copy the current assignment into a grid
+ *
+ * Parameters:
+ *   search - search state
+ *   grid   - 9x9 array that receives the assignment
+ */
+void search_get_grid(const search_t *search, int grid[9][9])
+{
+    for (int cell = 0; cell < SEARCH_CELLS; cell++)
+    {
+        grid[cell / 9][cell % 9] = search->values[cell];
+    }
+}
+
+/**
+ * Copy the current assignment of any layout into a cell array
+ *
+ * Parameters:
+ *   search - search state
+ *   cells  - receives one digit per cell
+ */
+void search_get_cells(const search_t *search, int *cells)
+{
+    for (int cell = 0; cell < search->topology.cell_count; cell++)
+    {
+        cells[cell] = search->values[cell];
+    }
+}
+
+/**
+ * Give away the untried digits of the shallowest branch point
+ *
+ * Parameters:
+ *   search    - paused search state
+ *   max_depth - only frames shallower than this are considered
+ *   cells     - receives the assignment above the branch point
+ *   cell      - receives the cell of the branch point
+ *   digits    - receives the digits handed off
+ *
+ * Returns: frames above the branch point, or -1 if there is nothing to give
+ */
+int search_hand_off(search_t *search, int max_depth, int *cells, int *cell, uint16_t *digits)
+{
+    int frames = search->depth < max_depth ? search->depth : max_depth;
+
+    for (int i = 0; i < frames; i++)
+    {
+        search_frame_t *frame = &search->stack[i];
+        uint16_t given = frame->remaining;
+
+        // A frame paused before its first digit keeps one digit to go on with
+        if (frame->value == 0)
+            given &= (uint16_t)(given - 1);
+
+        if (given == 0)
+            continue;
+
+        search_get_cells(search, cells);
+
+        for (int j = i; j < search->depth; j++)
+        {
+            cells[search->stack[j].cell] = 0;
+        }
+
+        frame->remaining ^= given;
+        *cell = frame->cell;
+        *digits = given;
+        return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Count the solutions of a grid up to two under one node budget
+ *
+ * Parameters:
+ *   search   - search state to use
+ *   grid     - 9x9 puzzle
+ *   budget   - most digits to place in total
+ *   cancel   - optional cancel flag
+ *   solution - receives the first solution found (may be NULL)
+ *
+ * Returns: solution count class, or why the count stopped
+ */
+search_count_t search_count_to_two(search_t *search, int grid[9][9], uint64_t budget,
+                                   const volatile int *cancel, int solution[9][9])
+{
+    int found = 0;
+
+    if (!search_init(search, grid))
+        return SEARCH_COUNT_INVALID;
+
+    // One budget for both solutions; the second run resumes the first
+    while (found < 2)
+    {
+        search_status_t status = SEARCH_RUNNING;
+
+        if (search->nodes < budget)
+            status = search_run(search, budget - search->nodes, cancel);
+
+        switch (status)
+        {
+            case SEARCH_FOUND:
+                if (found++ == 0 && solution != NULL)
+                    search_get_grid(search, solution);
+                break;
+            case SEARCH_EXHAUSTED:
+                return found == 0 ? SEARCH_COUNT_NONE : SEARCH_COUNT_UNIQUE;
+            case SEARCH_CANCELLED:
+                return SEARCH_COUNT_CANCELLED;
+            default:
+                return SEARCH_COUNT_UNDECIDED;
+        }
+    }
+
+    return SEARCH_COUNT_MULTIPLE;
+}
@@ -1,5 +1,9 @@
 #include "../include/sudoku.h"
 #include "../include/generator.h"
+#include "../include/solver.h"
+#include "../include/search.h"
+#include "../include/unavoidable.h"
+#include "../include/topology.h"
 #include <ncursesw/ncurses.h>
 
 /**
@@ -125,7 +129,8 @@ int solve_grid(int grid[9][9])
 
 /**
  * Check if placing a number at a specific position violates Sudoku rules
- * Validates row, column, and 3x3 box constraints
+ * Validates every unit of the cell (row, column, box and variant extras)
+ * by walking its precomputed peer list, plus the sum of its killer cage
  * 
  * Parameters:
  *   grid - 9x9 Sudoku grid
@@ -137,38 +142,24 @@ int solve_grid(int grid[9][9])
  */
 int is_valid_placement(int grid[9][9], int row, int col, int num)
 {
-    // Check column constraint: no duplicate in same column (excluding current cell)
-    for (int x = 0; x < GRID_SIZE; x++)
-    {
-        if (x != row && grid[x][col] == num)  // Added: x != row
-        {
-            return 0; // Found duplicate in column
-        }
-    }
+    const topology_t *topology = current_topology();
+    int cell = row * 9 + col;
+    const uint8_t *peer = topology->peers[cell];
+    const uint8_t *end = peer + topology->peer_count[cell];
+    const int *cells = &grid[0][0];
 
-    // Check row constraint: no duplicate in same row (excluding current cell)
-    for (int y = 0; y < GRID_SIZE; y++)
+    // Peers exclude the cell itself, so its current value is never a conflict
+    for (; peer < end; peer++)
     {
-        if (y != col && grid[row][y] == num)  // Added: y != col
+        if (cells[*peer] == num)
         {
-            return 0; // Found duplicate in row
+            return 0; // Found duplicate in a shared unit
         }
     }
 
-    // Check 3x3 box constraint: no duplicate in same box (excluding current cell)
-    int start_row = (row / 3) * 3; // Top-left corner of box
-    int start_col = (col / 3) * 3; // Top-left corner of box
-
-    for (int x = start_row; x < start_row + BOX_SIZE; x++)
-    {
-        for (int y = start_col; y < start_col + BOX_SIZE; y++)
-        {
-            if ((x != row || y != col) && grid[x][y] == num)  // Added: (x != row || y != col)
-            {
-                return 0; // Found duplicate in 3x3 box
-            }
-        }
-    }
+    // Killer cages: cage mates are peers, so only the sum is left to check
+    if (topology->cage_count > 0 && !cage_sum_allows(topology, cells, cell, num))
+        return 0;
 
     return 1; // All constraints satisfied - valid placement
 }
@@ -224,59 +215,456 @@ int count_solutions(int grid[9][9])
 }
 
 /**
- * Validate if the current state of a Sudoku grid is legal
- * Checks all filled cells for rule violations
- * Does NOT require the grid to be complete
+ * Look for a solution that differs from a known one
+ * The known digit is tried last in every cell, so the known solution is the
+ * final leaf of the search tree: finding it first proves uniqueness
  * 
  * Parameters:
- *   grid - 9x9 Sudoku grid to validate
+ *   grid     - 9x9 puzzle (not modified)
+ *   solution - 9x9 known solution
+ *   other    - receives the different solution, or NULL
  * 
- * Returns: 1 if current state is valid, 0 if rules are violated
+ * Returns: 1 if a different solution exists, 0 if unique
  */
-int is_grid_valid(int grid[9][9])
+int find_other_solution(int grid[9][9], int solution[9][9], int other[9][9])
 {
-    // Check every filled cell for violations
-    for (int x = 0; x < GRID_SIZE; x++)
+    return find_other_solution_limited(grid, solution, other, 0);
+}
+
+/**
+ * Look for a different solution within a node budget
+ * 
+ * Parameters:
+ *   grid      - 9x9 puzzle (not modified)
+ *   solution  - 9x9 known solution
+ *   other     - receives the different solution, or NULL
+ *   max_nodes - search budget (0 = no limit)
+ * 
+ * Returns: 1 if a different solution exists, 0 if unique, -1 if undecided
+ */
+int find_other_solution_limited(int grid[9][9], int solution[9][9], int other[9][9],
+                                uint64_t max_nodes)
+{
+    search_t search;
+    int found[9][9];
+
+    if (!search_init(&search, grid))
+        return 0;
+
+    search_prefer_last(&search, solution);
+
+    search_status_t status = search_run(&search, max_nodes, NULL);
+
+    if (status == SEARCH_RUNNING)
+        return -1; // Budget spent before an answer
+
+    if (status != SEARCH_FOUND)
+        return 0; // Not even the known solution: treat as no alternative
+
+    search_get_grid(&search, found);
+
+    if (memcmp(found, solution, sizeof(found)) == 0)
+        return 0; // Known solution came first - nothing else exists
+
+    if (other != NULL)
+        memcpy(other, found, sizeof(found));
+
+    return 1;
+}
+
+/**
+ * Check uniqueness after emptying one cell of a unique puzzle
+ * 
+ * Parameters:
+ *   grid     - 9x9 puzzle with the cell already emptied
+ *   solution - 9x9 known solution
+ *   row      - emptied row
+ *   col      - emptied column
+ * 
+ * Returns: 1 if still unique, 0 otherwise
+ */
+int is_unique_without_cell(int grid[9][9], int solution[9][9], int row, int col)
+{
+    int cell = row * 9 + col;
+
+    return is_unique_without_cells(grid, solution, &cell, 1);
+}
+
+/**
+ * Check uniqueness after emptying a group of cells of a unique puzzle
+ * 
+ * Parameters:
+ *   grid     - 9x9 puzzle with the cells already emptied
+ *   solution - 9x9 known solution
+ *   cells    - emptied cell indices (row * 9 + col)
+ *   count    - number of emptied cells
+ * 
+ * Returns: 1 if still unique, 0 otherwise
+ */
+int is_unique_without_cells(int grid[9][9], int solution[9][9], const int *cells, int count)
+{
+    search_t base;
+    search_t probe;
+    int puzzle[9][9];
+
+    // Start from the unique puzzle before the removal
+    memcpy(puzzle, grid, sizeof(puzzle));
+
+    for (int i = 0; i < count; i++)
     {
-        for (int y = 0; y < GRID_SIZE; y++)
+        puzzle[cells[i] / 9][cells[i] % 9] = solution[cells[i] / 9][cells[i] % 9];
+    }
+
+    if (!search_init(&base, puzzle))
+        return 0;
+
+    // A new solution differs from the known one in some emptied cell; split by
+    // the first such cell k: cells before k keep their digit, cell k does not
+    for (int k = 0; k < count; k++)
+    {
+        memcpy(&probe, &base, sizeof(probe));
+
+        for (int i = k; i < count; i++)
+        {
+            search_release(&probe, cells[i]);
+        }
+
+        search_forbid(&probe, cells[k], solution[cells[k] / 9][cells[k] % 9]);
+
+        if (search_run(&probe, 0, NULL) == SEARCH_FOUND)
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Check every clue for redundancy using one shared search state
+ * 
+ * Parameters:
+ *   grid          - 9x9 unique puzzle
+ *   solution      - 9x9 solution
+ *   redundant     - receives 1 for removable clues (may be NULL)
+ *   stop_at_first - stop after the first redundant clue
+ * 
+ * Returns: number of redundant clues found
+ */
+static int check_clues(int grid[9][9], int solution[9][9], int redundant[9][9], int stop_at_first)
+{
+    search_t base;
+    search_t probe;
+    unavoidable_sets_t sets;
+    int count = 0;
+
+    if (redundant != NULL)
+        memset(redundant, 0, sizeof(int[9][9]));
+
+    if (!search_init(&base, grid))
+        return 0;
+
+    // A clue that alone hits an unavoidable set is necessary without a search
+    cellmask_t clues = cellmask_from_grid(grid);
+
+    find_unavoidable_sets(solution, 2, UNAVOIDABLE_MAX_SIZE, &sets);
+    cellmask_t necessary = unavoidable_necessary(&sets, &clues);
+
+    for (int cell = 0; cell < SEARCH_CELLS; cell++)
+    {
+        int row = cell / 9;
+        int col = cell % 9;
+
+        if (grid[row][col] == 0 || cellmask_test(&necessary, cell))
+            continue;
+
+        // Clue is necessary iff some solution differs from the known one here
+        memcpy(&probe, &base, sizeof(probe));
+        search_release(&probe, cell);
+        search_forbid(&probe, cell, solution[row][col]);
+
+        if (search_run(&probe, 0, NULL) != SEARCH_FOUND)
+        {
+            count++;
+
+            if (redundant != NULL)
+                redundant[row][col] = 1;
+
+            if (stop_at_first)
+                break;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Find the clues that could be removed without losing uniqueness
+ * 
+ * Parameters:
+ *   grid      - 9x9 unique puzzle
+ *   solution  - 9x9 solution
+ *   redundant - receives 1 for removable clues (may be NULL)
+ * 
+ * Returns: number of redundant clues
+ */
+int find_redundant_clues(int grid[9][9], int solution[9][9], int redundant[9][9])
+{
+    return check_clues(grid, solution, redundant, 0);
+}
+
+/**
+ * Check that every clue of a unique puzzle is necessary
+ * 
+ * Parameters:
+ *   grid     - 9x9 unique puzzle
+ *   solution - 9x9 solution
+ * 
+ * Returns: 1 if minimal, 0 otherwise
+ */
+int is_minimal_puzzle(int grid[9][9], int solution[9][9])
+{
+    return check_clues(grid, solution, NULL, 1) == 0;
+}
+
+/**
+ * Enumerate the solutions of a grid, invoking a callback for each one
+ * Uses the iterative search engine so memory stays constant
+ * 
+ * Parameters:
+ *   grid      - 9x9 Sudoku grid to analyze (not modified)
+ *   limit     - maximum solutions to visit (0 or negative = no limit)
+ *   callback  - function called per solution, or NULL
+ *   user_data - pointer passed to the callback
+ *   cancel    - optional cancel flag
+ * 
+ * Returns: number of solutions visited
+ */
+long enumerate_solutions(int grid[9][9], long limit, solution_callback_t callback,
+                         void *user_data, const volatile int *cancel)
+{
+    search_t search;
+    int solution[9][9];
+    long found = 0;
+
+    if (!search_init(&search, grid))
+        return 0; // Conflicting givens - no solutions
+
+    while ((limit <= 0 || found < limit) && search_run(&search, 0, cancel) == SEARCH_FOUND)
+    {
+        found++;
+
+        if (callback != NULL)
+        {
+            search_get_grid(&search, solution);
+
+            if (!callback(solution, user_data))
+                break; // Caller asked to stop
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Count solutions up to a caller-chosen limit
+ * 
+ * Parameters:
+ *   grid  - 9x9 Sudoku grid to analyze (not modified)
+ *   limit - stop once this many solutions are found (0 = no limit)
+ * 
+ * Returns: number of solutions found
+ */
+long count_solutions_limit(int grid[9][9], long limit)
+{
+    return enumerate_solutions(grid, limit, NULL, NULL, NULL);
+}
+
+/**
+ * Place naked and hidden singles until none remain
+ * Hidden singles are searched only when no naked single is left
+ *
+ * Parameters:
+ *   grid        - 9x9 grid, filled in place
+ *   used_hidden - receives 1 if a hidden single was needed
+ *
+ * Returns: number of cells still empty
+ */
+static int place_singles(int grid[9][9], int *used_hidden)
+{
+    const topology_t *topology = current_topology();
+    int *cells = &grid[0][0];
+    int empty = 0;
+
+    for (int cell = 0; cell < 81; cell++)
+        empty += cells[cell] == 0;
+
+    *used_hidden = 0;
+
+    while (empty > 0)
+    {
+        int placed = 0;
+
+        // Naked singles: an empty cell with one candidate
+        for (int cell = 0; cell < 81; cell++)
         {
-            if (grid[x][y] == 0) // Skip empty cells
+            int count = 0, last = 0;
+
+            if (cells[cell] != 0)
                 continue;
 
-            // Check for duplicates in the same row
-            for (int col_idx = 0; col_idx < GRID_SIZE; col_idx++)
+            for (int num = 1; num <= GRID_SIZE && count < 2; num++)
             {
-                if (col_idx != y && grid[x][col_idx] == grid[x][y])
+                if (is_valid_placement(grid, cell / 9, cell % 9, num))
                 {
-                    return 0; // Duplicate found in row
+                    count++;
+                    last = num;
                 }
             }
 
-            // Check for duplicates in the same column
-            for (int row_idx = 0; row_idx < GRID_SIZE; row_idx++)
+            if (count == 1)
             {
-                if (row_idx != x && grid[row_idx][y] == grid[x][y])
-                {
-                    return 0; // Duplicate found in column
-                }
+                cells[cell] = last;
+                empty--;
+                placed++;
             }
+        }
 
-            // Check for duplicates in the same 3x3 box
-            int start_row = (x / 3) * 3;
-            int start_col = (y / 3) * 3;
+        if (placed)
+            continue;
 
-            for (int box_row = start_row; box_row < start_row + BOX_SIZE; box_row++)
+        // Hidden singles: a digit with one place left in a unit
+        for (int unit = 0; unit < topology->unit_count && !placed; unit++)
+        {
+            for (int num = 1; num <= GRID_SIZE && !placed; num++)
             {
-                for (int box_col = start_col; box_col < start_col + BOX_SIZE; box_col++)
+                int count = 0, where = -1;
+
+                for (int i = 0; i < GRID_SIZE && count < 2; i++)
                 {
-                    // Skip the cell we're currently checking
-                    if ((box_row != x || box_col != y) && grid[box_row][box_col] == grid[x][y])
+                    int cell = topology->units[unit][i];
+
+                    if (cells[cell] == num)
                     {
-                        return 0; // Duplicate found in 3x3 box
+                        count = 2; // Already placed in this unit
                     }
+                    else if (cells[cell] == 0 && is_valid_placement(grid, cell / 9, cell % 9, num))
+                    {
+                        count++;
+                        where = cell;
+                    }
+                }
+
+                if (count == 1)
+                {
+                    cells[where] = num;
+                    empty--;
+                    placed = 1;
+                    *used_hidden = 1;
                 }
             }
         }
+
+        if (!placed)
+            break; // Singles are stuck
+    }
+
+    return empty;
+}
+
+/**
+ * Rate a puzzle by what it takes to solve
+ *
+ * Parameters:
+ *   grid         - 9x9 puzzle with a unique solution (not modified)
+ *   search_nodes - receives the digits the search placed (may be NULL)
+ *
+ * Returns: rating on the generator's difficulty scale
+ */
+difficulty_t rate_puzzle(int grid[9][9], uint64_t *search_nodes)
+{
+    int work[9][9];
+    int used_hidden;
+    search_t search;
+
+    memcpy(work, grid, sizeof(work));
+
+    if (search_nodes != NULL)
+        *search_nodes = 0;
+
+    if (place_singles(work, &used_hidden) == 0)
+        return used_hidden ? MEDIUM : EASY;
+
+    // Guessing needed: measure the search on what the singles left
+    if (!search_init(&search, work))
+        return EXPERT;
+
+    search_status_t status = search_run(&search, RATING_SEARCH_NODES, NULL);
+
+    if (search_nodes != NULL)
+        *search_nodes = search.nodes;
+
+    return status == SEARCH_FOUND && search.nodes <= RATING_HARD_NODES ? HARD : EXPERT;
+}
+
+/**
+ * Validate if the current state of a Sudoku grid is legal
+ * Checks all filled cells for rule violations
+ * Does NOT require the grid to be complete
+ * 
+ * Parameters:
+ *   grid - 9x9 Sudoku grid to validate
+ * 
+ * Returns: 1 if current state is valid, 0 if rules are violated
+ */
+int is_grid_valid(int grid[9][9])
+{
+    const topology_t *topology = current_topology();
+    const int *cells = &grid[0][0];
+
+    // One pass per unit, tracking seen digits as a bitmask
+    for (int unit = 0; unit < topology->unit_count; unit++)
+    {
+        uint16_t seen = 0;
+
+        for (int i = 0; i < GRID_SIZE; i++)
+        {
+            int value = cells[topology->units[unit][i]];
+
+            if (value == 0) // Skip empty cells
+                continue;
+
+            if (value < 1 || value > 9 || (seen & (1u << value)))
+            {
+                return 0; // Duplicate (or out-of-range digit) found in unit
+            }
+
+            seen |= (uint16_t)(1u << value);
+        }
+    }
+
+    // Killer cages: no repeats, no overshoot, exact sum once full
+    for (int c = 0; c < topology->cage_count; c++)
+    {
+        const cage_t *cage = &topology->cages[c];
+        uint16_t seen = 0;
+        int sum = 0, filled = 0;
+
+        for (int i = 0; i < cage->size; i++)
+        {
+            int value = cells[cage->cells[i]];
+
+            if (value == 0)
+                continue;
+
+            if (seen & (1u << value))
+                return 0;
+
+            seen |= (uint16_t)(1u << value);
+            sum += value;
+            filled++;
+        }
+
+        if (sum > cage->sum || (filled == cage->size && sum != cage->sum))
+            return 0;
     }
 
     return 1; // No violations found - grid state is valid
@@ -0,0 +1,516 @@
+#include "../include/sudoku.h"
+#include "../include/topology.h"
+#include <pthread.h>
+
+static topology_t topologies[VARIANT_COUNT];
+static pthread_once_t topologies_built = PTHREAD_ONCE_INIT;
+static variant_t active_variant = VARIANT_CLASSIC;
+static const topology_t *active_topology;      // Cached get_topology(active_variant)
+static __thread const topology_t *thread_topology; // Per-thread override (NULL = none)
+
+static const char *variant_names[VARIANT_COUNT] = {"classic", "x", "windoku", "jigsaw", "killer",
+                                                  "samurai"};
+
+/**
+ * Append a unit to a topology
+ *
+ * Parameters:
+ *   topology - tables being built
+ *   kind     - what the unit is
+ *   cells    - the 9 cell indices of the unit
+ */
+static void add_unit(topology_t *topology, unit_kind_t kind, const int cells[GRID_SIZE])
+{
+    int unit = topology->unit_count++;
+
+    topology->kinds[unit] = kind;
+
+    for (int i = 0; i < GRID_SIZE; i++)
+    {
+        int cell = cells[i];
+
+        topology->units[unit][i] = (uint8_t)cell;
+        topology->cell_units[cell][topology->cell_unit_count[cell]++] = (uint8_t)unit;
+    }
+}
+
+/**
+ * Build the unit, cell-unit and peer tables of one variant
+ *
+ * Parameters:
+ *   topology - tables to fill
+ *   variant  - rule set
+ *   regions  - region (0-8) of each cell replacing the boxes, or NULL for boxes
+ *   cages    - killer cages, or NULL for none
+ */
+static void build_topology(topology_t *topology, variant_t variant, const uint8_t *regions,
+                           const cage_layout_t *cages)
+{
+    int cells[GRID_SIZE];
+
+    memset(topology, 0, sizeof(*topology));
+    topology->variant = variant;
+    memset(topology->cage_of, -1, sizeof(topology->cage_of));
+
+    if (cages != NULL)
+    {
+        topology->cage_count = cages->count;
+        memcpy(topology->cages, cages->cages, sizeof(cage_t) * (size_t)cages->count);
+
+        for (int cage = 0; cage < cages->count; cage++)
+        {
+            for (int i = 0; i < cages->cages[cage].size; i++)
+                topology->cage_of[cages->cages[cage].cells[i]] = (int8_t)cage;
+        }
+    }
+
+    for (int row = 0; row < GRID_SIZE; row++)
+    {
+        for (int i = 0; i < GRID_SIZE; i++)
+            cells[i] = row * 9 + i;
+
+        add_unit(topology, UNIT_ROW, cells);
+    }
+
+    for (int col = 0; col < GRID_SIZE; col++)
+    {
+        for (int i = 0; i < GRID_SIZE; i++)
+            cells[i] = i * 9 + col;
+
+        add_unit(topology, UNIT_COLUMN, cells);
+    }
+
+    for (int box = 0; box < GRID_SIZE; box++)
+    {
+        int count = 0;
+
+        if (regions == NULL)
+        {
+            for (int i = 0; i < GRID_SIZE; i++)
+                cells[i] = ((box / 3) * 3 + i / 3) * 9 + (box % 3) * 3 + i % 3;
+        }
+        else
+        {
+            // Jigsaw regions take the place of the boxes, in cell order
+            for (int cell = 0; cell < TOPOLOGY_CELLS && count < GRID_SIZE; cell++)
+            {
+                if (regions[cell] == box)
+                    cells[count++] = cell;
+            }
+        }
+
+        add_unit(topology, UNIT_BOX, cells);
+    }
+
+    if (variant == VARIANT_X)
+    {
+        topology->name = "X-Sudoku";
+
+        for (int i = 0; i < GRID_SIZE; i++)
+            cells[i] = i * 9 + i;
+
+        add_unit(topology, UNIT_DIAGONAL, cells);
+
+        for (int i = 0; i < GRID_SIZE; i++)
+            cells[i] = i * 9 + (8 - i);
+
+        add_unit(topology, UNIT_DIAGONAL, cells);
+    }
+    else if (variant == VARIANT_WINDOKU)
+    {
+        topology->name = "Windoku";
+
+        for (int window = 0; window < 4; window++)
+        {
+            int top = 1 + (window / 2) * 4;
+            int left = 1 + (window % 2) * 4;
+
+            for (int i = 0; i < GRID_SIZE; i++)
+                cells[i] = (top + i / 3) * 9 + left + i % 3;
+
+            add_unit(topology, UNIT_WINDOW, cells);
+        }
+    }
+    else if (variant == VARIANT_JIGSAW)
+    {
+        topology->name = "Jigsaw";
+    }
+    else if (variant == VARIANT_KILLER)
+    {
+        topology->name = "Killer";
+    }
+    else if (variant == VARIANT_SAMURAI)
+    {
+        // Each of the five grids follows the classic rules; the layout
+        // joining them lives in samurai.h
+        topology->name = "Samurai";
+    }
+    else
+    {
+        topology->name = "Classic";
+    }
+
+    // Peers: every other cell of every unit (and cage) containing the cell, once each
+    for (int cell = 0; cell < TOPOLOGY_CELLS; cell++)
+    {
+        uint8_t seen[TOPOLOGY_CELLS] = {0};
+
+        seen[cell] = 1;
+
+        if (topology->cage_of[cell] >= 0)
+        {
+            const cage_t *cage = &topology->cages[topology->cage_of[cell]];
+
+            for (int i = 0; i < cage->size; i++)
+            {
+                if (!seen[cage->cells[i]])
+                {
+                    seen[cage->cells[i]] = 1;
+                    topology->peers[cell][topology->peer_count[cell]++] = cage->cells[i];
+                }
+            }
+        }
+
+        for (int k = 0; k < topology->cell_unit_count[cell]; k++)
+        {
+            const uint8_t *unit = topology->units[topology->cell_units[cell][k]];
+
+            for (int i = 0; i < GRID_SIZE; i++)
+            {
+                if (!seen[unit[i]])
+                {
+                    seen[unit[i]] = 1;
+                    topology->peers[cell][topology->peer_count[cell]++] = unit[i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Build the tables of every variant (run once)
+ */
+static void build_all_topologies(void)
+{
+    for (int variant = 0; variant < VARIANT_COUNT; variant++)
+    {
+        // Jigsaw starts with the plain boxes until set_current_regions()
+        build_topology(&topologies[variant], (variant_t)variant, NULL, NULL);
+    }
+}
+
+/**
+ * Get the unit tables of a variant
+ *
+ * Parameters:
+ *   variant - rule set
+ *
+ * Returns: read-only tables
+ */
+const topology_t *get_topology(variant_t variant)
+{
+    pthread_once(&topologies_built, build_all_topologies);
+
+    return &topologies[variant];
+}
+
+/**
+ * Get the tables of the active variant
+ *
+ * Returns: read-only tables
+ */
+const topology_t *current_topology(void)
+{
+    const topology_t *topology = thread_topology ? thread_topology : active_topology;
+
+    // Rule checks call this per placement; skip pthread_once once selected
+    return topology != NULL ? topology : get_topology(active_variant);
+}
+
+/**
+ * Select the variant used by the rule checks, solver and generator
+ *
+ * Parameters:
+ *   variant - rule set to activate
+ */
+void set_current_variant(variant_t variant)
+{
+    active_variant = variant;
+    active_topology = get_topology(variant);
+}
+
+/**
+ * Parse a variant name
+ *
+ * Parameters:
+ *   name    - variant name
+ *   variant - receives the parsed variant
+ *
+ * Returns: 1 if recognized, 0 otherwise
+ */
+int parse_variant(const char *name, variant_t *variant)
+{
+    for (int i = 0; i < VARIANT_COUNT; i++)
+    {
+        if (strcmp(name, variant_names[i]) == 0)
+        {
+            *variant = (variant_t)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Check whether a cell belongs to a variant's extra units
+ *
+ * Parameters:
+ *   topology - unit tables
+ *   cell     - cell index
+ *
+ * Returns: 1 if on a diagonal or in a window, 0 otherwise
+ */
+int in_extra_unit(const topology_t *topology, int cell)
+{
+    return topology->cell_unit_count[cell] > 3;
+}
+
+/**
+ * Check whether the cells of one region form a single orthogonal group
+ *
+ * Parameters:
+ *   regions - region (0-8) of each cell
+ *   region  - region to check
+ *
+ * Returns: 1 if connected, 0 if split or empty
+ */
+int region_connected(const uint8_t regions[TOPOLOGY_CELLS], int region)
+{
+    uint8_t stack[TOPOLOGY_CELLS];
+    uint8_t seen[TOPOLOGY_CELLS] = {0};
+    int top = 0, size = 0, reached = 0;
+
+    for (int cell = 0; cell < TOPOLOGY_CELLS; cell++)
+    {
+        if (regions[cell] != region)
+            continue;
+
+        if (size++ == 0)
+        {
+            stack[top++] = (uint8_t)cell;
+            seen[cell] = 1;
+        }
+    }
+
+    // Flood fill from the first cell through same-region neighbours
+    while (top > 0)
+    {
+        int cell = stack[--top];
+        int row = cell / 9, col = cell % 9;
+        int neighbours[4] = {row > 0 ? cell - 9 : -1, row < 8 ? cell + 9 : -1,
+                             col > 0 ? cell - 1 : -1, col < 8 ? cell + 1 : -1};
+
+        reached++;
+
+        for (int i = 0; i < 4; i++)
+        {
+            int next = neighbours[i];
+
+            if (next >= 0 && !seen[next] && regions[next] == region)
+            {
+                seen[next] = 1;
+                stack[top++] = (uint8_t)next;
+            }
+        }
+    }
+
+    return size > 0 && reached == size;
+}
+
+/**
+ * Check that a region map splits the grid into nine connected regions of nine
+ *
+ * Parameters:
+ *   regions - region (0-8) of each cell
+ *
+ * Returns: 1 if usable as a jigsaw layout, 0 otherwise
+ */
+int regions_valid(const uint8_t regions[TOPOLOGY_CELLS])
+{
+    int sizes[GRID_SIZE] = {0};
+
+    for (int cell = 0; cell < TOPOLOGY_CELLS; cell++)
+    {
+        if (regions[cell] >= GRID_SIZE)
+            return 0;
+
+        sizes[regions[cell]]++;
+    }
+
+    for (int region = 0; region < GRID_SIZE; region++)
+    {
+        if (sizes[region] != GRID_SIZE || !region_connected(regions, region))
+            return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Build jigsaw tables for a region map
+ *
+ * Parameters:
+ *   topology - tables to fill
+ *   regions  - valid region map (see regions_valid())
+ */
+void build_region_topology(topology_t *topology, const uint8_t regions[TOPOLOGY_CELLS])
+{
+    build_topology(topology, VARIANT_JIGSAW, regions, NULL);
+}
+
+/**
+ * Install a jigsaw layout and make jigsaw the active variant
+ *
+ * Parameters:
+ *   regions - valid region map
+ */
+void set_current_regions(const uint8_t regions[TOPOLOGY_CELLS])
+{
+    pthread_once(&topologies_built, build_all_topologies);
+
+    build_topology(&topologies[VARIANT_JIGSAW], VARIANT_JIGSAW, regions, NULL);
+    set_current_variant(VARIANT_JIGSAW);
+}
+
+/**
+ * Check that cages cover every cell once and that every sum is reachable
+ *
+ * Parameters:
+ *   cages - killer cages
+ *
+ * Returns: 1 if usable as a killer layout, 0 otherwise
+ */
+int cages_valid(const cage_layout_t *cages)
+{
+    uint8_t covered[TOPOLOGY_CELLS] = {0};
+    int total = 0;
+
+    if (cages->count < 1 || cages->count > TOPOLOGY_MAX_CAGES)
+        return 0;
+
+    for (int c = 0; c < cages->count; c++)
+    {
+        const cage_t *cage = &cages->cages[c];
+        int size = cage->size;
+
+        // Smallest and largest sums of distinct digits in a cage of this size
+        if (size < 1 || size > GRID_SIZE || cage->sum < size * (size + 1) / 2 ||
+            cage->sum > size * (19 - size) / 2)
+            return 0;
+
+        for (int i = 0; i < size; i++)
+        {
+            if (cage->cells[i] >= TOPOLOGY_CELLS || covered[cage->cells[i]]++)
+                return 0;
+        }
+
+        total += size;
+    }
+
+    return total == TOPOLOGY_CELLS;
+}
+
+/**
+ * Build killer tables for a cage layout
+ *
+ * Parameters:
+ *   topology - tables to fill
+ *   cages    - valid cage layout (see cages_valid())
+ */
+void build_cage_topology(topology_t *topology, const cage_layout_t *cages)
+{
+    build_topology(topology, VARIANT_KILLER, NULL, cages);
+}
+
+/**
+ * Install a killer cage layout and make killer the active variant
+ *
+ * Parameters:
+ *   cages - valid cage layout
+ */
+void set_current_cages(const cage_layout_t *cages)
+{
+    pthread_once(&topologies_built, build_all_topologies);
+
+    build_topology(&topologies[VARIANT_KILLER], VARIANT_KILLER, NULL, cages);
+    set_current_variant(VARIANT_KILLER);
+}
+
+/**
+ * Check a digit against the sum of the cell's killer cage
+ * The digit may not push the cage past its sum, and must complete the sum
+ * exactly when it fills the last empty cell
+ *
+ * Parameters:
+ *   topology - unit tables
+ *   cells    - the 81 cells of the grid
+ *   cell     - cell index
+ *   num      - digit to check (1-9)
+ *
+ * Returns: 1 if the cage sum still works out, 0 otherwise
+ */
+int cage_sum_allows(const topology_t *topology, const int *cells, int cell, int num)
+{
+    if (topology->cage_of[cell] < 0)
+        return 1;
+
+    const cage_t *cage = &topology->cages[topology->cage_of[cell]];
+    int sum = num, empty = 0;
+
+    for (int i = 0; i < cage->size; i++)
+    {
+        int other = cage->cells[i];
+
+        if (other == cell)
+            continue;
+
+        if (cells[other])
+            sum += cells[other];
+        else
+            empty++;
+    }
+
+    return empty == 0 ? sum == cage->sum : sum < cage->sum;
+}
+
+/**
+ * Make the calling thread use its own tables instead of the active variant
+ *
+ * Parameters:
+ *   topology - tables for this thread, or NULL to follow the active variant
+ *
+ * Returns: the previous tables of this thread, so callers can restore them
+ */
+const topology_t *use_thread_topology(const topology_t *topology)
+{
+    const topology_t *previous = thread_topology;
+
+    thread_topology = topology;
+    return previous;
+}
+
+/**
+ * Copy the box or jigsaw region of every cell into a map
+ *
+ * Parameters:
+ *   topology - unit tables
+ *   regions  - receives the region (0-8) of each cell
+ */
+void topology_regions(const topology_t *topology, uint8_t regions[TOPOLOGY_CELLS])
+{
+    for (int cell = 0; cell < TOPOLOGY_CELLS; cell++)
+    {
+        regions[cell] = (uint8_t)region_of(topology, cell);
+    }
+}
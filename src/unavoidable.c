@@ -0,0 +1,353 @@
+#include "../include/sudoku.h"
+#include "../include/unavoidable.h"
+#include "../include/solver.h"
+#include "../include/topology.h"
+
+typedef struct
+{
+    int (*solution)[9];         // Grid whose sets are collected
+    int max_size;               // Largest set kept
+    unavoidable_sets_t *sets;   // Output
+} collect_state_t;
+
+/**
+ * Build the mask of the non-empty cells of a grid
+ *
+ * Parameters:
+ *   grid - 9x9 grid
+ *
+ * Returns: mask with one bit per filled cell
+ */
+cellmask_t cellmask_from_grid(int grid[9][9])
+{
+    cellmask_t mask = {{0, 0}};
+
+    for (int cell = 0; cell < 81; cell++)
+    {
+        if (grid[cell / 9][cell % 9])
+            cellmask_set(&mask, cell);
+    }
+
+    return mask;
+}
+
+/**
+ * Add a set unless a stored set is inside it; drop stored sets containing it
+ *
+ * Parameters:
+ *   sets - set collection
+ *   set  - new unavoidable set
+ */
+void unavoidable_add(unavoidable_sets_t *sets, const cellmask_t *set)
+{
+    int kept = 0;
+
+    for (int i = 0; i < sets->count; i++)
+    {
+        if (cellmask_subset(&sets->sets[i], set))
+            return; // Already implied by a smaller (or equal) set
+    }
+
+    // Remove supersets of the new set; they add nothing once it is stored
+    for (int i = 0; i < sets->count; i++)
+    {
+        if (!cellmask_subset(set, &sets->sets[i]))
+            sets->sets[kept++] = sets->sets[i];
+    }
+
+    sets->count = kept;
+
+    if (sets->count < UNAVOIDABLE_MAX_SETS)
+        sets->sets[sets->count++] = *set;
+}
+
+/**
+ * Enumeration callback: record where an alternative grid differs
+ *
+ * Parameters:
+ *   other     - alternative solution
+ *   user_data - collect_state_t
+ *
+ * Returns: 1 to keep enumerating
+ */
+static int collect_difference(int other[9][9], void *user_data)
+{
+    collect_state_t *state = user_data;
+    cellmask_t diff = {{0, 0}};
+    int size = 0;
+
+    for (int cell = 0; cell < 81 && size <= state->max_size; cell++)
+    {
+        if (other[cell / 9][cell % 9] != state->solution[cell / 9][cell % 9])
+        {
+            cellmask_set(&diff, cell);
+            size++;
+        }
+    }
+
+    // The known solution itself differs nowhere
+    if (size >= UNAVOIDABLE_MIN_SIZE && size <= state->max_size)
+        unavoidable_add(state->sets, &diff);
+
+    return 1;
+}
+
+/**
+ * Collect the unavoidable sets formed by swapping two digits
+ * Exchanging a and b in a set of rows keeps the columns valid exactly when
+ * the rows are a union of cycles of "row whose b sits in this row's a
+ * column", and keeps the boxes (or jigsaw regions) valid when both digits
+ * cover the same ones, so only unions of the (few) cycles are tested, with
+ * masks and no search.
+ * A variant unit (diagonal, window) stays valid when its a and b cells are
+ * both swapped or both kept; so does a killer cage's sum, and a cage
+ * holding only one of the digits must not be touched at all
+ *
+ * Parameters:
+ *   solution - complete valid grid
+ *   a        - first digit (1-9)
+ *   b        - second digit (1-9)
+ *   max_size - largest set size to keep
+ *   sets     - set collection
+ */
+static void collect_digit_pair(int solution[9][9], int a, int b, int max_size,
+                               unavoidable_sets_t *sets)
+{
+    const topology_t *topology = current_topology();
+    int col_a[9], col_b[9], row_of_b[9];
+    uint16_t extra_a[TOPOLOGY_MAX_UNITS], extra_b[TOPOLOGY_MAX_UNITS];
+    uint16_t cage_a[TOPOLOGY_MAX_CAGES] = {0}, cage_b[TOPOLOGY_MAX_CAGES] = {0};
+    uint16_t cycles[9];
+    int cycle_count = 0;
+    uint16_t seen = 0;
+
+    for (int row = 0; row < 9; row++)
+    {
+        for (int col = 0; col < 9; col++)
+        {
+            if (solution[row][col] == a)
+                col_a[row] = col;
+            else if (solution[row][col] == b)
+                col_b[row] = col;
+        }
+
+        row_of_b[col_b[row]] = row;
+    }
+
+    // Rows holding a and b inside each variant unit
+    for (int unit = TOPOLOGY_CLASSIC_UNITS; unit < topology->unit_count; unit++)
+    {
+        for (int i = 0; i < GRID_SIZE; i++)
+        {
+            int cell = topology->units[unit][i];
+
+            if (solution[cell / 9][cell % 9] == a)
+                extra_a[unit] = (uint16_t)(1u << (cell / 9));
+            else if (solution[cell / 9][cell % 9] == b)
+                extra_b[unit] = (uint16_t)(1u << (cell / 9));
+        }
+    }
+
+    // Rows holding a and b inside each killer cage (0 = digit absent)
+    for (int c = 0; c < topology->cage_count; c++)
+    {
+        for (int i = 0; i < topology->cages[c].size; i++)
+        {
+            int cell = topology->cages[c].cells[i];
+
+            if (solution[cell / 9][cell % 9] == a)
+                cage_a[c] = (uint16_t)(1u << (cell / 9));
+            else if (solution[cell / 9][cell % 9] == b)
+                cage_b[c] = (uint16_t)(1u << (cell / 9));
+        }
+    }
+
+    // Split the rows into cycles of the column-matching permutation
+    for (int row = 0; row < 9; row++)
+    {
+        if (seen & (1u << row))
+            continue;
+
+        uint16_t cycle = 0;
+
+        for (int r = row; !(cycle & (1u << r)); r = row_of_b[col_a[r]])
+        {
+            cycle |= (uint16_t)(1u << r);
+        }
+
+        seen |= cycle;
+        cycles[cycle_count++] = cycle;
+    }
+
+    for (int pick = 1; pick < (1 << cycle_count); pick++)
+    {
+        uint16_t rows = 0, boxes_a = 0, boxes_b = 0;
+
+        for (int c = 0; c < cycle_count; c++)
+        {
+            if (pick & (1 << c))
+                rows |= cycles[c];
+        }
+
+        if (2 * __builtin_popcount(rows) > max_size)
+            continue;
+
+        for (int r = 0; r < 9; r++)
+        {
+            if (rows & (1u << r))
+            {
+                boxes_a |= (uint16_t)(1u << region_of(topology, r * 9 + col_a[r]));
+                boxes_b |= (uint16_t)(1u << region_of(topology, r * 9 + col_b[r]));
+            }
+        }
+
+        if (boxes_a != boxes_b)
+            continue;
+
+        int extras_valid = 1;
+
+        for (int unit = TOPOLOGY_CLASSIC_UNITS; unit < topology->unit_count; unit++)
+        {
+            if (!(rows & extra_a[unit]) != !(rows & extra_b[unit]))
+                extras_valid = 0;
+        }
+
+        for (int c = 0; c < topology->cage_count; c++)
+        {
+            if (!(rows & cage_a[c]) != !(rows & cage_b[c]))
+                extras_valid = 0;
+        }
+
+        if (!extras_valid)
+            continue;
+
+        cellmask_t set = {{0, 0}};
+
+        for (int r = 0; r < 9; r++)
+        {
+            if (rows & (1u << r))
+            {
+                cellmask_set(&set, r * 9 + col_a[r]);
+                cellmask_set(&set, r * 9 + col_b[r]);
+            }
+        }
+
+        unavoidable_add(sets, &set);
+    }
+}
+
+/**
+ * Order sets by size for qsort()
+ *
+ * Parameters:
+ *   a - first cellmask_t
+ *   b - second cellmask_t
+ *
+ * Returns: negative, zero or positive like strcmp()
+ */
+static int compare_sizes(const void *a, const void *b)
+{
+    return cellmask_count(a) - cellmask_count(b);
+}
+
+/**
+ * Find the small unavoidable sets of a solution grid
+ *
+ * Parameters:
+ *   solution   - complete valid grid
+ *   max_digits - largest digit subset to search (2 or 3)
+ *   max_size   - largest set size to keep
+ *   sets       - receives the minimal sets, smallest first
+ *
+ * Returns: number of sets found
+ */
+int find_unavoidable_sets(int solution[9][9], int max_digits, int max_size,
+                          unavoidable_sets_t *sets)
+{
+    collect_state_t state = {solution, max_size, sets};
+    int puzzle[9][9];
+
+    sets->count = 0;
+
+    if (max_digits > UNAVOIDABLE_MAX_DIGITS)
+        max_digits = UNAVOIDABLE_MAX_DIGITS;
+
+    // Digit pairs have a closed form; no search needed
+    for (int a = 1; a <= 9; a++)
+    {
+        for (int b = a + 1; b <= 9; b++)
+        {
+            collect_digit_pair(solution, a, b, max_size, sets);
+        }
+    }
+
+    // Every digit triple, as a 9-bit mask
+    for (int digits = 0; digits < (1 << 9) && max_digits >= 3; digits++)
+    {
+        if (__builtin_popcount(digits) != 3)
+            continue;
+
+        // Empty the cells holding those digits; every other solution of the
+        // rest differs from the grid only inside them
+        for (int cell = 0; cell < 81; cell++)
+        {
+            int value = solution[cell / 9][cell % 9];
+
+            puzzle[cell / 9][cell % 9] = (digits >> (value - 1)) & 1 ? 0 : value;
+        }
+
+        enumerate_solutions(puzzle, UNAVOIDABLE_SOLUTION_LIMIT, collect_difference, &state, NULL);
+    }
+
+    qsort(sets->sets, (size_t)sets->count, sizeof(cellmask_t), compare_sizes);
+
+    return sets->count;
+}
+
+/**
+ * Find a set that a clue pattern misses entirely
+ *
+ * Parameters:
+ *   sets  - sets of the solution
+ *   clues - mask of clue cells
+ *
+ * Returns: index of the first missed set, or -1 if all are hit
+ */
+int unavoidable_missed(const unavoidable_sets_t *sets, const cellmask_t *clues)
+{
+    for (int i = 0; i < sets->count; i++)
+    {
+        if (!cellmask_intersects(&sets->sets[i], clues))
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Find the clues that are the only clue in some set
+ *
+ * Parameters:
+ *   sets  - sets of the solution
+ *   clues - mask of clue cells
+ *
+ * Returns: mask of clues proven necessary
+ */
+cellmask_t unavoidable_necessary(const unavoidable_sets_t *sets, const cellmask_t *clues)
+{
+    cellmask_t necessary = {{0, 0}};
+
+    for (int i = 0; i < sets->count; i++)
+    {
+        cellmask_t hit = {{sets->sets[i].bits[0] & clues->bits[0],
+                           sets->sets[i].bits[1] & clues->bits[1]}};
+
+        if (cellmask_count(&hit) == 1)
+        {
+            necessary.bits[0] |= hit.bits[0];
+            necessary.bits[1] |= hit.bits[1];
+        }
+    }
+
+    return necessary;
+}
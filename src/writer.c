@@ -0,0 +1,359 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "../include/sudoku.h"
+#include "../include/writer.h"
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * Initialize a writer for a file descriptor
+ *
+ * Parameters:
+ *   writer - writer to initialize
+ *   fd     - destination file descriptor
+ *   format - record format
+ *
+ * Returns: 1 on success, 0 on failure
+ */
+int writer_init(writer_t *writer, int fd, writer_format_t format)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = fd;
+    writer->format = format;
+
+    if (pthread_mutex_init(&writer->lock, NULL) != 0)
+        return 0;
+
+    if (pthread_cond_init(&writer->flushed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&writer->lock);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Release writer synchronization objects
+ *
+ * Parameters:
+ *   writer - writer to destroy
+ */
+void writer_destroy(writer_t *writer)
+{
+    pthread_cond_destroy(&writer->flushed);
+    pthread_mutex_destroy(&writer->lock);
+}
+
+/**
+ * Allocate an output buffer
+ *
+ * Parameters:
+ *   buffer   - buffer to initialize
+ *   capacity - bytes to allocate
+ *
+ * Returns: 1 on success, 0 on allocation failure
+ */
+int writer_buffer_init(writer_buffer_t *buffer, size_t capacity)
+{
+    buffer->data = malloc(capacity);
+    buffer->length = 0;
+    buffer->capacity = buffer->data ? capacity : 0;
+    buffer->seq = -1;
+    buffer->pending = 0;
+
+    return buffer->data != NULL;
+}
+
+/**
+ * Free an output buffer
+ *
+ * Parameters:
+ *   buffer - buffer to free
+ */
+void writer_buffer_free(writer_buffer_t *buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->capacity = 0;
+    buffer->length = 0;
+}
+
+/**
+ * Size in bytes of one record in the writer's format
+ *
+ * Parameters:
+ *   writer - writer to query
+ *
+ * Returns: record size in bytes
+ */
+size_t writer_record_size(const writer_t *writer)
+{
+    return writer->format == WRITER_BINARY ? BINARY_RECORD_SIZE : TEXT_RECORD_SIZE;
+}
+
+/**
+ * Append one grid to a buffer in the writer's record format
+ *
+ * Parameters:
+ *   writer - writer whose format is used
+ *   buffer - buffer to append to
+ *   grid   - 9x9 grid to format
+ */
+void writer_append_grid(const writer_t *writer, writer_buffer_t *buffer, int grid[9][9])
+{
+    const int *cells = &grid[0][0];
+    char *out = buffer->data + buffer->length;
+
+    if (writer->format == WRITER_BINARY)
+    {
+        // Two cells per byte; cell 80 fills the high nibble of the last byte
+        for (int i = 0; i < 80; i += 2)
+        {
+            *out++ = (char)((cells[i] << 4) | cells[i + 1]);
+        }
+        *out = (char)(cells[80] << 4);
+
+        buffer->length += BINARY_RECORD_SIZE;
+    }
+    else
+    {
+        for (int i = 0; i < 81; i++)
+        {
+            out[i] = (char)('0' + cells[i]);
+        }
+        out[81] = '\n';
+
+        buffer->length += TEXT_RECORD_SIZE;
+    }
+}
+
+/**
+ * Append a jigsaw region map to the record just appended
+ *
+ * Parameters:
+ *   writer  - writer whose format is used
+ *   buffer  - buffer holding the grid record
+ *   regions - region (0-8) of each cell
+ */
+void writer_append_regions(const writer_t *writer, writer_buffer_t *buffer, const uint8_t regions[81])
+{
+    if (writer->format == WRITER_BINARY)
+    {
+        int cells[9][9];
+
+        // Regions 0-8 are stored as 1-9 so the record reads like a full grid
+        for (int i = 0; i < 81; i++)
+            cells[i / 9][i % 9] = regions[i] + 1;
+
+        writer_append_grid(writer, buffer, cells);
+    }
+    else
+    {
+        char *out = buffer->data + buffer->length;
+
+        out[-1] = ' '; // The grid's newline becomes the field separator
+
+        for (int i = 0; i < 81; i++)
+        {
+            out[i] = (char)('1' + regions[i]);
+        }
+        out[81] = '\n';
+
+        buffer->length += TEXT_RECORD_SIZE;
+    }
+}
+
+/**
+ * Append a killer cage list to the record just appended
+ *
+ * Parameters:
+ *   writer - writer whose format is used
+ *   buffer - buffer holding the grid record
+ *   cages  - killer cages
+ */
+void writer_append_cages(const writer_t *writer, writer_buffer_t *buffer, const cage_layout_t *cages)
+{
+    char *out = buffer->data + buffer->length;
+
+    if (writer->format == WRITER_BINARY)
+    {
+        // Cage number of each cell, then the sum of each cage (0 = unused)
+        memset(out, 0, CAGE_BINARY_SIZE);
+
+        for (int c = 0; c < cages->count; c++)
+        {
+            for (int i = 0; i < cages->cages[c].size; i++)
+                out[cages->cages[c].cells[i]] = (char)c;
+
+            out[81 + c] = (char)cages->cages[c].sum;
+        }
+
+        buffer->length += CAGE_BINARY_SIZE;
+        return;
+    }
+
+    char *start = out;
+
+    out[-1] = ' '; // The grid's newline becomes the field separator
+
+    for (int c = 0; c < cages->count; c++)
+    {
+        const cage_t *cage = &cages->cages[c];
+
+        if (c > 0)
+            *out++ = ',';
+
+        if (cage->sum >= 10)
+            *out++ = (char)('0' + cage->sum / 10);
+        *out++ = (char)('0' + cage->sum % 10);
+        *out++ = '@';
+
+        for (int i = 0; i < cage->size; i++)
+        {
+            *out++ = (char)('1' + cage->cells[i] / 9);
+            *out++ = (char)('1' + cage->cells[i] % 9);
+        }
+    }
+
+    *out++ = '\n';
+    buffer->length += (size_t)(out - start);
+}
+
+/**
+ * Write an iovec array completely, retrying after partial writes
+ *
+ * Parameters:
+ *   fd    - destination file descriptor
+ *   iov   - vectors to write (modified as data is consumed)
+ *   count - number of vectors
+ *
+ * Returns: 1 on success, 0 on write error
+ */
+static int write_all(int fd, struct iovec *iov, int count)
+{
+    while (count > 0)
+    {
+        ssize_t written = writev(fd, iov, count);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue; // Interrupted - retry
+            return 0;
+        }
+
+        // Skip fully written vectors and trim the partially written one
+        while (count > 0 && (size_t)written >= iov->iov_len)
+        {
+            written -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+
+        if (count > 0)
+        {
+            iov->iov_base = (char *)iov->iov_base + written;
+            iov->iov_len -= (size_t)written;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Queue a filled buffer for output under a sequence number
+ * Writes every consecutive ready buffer with one writev() call
+ *
+ * Parameters:
+ *   writer - writer to submit to
+ *   buffer - filled buffer
+ *   seq    - sequence number of this buffer
+ *
+ * Returns: 1 on success, 0 if a write error occurred
+ */
+int writer_submit(writer_t *writer, writer_buffer_t *buffer, long seq)
+{
+    pthread_mutex_lock(&writer->lock);
+
+    // Bound the number of out-of-order buffers held by the writer
+    while (seq - writer->next_seq >= WRITER_WINDOW)
+    {
+        pthread_cond_wait(&writer->flushed, &writer->lock);
+    }
+
+    buffer->seq = seq;
+    buffer->pending = 1;
+    writer->slots[seq % WRITER_WINDOW] = buffer;
+
+    // Collect the run of buffers that is now ready, starting at next_seq
+    struct iovec iov[WRITER_WINDOW];
+    writer_buffer_t *ready[WRITER_WINDOW];
+    int count = 0;
+    long next = writer->next_seq;
+
+    while (count < WRITER_WINDOW)
+    {
+        writer_buffer_t *slot = writer->slots[next % WRITER_WINDOW];
+
+        if (slot == NULL || slot->seq != next)
+            break; // Gap: an earlier buffer is still being filled
+
+        iov[count].iov_base = slot->data;
+        iov[count].iov_len = slot->length;
+        ready[count] = slot;
+        writer->slots[next % WRITER_WINDOW] = NULL;
+        count++;
+        next++;
+    }
+
+    if (count > 0)
+    {
+        uint64_t bytes = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            bytes += iov[i].iov_len;
+        }
+
+        if (!write_all(writer->fd, iov, count))
+            writer->error = 1;
+
+        writer->bytes_written += bytes;
+        writer->next_seq = next;
+
+        for (int i = 0; i < count; i++)
+        {
+            ready[i]->pending = 0;
+        }
+
+        pthread_cond_broadcast(&writer->flushed);
+    }
+
+    int ok = !writer->error;
+    pthread_mutex_unlock(&writer->lock);
+
+    return ok;
+}
+
+/**
+ * Wait until a submitted buffer has been written, then empty it
+ *
+ * Parameters:
+ *   writer - writer the buffer was submitted to
+ *   buffer - buffer to wait for
+ */
+void writer_buffer_wait(writer_t *writer, writer_buffer_t *buffer)
+{
+    pthread_mutex_lock(&writer->lock);
+
+    while (buffer->pending)
+    {
+        pthread_cond_wait(&writer->flushed, &writer->lock);
+    }
+
+    pthread_mutex_unlock(&writer->lock);
+
+    buffer->length = 0;
+}